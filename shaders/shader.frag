@@ -2,6 +2,7 @@
 
 layout(constant_id = 0) const uint GRID_WIDTH = 64;
 layout(constant_id = 1) const uint GRID_HEIGHT = 64;
+layout(constant_id = 2) const uint INTERLEAVE_ROW_PAIRS = 0;
 
 layout(location = 0) in vec2 inUV;
 
@@ -9,18 +10,43 @@ layout(location = 0) out vec4 outColor;
 
 layout(binding = 0, r32ui) uniform readonly uimageBuffer StorageTexelBuffer;
 
+layout(push_constant) uniform PushConstants
+{
+    uint cellBufferIndex;
+}
+constants;
+
+const uint CELLS_PER_WORD = 32;
+const uint WORDS_PER_ROW = GRID_WIDTH / CELLS_PER_WORD;
+const uint PLANE_SIZE = WORDS_PER_ROW * (GRID_HEIGHT + 2 * INTERLEAVE_ROW_PAIRS);
+
+// NOTE(MM): Same layout as `getWordIdx()` in 'shader.comp', cell buffer `i` pairs its rows starting at row `-i`.
+uint getWordIdx(uint row, uint wordX)
+{
+    if (INTERLEAVE_ROW_PAIRS == 0)
+    {
+        return row * WORDS_PER_ROW + wordX;
+    }
+
+    uint pairRow = row + constants.cellBufferIndex;
+    return (pairRow / 2) * WORDS_PER_ROW * 2 + wordX * 2 + pairRow % 2;
+}
+
 void main()
 {
-    int indexX = int(inUV.x * GRID_WIDTH);
-    int indexY = int(inUV.y * GRID_HEIGHT);
-    int index = indexX + indexY * int(GRID_WIDTH);
+    uint indexX = uint(inUV.x * GRID_WIDTH);
+    uint indexY = uint(inUV.y * GRID_HEIGHT);
+
+    // NOTE(MM): Cells are bit-packed, see 'shader.comp'.
+    int wordIndex = int(getWordIdx(indexY, indexX / CELLS_PER_WORD));
+    uint bitIndex = indexX % CELLS_PER_WORD;
 
-    uvec4 cellStateVec = imageLoad(StorageTexelBuffer, index);
-    uint cellState = cellStateVec.x;
+    uint sandWord = imageLoad(StorageTexelBuffer, wordIndex).x;
+    uint wallWord = imageLoad(StorageTexelBuffer, wordIndex + int(PLANE_SIZE)).x;
 
-    uint redVal = cellState & 1;
+    uint redVal = (sandWord >> bitIndex) & 1;
     uint greenVal = redVal;
-    uint blueVal = cellState & 2;
+    uint blueVal = (wallWord >> bitIndex) & 1;
 
     outColor = vec4(redVal, greenVal, blueVal, 1.0);
 }
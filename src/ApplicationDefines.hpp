@@ -1,6 +1,7 @@
 #ifndef VULKANHOURGLASS_APPLICATIONDEFINES_HPP
 #define VULKANHOURGLASS_APPLICATIONDEFINES_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -10,14 +11,72 @@ namespace VkHourglass::ApplicationDefines
 constexpr int WINDOW_WIDTH = 1024;
 constexpr int WINDOW_HEIGHT = 1024;
 
+// NOTE(MM): Grid size, local group size, tile width, shared memory tiles, row pair interleaving, in-place stepping,
+// temporal steps, async compute, wrapping, stuck probability and the generator settings below are only the defaults of
+// the runtime configuration, see Configuration.hpp.
 constexpr uint32_t GRID_WIDTH = 1024;
 constexpr uint32_t GRID_HEIGHT = 1024;
 
 constexpr uint32_t COMPUTE_LOCAL_GROUP_SIZE_X = 32;
+// Width of the tiles (in words of 32 cells) the grid is divided into for active region tracking. A workgroup updates
+// one tile, i.e. tiles are 'COMPUTE_LOCAL_GROUP_SIZE_X / TILE_WIDTH_WORDS' block rows high. Only tiles near changes of
+// the last two generations are dispatched.
+constexpr uint32_t TILE_WIDTH_WORDS = 1;
+// Load the tiles into shared memory first (see 'shaders/shader.comp'), which saves reloading the neighbouring words of
+// each invocation. Pays off with tiles several words wide, whose rows are read coalesced.
+constexpr bool USE_SHARED_MEMORY_TILES = false;
+// Store the cell buffers with the two rows of each block row interleaved (see CellBufferLayout.hpp), so that a block
+// is loaded from a single cache line instead of two rows apart.
+constexpr bool INTERLEAVE_ROW_PAIRS = false;
+// Update a single cell buffer in place instead of alternating between two (see 'shaders/shader.comp'), which halves the
+// device memory of the grid. Not combinable with interleaved row pairs, whose layout depends on the buffer.
+constexpr bool STEP_IN_PLACE = false;
+// Generations computed per dispatch of the cell update (temporal blocking, see 'shaders/shader.comp'). Each workgroup
+// keeps its tile in shared memory for all of them, so the cell buffers are only read and written once. Has to be odd,
+// since the partition offset of a generation is the index of the buffer it reads.
+constexpr uint32_t TEMPORAL_STEPS = 1;
+// Compute the generations on a queue of their own in window mode, submitted by a thread of their own (see
+// AsyncComputeThread.hpp). Frames draw the latest completed generation instead of waiting for the next one, so
+// neither the simulation is limited by the frame rate nor the frame rate by the simulation. Needs timeline semaphores
+// and a second queue (of a compute family or the graphics family), otherwise the generations are computed per frame.
+constexpr bool USE_ASYNC_COMPUTE = false;
 constexpr uint32_t CELL_UPDATE_INTERVAL_MS = 0;
+// Number of cell update dispatches (in a single command buffer) per drawn frame, each computing `TEMPORAL_STEPS`
+// generations. Only the last one is drawn.
+constexpr uint32_t COMPUTE_STEPS_PER_FRAME = 1;
+// Number of cell update dispatches per submission of the async compute thread (see `USE_ASYNC_COMPUTE`). Only the last
+// generation of a submission is handed to the frames, i.e. the generation semaphore advances per submission. Set it to
+// 1 to signal every dispatch, at the cost of a display buffer copy each.
+constexpr uint32_t ASYNC_COMPUTE_STEPS_PER_SUBMIT = 4;
+// Number of generations computed per command buffer submission in headless mode.
+constexpr uint32_t HEADLESS_STEPS_PER_SUBMIT = 256;
+// Number of frames (or headless or async compute submissions) the CPU may record ahead of the GPU.
+constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 constexpr uint32_t ENABLE_HORIZONTAL_WRAPPING = false;
 constexpr float STUCK_PROBABILITY = 0.25f;
 
+// Worker threads of the CPU stepping path ('--headless <step count> --cpu'). 0 uses all hardware threads.
+constexpr size_t CPU_THREAD_COUNT = 0;
+// Generations the CPU stepping path computes per pass over the grid (temporal blocking, see SimdMargolusEngine.hpp).
+// Default of the runtime configuration, has to be odd.
+constexpr uint32_t CPU_TEMPORAL_STEPS = 1;
+// Size of the buffers a band of the grid is copied to for temporal blocking (two sand planes and the walls, including
+// the halo). Bands are as high as fits, but at least one tile row and at most a share of the grid per thread. Should
+// fit into the L2 cache of a core.
+constexpr size_t CPU_TEMPORAL_BAND_SIZE = 512 * 1024;
+// Give each thread of the CPU stepping path a fixed band of the grid, placed on the NUMA node of the CPU the thread is
+// pinned to (see SimdMargolusEngine.hpp). Default of the runtime configuration.
+constexpr bool CPU_NUMA_BANDS = false;
+
+// Reads back every computed generation and compares it to the CPU reference implementation (see MargolusEngine.hpp).
+// Stalls the GPU each frame (with async compute, each submission), so only meant for debugging. Default of
+// '--cross-check'.
+constexpr bool ENABLE_CPU_CROSS_CHECK = false;
+
+// Host visible buffers the generations are copied to while recording ('--record <file>', see FrameRecorder.hpp).
+// Frames are dropped if all of them are still waiting for the writer thread.
+constexpr size_t RECORDING_BUFFER_COUNT = 4;
+
 namespace GenerateHourglass
 {
 constexpr uint32_t HOURGLASS_WIDTH = 300;
@@ -47,12 +106,31 @@ constexpr uint32_t PARTICLE_COUNT = 1000000;
 namespace NonModifiable
 {
 constexpr std::string_view COMPUTE_SHADER_NAME = "comp.spv";
+constexpr std::string_view ACTIVE_TILES_SHADER_NAME = "activeTiles.spv";
 constexpr std::string_view VERTEX_SHADER_NAME = "vert.spv";
 constexpr std::string_view FRAGMENT_SHADER_NAME = "frag.spv";
 
-constexpr uint32_t GRID_SIZE = GRID_WIDTH * GRID_HEIGHT;
-constexpr uint32_t ELEMENTS_PER_CELL = 4;
-constexpr uint32_t X_DISPATCH_COUNT = GRID_SIZE / ELEMENTS_PER_CELL / COMPUTE_LOCAL_GROUP_SIZE_X;
+// NOTE(MM): Stored next to the shaders, see PipelineCache.hpp.
+constexpr std::string_view PIPELINE_CACHE_FILE_NAME = "pipelineCache.bin";
+
+// NOTE(MM): Size of the device memory blocks buffers are sub-allocated from (see DeviceMemoryArena.hpp). Larger
+// buffers get a block of their own.
+constexpr uint64_t DEVICE_MEMORY_BLOCK_SIZE = 32 * 1024 * 1024;
+
+// NOTE(MM): Cells are bit-packed into a sand and a wall plane (see PackedGrid.hpp). Each compute shader invocation
+// updates one word of both rows of a block row. Buffer sizes derived from the grid size are provided by
+// `Configuration`.
+constexpr uint32_t CELLS_PER_WORD = 32;
+
+// NOTE(MM): The active tiles buffer holds the indirect dispatch arguments (padded to 4 words), the list of active
+// tiles and the generation each tile last changed in (see 'shaders/tiles.comp').
+constexpr uint32_t ACTIVE_TILES_HEADER_WORD_COUNT = 4;
+
+// NOTE(MM): Upper limit of the temporal steps, which keeps the halo of the temporal tiles (see 'shaders/shader.comp')
+// small.
+constexpr uint32_t MAX_TEMPORAL_STEPS = 7;
+// NOTE(MM): Same for the CPU, limited by its tile size (see SimdMargolusEngine.cpp).
+constexpr uint32_t MAX_CPU_TEMPORAL_STEPS = 31;
 } // namespace NonModifiable
 
 } // namespace VkHourglass::ApplicationDefines
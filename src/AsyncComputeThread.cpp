@@ -0,0 +1,235 @@
+#include "AsyncComputeThread.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "ApplicationDefines.hpp"
+#include "CheckpointWriter.hpp"
+#include "ComputeUpdateTimer.hpp"
+#include "CrossCheck.hpp"
+#include "FrameRecording.hpp"
+#include "GpuCommands.hpp"
+#include "Macros.hpp"
+
+namespace VkHourglass
+{
+
+AsyncComputeThread::AsyncComputeThread(const VulkanContext& context,
+                                       uint32_t seed,
+                                       size_t& currentGridBuffer,
+                                       uint32_t& generation,
+                                       CheckpointWriter& checkpointWriter,
+                                       FrameRecording& recording,
+                                       MargolusEngine* crossCheckEngine,
+                                       std::atomic_bool& exitApplication)
+    : _context(context)
+    , _seed(seed)
+    , _currentGridBuffer(currentGridBuffer)
+    , _generation(generation)
+    , _checkpointWriter(checkpointWriter)
+    , _recording(recording)
+    , _crossCheckEngine(crossCheckEngine)
+    , _exitApplication(exitApplication)
+    , _mutex()
+    , _lastFrames(VulkanContext::DISPLAY_BUFFER_COUNT, 0)
+    , _cellBufferIndices(VulkanContext::DISPLAY_BUFFER_COUNT, 0)
+    , _frameNumber(0)
+    , _future()
+{
+    _future = std::async(std::launch::async, [this]() {
+        const bool success = run();
+        if (!success)
+        {
+            _exitApplication.store(true);
+        }
+        return success;
+    });
+}
+
+std::optional<AsyncComputeThread::Publication> AsyncComputeThread::acquirePublication(void)
+{
+    // NOTE(MM): The counter has to be read while holding the mutex, otherwise the compute thread could overwrite the
+    // display buffer before this frame is registered as drawing it.
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    uint64_t submission = 0;
+    VK_RETURN_ON_ERROR_V(vkGetSemaphoreCounterValue(
+                             _context.deviceWrapper.device, _context.asyncCompute.generationSemaphore, &submission),
+                         std::nullopt);
+
+    const size_t displayBuffer = submission % VulkanContext::DISPLAY_BUFFER_COUNT;
+    ++_frameNumber;
+    _lastFrames[displayBuffer] = _frameNumber;
+    return Publication{displayBuffer, _cellBufferIndices[displayBuffer], submission, _frameNumber};
+}
+
+void AsyncComputeThread::submitDrawCommands(const VulkanContext::Frame& frame, const Publication& publication) const
+{
+    const VulkanContext::AsyncCompute& asyncCompute = _context.asyncCompute;
+
+    // NOTE(MM): The values of binary semaphores are ignored.
+    const std::array<VkSemaphore, 2> waitSemaphores = {frame.imageAvailableSemaphore,
+                                                       asyncCompute.generationSemaphore};
+    const std::array<uint64_t, 2> waitValues = {0, publication.submission};
+    const std::array<VkPipelineStageFlags, 2> waitStages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                                            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT};
+    const std::array<VkSemaphore, 2> signalSemaphores = {frame.renderingFinishedSemaphore,
+                                                         asyncCompute.frameSemaphore};
+    const std::array<uint64_t, 2> signalValues = {0, publication.frameNumber};
+
+    VkTimelineSemaphoreSubmitInfo timelineSemaphoreSubmitInfo{};
+    timelineSemaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineSemaphoreSubmitInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+    timelineSemaphoreSubmitInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineSemaphoreSubmitInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+    timelineSemaphoreSubmitInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineSemaphoreSubmitInfo;
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &frame.commandBuffer;
+    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+    if (vkQueueSubmit(_context.deviceWrapper.queue, 1, &submitInfo, frame.inFlightFence) != VK_SUCCESS)
+    {
+        fprintf(stderr, "Failed to submit draw command!\n");
+    }
+}
+
+bool AsyncComputeThread::join(void)
+{
+    return _future.get();
+}
+
+bool AsyncComputeThread::run(void)
+{
+    const VulkanContext::AsyncCompute& asyncCompute = _context.asyncCompute;
+    const size_t submissionsInFlight = asyncCompute.commandBuffers.size();
+    const size_t stepCount = ApplicationDefines::ASYNC_COMPUTE_STEPS_PER_SUBMIT * _context.configuration.temporalSteps;
+    ComputeUpdateTimer computeUpdateTimer(ApplicationDefines::CELL_UPDATE_INTERVAL_MS);
+    uint64_t submission = 0;
+
+    while (!_exitApplication.load())
+    {
+        if (!computeUpdateTimer.isUpdateNeeded())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        ++submission;
+        const size_t currentSubmit = (submission - 1) % submissionsInFlight;
+
+        // NOTE(MM): Wait for the submission which used these resources the last time. Like the fence of a frame, this
+        // makes its checkpoint and recording copies visible to the host.
+        if (submission > submissionsInFlight && !waitForSubmission(submission - submissionsInFlight))
+        {
+            return false;
+        }
+        _checkpointWriter.writePending(_context, currentSubmit);
+        _recording.submitPending(currentSubmit);
+
+        const VkCommandBuffer commandBuffer = asyncCompute.commandBuffers[currentSubmit];
+        vkResetCommandBuffer(commandBuffer, 0);
+        GpuCommands::beginCommandBuffer(commandBuffer);
+
+        // NOTE(MM): Submissions only follow each other on the compute queue, so the final barrier of the previous one
+        // orders this one after it.
+        _currentGridBuffer = GpuCommands::recordComputeCommands(_context,
+                                                                commandBuffer,
+                                                                _currentGridBuffer,
+                                                                _generation,
+                                                                _seed,
+                                                                stepCount,
+                                                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        _checkpointWriter.recordCopy(_context, commandBuffer, currentSubmit, _currentGridBuffer, _generation, _seed);
+        _recording.recordCopy(_context, commandBuffer, currentSubmit, _currentGridBuffer, _generation);
+
+        // NOTE(MM): The copy is made visible to the frames by signaling the generation semaphore.
+        const size_t displayBuffer = submission % VulkanContext::DISPLAY_BUFFER_COUNT;
+        GpuCommands::recordCellBufferCopy(
+            _context, commandBuffer, _currentGridBuffer, asyncCompute.displayBuffers[displayBuffer], 0, 0);
+        VK_RETURN_ON_ERROR_V(vkEndCommandBuffer(commandBuffer), false);
+
+        // NOTE(MM): No frame can acquire this display buffer before the submission is signaled.
+        uint64_t lastFrame = 0;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            lastFrame = _lastFrames[displayBuffer];
+            _cellBufferIndices[displayBuffer] = _currentGridBuffer;
+        }
+
+        if (!submitComputeCommands(commandBuffer, submission, lastFrame))
+        {
+            return false;
+        }
+        computeUpdateTimer.notifyUpdateScheduled();
+
+        // NOTE(MM): Stalls this thread (not the frames, which keep drawing the previous submissions) until the
+        // submission is done.
+        if (_crossCheckEngine
+            && (!waitForSubmission(submission)
+                || !CrossCheck::compareWithCpu(_context, *_crossCheckEngine, _currentGridBuffer, stepCount)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool AsyncComputeThread::waitForSubmission(uint64_t submission) const
+{
+    VkSemaphoreWaitInfo semaphoreWaitInfo{};
+    semaphoreWaitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    semaphoreWaitInfo.semaphoreCount = 1;
+    semaphoreWaitInfo.pSemaphores = &_context.asyncCompute.generationSemaphore;
+    semaphoreWaitInfo.pValues = &submission;
+    VK_RETURN_ON_ERROR_V(vkWaitSemaphores(_context.deviceWrapper.device, &semaphoreWaitInfo, UINT64_MAX), false);
+
+    return true;
+}
+
+// Submits `commandBuffer` to the compute queue, which signals the generation semaphore with `submission`. Its copy to
+// the display buffer waits for the frame semaphore to reach `lastFrame`.
+bool AsyncComputeThread::submitComputeCommands(VkCommandBuffer commandBuffer,
+                                               uint64_t submission,
+                                               uint64_t lastFrame) const
+{
+    VkTimelineSemaphoreSubmitInfo timelineSemaphoreSubmitInfo{};
+    timelineSemaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineSemaphoreSubmitInfo.waitSemaphoreValueCount = 1;
+    timelineSemaphoreSubmitInfo.pWaitSemaphoreValues = &lastFrame;
+    timelineSemaphoreSubmitInfo.signalSemaphoreValueCount = 1;
+    timelineSemaphoreSubmitInfo.pSignalSemaphoreValues = &submission;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineSemaphoreSubmitInfo;
+    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.pWaitSemaphores = &_context.asyncCompute.frameSemaphore;
+
+    const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    submitInfo.pWaitDstStageMask = &waitStage;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &_context.asyncCompute.generationSemaphore;
+
+    if (vkQueueSubmit(_context.deviceWrapper.computeQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+    {
+        fprintf(stderr, "Failed to submit async compute command!\n");
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace VkHourglass
@@ -0,0 +1,109 @@
+#ifndef VULKANHOURGLASS_ASYNCCOMPUTETHREAD_HPP
+#define VULKANHOURGLASS_ASYNCCOMPUTETHREAD_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+#include "VulkanContext.hpp"
+
+namespace VkHourglass
+{
+
+class CheckpointWriter;
+class FrameRecording;
+class MargolusEngine;
+
+// Computes the generations of window mode on `DeviceWrapper::computeQueue` until `exitApplication` is set, submitted by
+// a thread of its own (see `ApplicationDefines::USE_ASYNC_COMPUTE` and `VulkanContext::AsyncCompute`). Up to
+// `MAX_FRAMES_IN_FLIGHT` submissions are pending, their command buffers, checkpoint and recording copies are indexed
+// like frames.
+//
+// Each submission computes `ASYNC_COMPUTE_STEPS_PER_SUBMIT` dispatches, copies its last generation to display buffer
+// `submission % DISPLAY_BUFFER_COUNT` and signals the generation semaphore with its submission number. Frames draw the
+// display buffer of the latest signaled submission (see `acquirePublication()`). Before overwriting a display buffer,
+// the copy waits for the frame semaphore to reach the last frame which drew it. The mutex makes picking a display
+// buffer and reading its last frame mutually exclusive.
+//
+// NOTE(MM): The timeline advances per submission, not per generation: Only the generations signaled are copied to a
+// display buffer, a value per generation would need a copy per generation as well. With
+// `ASYNC_COMPUTE_STEPS_PER_SUBMIT` set to 1, every dispatch (i.e. every `Configuration::temporalSteps` generations) is
+// signaled.
+//
+// NOTE(MM): Since at most `MAX_FRAMES_IN_FLIGHT` compute submissions are pending, the latest signaled one is never
+// more than `DISPLAY_BUFFER_COUNT - 1` behind the latest one, i.e. its display buffer isn't being overwritten.
+class AsyncComputeThread
+{
+public:
+    struct Publication
+    {
+        size_t displayBuffer;
+        // Cell buffer the display buffer was copied from, whose layout the fragment shader has to use.
+        size_t cellBufferIndex;
+        uint64_t submission;
+        // Frame number (see `VulkanContext::AsyncCompute::frameSemaphore`) of the frame drawing the display buffer.
+        uint64_t frameNumber;
+    };
+
+    // Starts the thread. Until `join()` returns, `currentGridBuffer`, `generation`, `checkpointWriter`, `recording` and
+    // `crossCheckEngine` belong to it. With `crossCheckEngine`, each submission is waited for and compared to the CPU
+    // reference implementation. Sets `exitApplication` if computing fails.
+    AsyncComputeThread(const VulkanContext& context,
+                       uint32_t seed,
+                       size_t& currentGridBuffer,
+                       uint32_t& generation,
+                       CheckpointWriter& checkpointWriter,
+                       FrameRecording& recording,
+                       MargolusEngine* crossCheckEngine,
+                       std::atomic_bool& exitApplication);
+
+    // NOTE(MM): The thread refers to the members.
+    AsyncComputeThread(const AsyncComputeThread&) = delete;
+    AsyncComputeThread& operator=(const AsyncComputeThread&) = delete;
+    AsyncComputeThread(AsyncComputeThread&&) noexcept = delete;
+    AsyncComputeThread& operator=(AsyncComputeThread&&) noexcept = delete;
+
+    // Picks the display buffer of the latest completed submission for the next frame. Once acquired, the frame has to
+    // be submitted with `submitDrawCommands()`, since the thread may wait for its frame number.
+    std::optional<Publication> acquirePublication(void);
+    // Like submitting `frame` in window mode, but additionally waits for the submission of `publication` before
+    // drawing its display buffer and signals the frame semaphore.
+    void submitDrawCommands(const VulkanContext::Frame& frame, const Publication& publication) const;
+
+    // Waits for the thread to stop, expects `exitApplication` to be set. Returns whether computing succeeded.
+    bool join(void);
+
+private:
+    bool run(void);
+    bool waitForSubmission(uint64_t submission) const;
+    bool submitComputeCommands(VkCommandBuffer commandBuffer, uint64_t submission, uint64_t lastFrame) const;
+
+    const VulkanContext& _context;
+    const uint32_t _seed;
+    size_t& _currentGridBuffer;
+    uint32_t& _generation;
+    CheckpointWriter& _checkpointWriter;
+    FrameRecording& _recording;
+    MargolusEngine* const _crossCheckEngine;
+    std::atomic_bool& _exitApplication;
+
+    std::mutex _mutex;
+    // Frame number of the last frame drawing each display buffer.
+    std::vector<uint64_t> _lastFrames;
+    // Cell buffer each display buffer was copied from.
+    std::vector<size_t> _cellBufferIndices;
+    // Number of the last acquired frame, only used by the acquiring thread.
+    uint64_t _frameNumber;
+
+    std::future<bool> _future;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_ASYNCCOMPUTETHREAD_HPP
@@ -0,0 +1,176 @@
+#include "BenchmarkReport.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+namespace VkHourglass
+{
+
+// Nearest-rank percentile of sorted values.
+static double getPercentile(const std::vector<double>& sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+    {
+        return 0.0;
+    }
+
+    const auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sortedValues.size())));
+    return sortedValues[std::clamp<size_t>(rank, 1, sortedValues.size()) - 1];
+}
+
+BenchmarkReport::BenchmarkReport(Configuration configuration)
+    : _configuration(std::move(configuration))
+    , _totalStepCount(0)
+    , _totalRuntime(0)
+    , _gridMemoryTraffic(0)
+{
+}
+
+void BenchmarkReport::addSample(uint64_t stepCount, std::chrono::steady_clock::duration duration)
+{
+    _samples.push_back({stepCount, duration});
+}
+
+void BenchmarkReport::setTotal(uint64_t stepCount, std::chrono::steady_clock::duration runtime)
+{
+    _totalStepCount = stepCount;
+    _totalRuntime = runtime;
+}
+
+void BenchmarkReport::setGridMemoryTraffic(uint64_t byteCount)
+{
+    _gridMemoryTraffic = byteCount;
+}
+
+void BenchmarkReport::print(Format format) const
+{
+    const Results results = computeResults();
+    const Configuration& config = _configuration;
+    const auto stepCount = static_cast<unsigned long long>(_totalStepCount);
+
+    switch (format)
+    {
+    case Format::Text:
+        printf("Computed generations: %llu\n", stepCount);
+        printf("Overall runtime: %.3fs\n", results.seconds);
+        printf("Throughput: %.1f steps/s / %.3e block updates/s / %.3f ns/block\n",
+               results.stepsPerSecond,
+               results.blockUpdatesPerSecond,
+               results.nsPerBlock);
+        printf("ns/block percentiles: p50 %.3f / p90 %.3f / p99 %.3f / max %.3f\n",
+               results.nsPerBlockP50,
+               results.nsPerBlockP90,
+               results.nsPerBlockP99,
+               results.nsPerBlockMax);
+        if (_gridMemoryTraffic > 0)
+        {
+            printf("Grid memory traffic: %.3f bytes/block (%u generations per pass)\n",
+                   results.gridBytesPerBlock,
+                   config.temporalSteps);
+        }
+        break;
+    case Format::Json:
+        // NOTE(MM): Names are printed verbatim, they are not expected to contain characters in need of escaping.
+        printf("{\"engine\": \"%s\", \"backend\": \"%s\", \"generator\": \"%s\", \"grid_width\": %u, "
+               "\"grid_height\": %u, \"local_group_size\": %u, \"tile_width_words\": %u, \"threads\": %zu, "
+               "\"temporal_steps\": %u, \"steps\": %llu, \"samples\": %zu, \"runtime_s\": %.6f, "
+               "\"steps_per_s\": %.3f, \"block_updates_per_s\": %.6e, \"ns_per_block\": %.6f, "
+               "\"ns_per_block_p50\": %.6f, \"ns_per_block_p90\": %.6f, \"ns_per_block_p99\": %.6f, "
+               "\"ns_per_block_max\": %.6f, \"grid_bytes_per_block\": %.6f}\n",
+               config.engine.c_str(),
+               config.backend.c_str(),
+               config.generator.c_str(),
+               config.gridWidth,
+               config.gridHeight,
+               config.localGroupSize,
+               config.tileWidthWords,
+               config.threadCount,
+               config.temporalSteps,
+               stepCount,
+               _samples.size(),
+               results.seconds,
+               results.stepsPerSecond,
+               results.blockUpdatesPerSecond,
+               results.nsPerBlock,
+               results.nsPerBlockP50,
+               results.nsPerBlockP90,
+               results.nsPerBlockP99,
+               results.nsPerBlockMax,
+               results.gridBytesPerBlock);
+        break;
+    case Format::Csv:
+        printf("%s,\"%s\",%s,%u,%u,%u,%u,%zu,%u,%llu,%zu,%.6f,%.3f,%.6e,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+               config.engine.c_str(),
+               config.backend.c_str(),
+               config.generator.c_str(),
+               config.gridWidth,
+               config.gridHeight,
+               config.localGroupSize,
+               config.tileWidthWords,
+               config.threadCount,
+               config.temporalSteps,
+               stepCount,
+               _samples.size(),
+               results.seconds,
+               results.stepsPerSecond,
+               results.blockUpdatesPerSecond,
+               results.nsPerBlock,
+               results.nsPerBlockP50,
+               results.nsPerBlockP90,
+               results.nsPerBlockP99,
+               results.nsPerBlockMax,
+               results.gridBytesPerBlock);
+        break;
+    }
+}
+
+void BenchmarkReport::printCsvHeader(void)
+{
+    printf("engine,backend,generator,grid_width,grid_height,local_group_size,tile_width_words,threads,temporal_steps,"
+           "steps,samples,runtime_s,steps_per_s,block_updates_per_s,ns_per_block,ns_per_block_p50,ns_per_block_p90,"
+           "ns_per_block_p99,ns_per_block_max,grid_bytes_per_block\n");
+}
+
+BenchmarkReport::Results BenchmarkReport::computeResults(void) const
+{
+    // NOTE(MM): A Margolus block consists of 2x2 cells, every block is updated once per generation.
+    const double blockCount =
+        static_cast<double>(_configuration.gridWidth) * static_cast<double>(_configuration.gridHeight) / 4.0;
+
+    Results results{};
+    results.seconds = std::chrono::duration<double>(_totalRuntime).count();
+    if (results.seconds > 0.0)
+    {
+        results.stepsPerSecond = static_cast<double>(_totalStepCount) / results.seconds;
+        results.blockUpdatesPerSecond = results.stepsPerSecond * blockCount;
+    }
+    if (_totalStepCount > 0)
+    {
+        results.nsPerBlock = results.seconds * 1e9 / (static_cast<double>(_totalStepCount) * blockCount);
+        results.gridBytesPerBlock =
+            static_cast<double>(_gridMemoryTraffic) / (static_cast<double>(_totalStepCount) * blockCount);
+    }
+
+    std::vector<double> nsPerBlock;
+    nsPerBlock.reserve(_samples.size());
+    for (const Sample& sample : _samples)
+    {
+        if (sample.stepCount > 0)
+        {
+            const double nanoseconds = std::chrono::duration<double, std::nano>(sample.duration).count();
+            nsPerBlock.push_back(nanoseconds / (static_cast<double>(sample.stepCount) * blockCount));
+        }
+    }
+    std::sort(nsPerBlock.begin(), nsPerBlock.end());
+
+    results.nsPerBlockP50 = getPercentile(nsPerBlock, 50.0);
+    results.nsPerBlockP90 = getPercentile(nsPerBlock, 90.0);
+    results.nsPerBlockP99 = getPercentile(nsPerBlock, 99.0);
+    results.nsPerBlockMax = nsPerBlock.empty() ? 0.0 : nsPerBlock.back();
+
+    return results;
+}
+
+} // namespace VkHourglass
@@ -0,0 +1,87 @@
+#ifndef VULKANHOURGLASS_BENCHMARKREPORT_HPP
+#define VULKANHOURGLASS_BENCHMARKREPORT_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace VkHourglass
+{
+
+// Collects the timings of a headless run and prints them either human readable or machine readable (one JSON object
+// per line or one CSV row), so runs of different configurations can be compared (see 'make bench').
+class BenchmarkReport
+{
+public:
+    enum class Format
+    {
+        Text,
+        Json,
+        Csv,
+    };
+
+    struct Configuration
+    {
+        // "gpu", "gpu-shared" (shared memory tiles), "gpu-temporal" (temporal blocking), "cpu" or "cpu-temporal",
+        // the CPU ones suffixed with "-numa" for NUMA bands
+        std::string engine;
+        // Vulkan device or CPU kernel name
+        std::string backend;
+        std::string generator;
+        uint32_t gridWidth;
+        uint32_t gridHeight;
+        uint32_t localGroupSize;
+        uint32_t tileWidthWords;
+        size_t threadCount;
+        // Generations per pass over the grid (see `Configuration::temporalSteps` and `cpuTemporalSteps`).
+        uint32_t temporalSteps;
+    };
+
+    explicit BenchmarkReport(Configuration configuration);
+
+    // Timing of `stepCount` consecutive generations. Percentiles are computed over the samples, so each sample should
+    // cover a similar number of generations.
+    void addSample(uint64_t stepCount, std::chrono::steady_clock::duration duration);
+    // Overall number of generations and runtime, including any setup/teardown of the run (e.g. waiting for the queue).
+    void setTotal(uint64_t stepCount, std::chrono::steady_clock::duration runtime);
+    // Bytes of the cell buffers read and written by all generations, if the engine counts them (see
+    // `SimdMargolusEngine::getGridMemoryTraffic()`). Reported per block update to compare the bandwidth needed.
+    void setGridMemoryTraffic(uint64_t byteCount);
+
+    void print(Format format) const;
+    static void printCsvHeader(void);
+
+private:
+    struct Sample
+    {
+        uint64_t stepCount;
+        std::chrono::steady_clock::duration duration;
+    };
+
+    struct Results
+    {
+        double seconds;
+        double stepsPerSecond;
+        double blockUpdatesPerSecond;
+        double nsPerBlock;
+        double nsPerBlockP50;
+        double nsPerBlockP90;
+        double nsPerBlockP99;
+        double nsPerBlockMax;
+        // 0 if not counted
+        double gridBytesPerBlock;
+    };
+
+    Results computeResults(void) const;
+
+    const Configuration _configuration;
+    std::vector<Sample> _samples;
+    uint64_t _totalStepCount;
+    std::chrono::steady_clock::duration _totalRuntime;
+    uint64_t _gridMemoryTraffic;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_BENCHMARKREPORT_HPP
@@ -0,0 +1,105 @@
+#include "CellBufferLayout.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Configuration.hpp"
+#include "PackedGrid.hpp"
+
+namespace VkHourglass
+{
+
+CellBufferLayout::CellBufferLayout(uint32_t gridWidth, uint32_t gridHeight, bool interleaveRowPairs)
+    : _gridWidth(gridWidth)
+    , _gridHeight(gridHeight)
+    , _wordsPerRow(gridWidth / PackedGrid::CELLS_PER_WORD)
+    , _interleaveRowPairs(interleaveRowPairs)
+{
+}
+
+CellBufferLayout::CellBufferLayout(const Configuration& configuration)
+    : CellBufferLayout(configuration.gridWidth, configuration.gridHeight, configuration.interleaveRowPairs)
+{
+}
+
+size_t CellBufferLayout::getGridWordCount(void) const
+{
+    return static_cast<size_t>(_wordsPerRow) * _gridHeight * 2;
+}
+
+size_t CellBufferLayout::getPlaneWordCount(void) const
+{
+    const uint32_t paddingRows = _interleaveRowPairs ? 2 : 0;
+    return static_cast<size_t>(_wordsPerRow) * (_gridHeight + paddingRows);
+}
+
+size_t CellBufferLayout::getWordCount(void) const
+{
+    return getPlaneWordCount() * 2;
+}
+
+size_t CellBufferLayout::getWordIndex(size_t bufferIndex, uint32_t row, uint32_t wordX) const
+{
+    assert(bufferIndex < 2 && "CellBufferLayout: Buffer index out of range!");
+
+    if (!_interleaveRowPairs)
+    {
+        return static_cast<size_t>(row) * _wordsPerRow + wordX;
+    }
+
+    const size_t pairRow = row + bufferIndex;
+    return pairRow / 2 * _wordsPerRow * 2 + static_cast<size_t>(wordX) * 2 + pairRow % 2;
+}
+
+void CellBufferLayout::pack(size_t bufferIndex, const uint32_t* gridWords, uint32_t* bufferWords) const
+{
+    if (!_interleaveRowPairs)
+    {
+        std::copy_n(gridWords, getGridWordCount(), bufferWords);
+        return;
+    }
+
+    const size_t gridPlaneWordCount = getGridWordCount() / 2;
+    const size_t planeWordCount = getPlaneWordCount();
+    std::fill_n(bufferWords, getWordCount(), 0);
+
+    for (size_t plane = 0; plane < 2; ++plane)
+    {
+        const uint32_t* gridPlane = gridWords + plane * gridPlaneWordCount;
+        uint32_t* bufferPlane = bufferWords + plane * planeWordCount;
+        for (uint32_t row = 0; row < _gridHeight; ++row)
+        {
+            for (uint32_t wordX = 0; wordX < _wordsPerRow; ++wordX)
+            {
+                bufferPlane[getWordIndex(bufferIndex, row, wordX)] = gridPlane[row * _wordsPerRow + wordX];
+            }
+        }
+    }
+}
+
+void CellBufferLayout::unpack(size_t bufferIndex, const uint32_t* bufferWords, uint32_t* gridWords) const
+{
+    if (!_interleaveRowPairs)
+    {
+        std::copy_n(bufferWords, getGridWordCount(), gridWords);
+        return;
+    }
+
+    const size_t gridPlaneWordCount = getGridWordCount() / 2;
+    const size_t planeWordCount = getPlaneWordCount();
+
+    for (size_t plane = 0; plane < 2; ++plane)
+    {
+        const uint32_t* bufferPlane = bufferWords + plane * planeWordCount;
+        uint32_t* gridPlane = gridWords + plane * gridPlaneWordCount;
+        for (uint32_t row = 0; row < _gridHeight; ++row)
+        {
+            for (uint32_t wordX = 0; wordX < _wordsPerRow; ++wordX)
+            {
+                gridPlane[row * _wordsPerRow + wordX] = bufferPlane[getWordIndex(bufferIndex, row, wordX)];
+            }
+        }
+    }
+}
+
+} // namespace VkHourglass
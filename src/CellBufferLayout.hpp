@@ -0,0 +1,54 @@
+#ifndef VULKANHOURGLASS_CELLBUFFERLAYOUT_HPP
+#define VULKANHOURGLASS_CELLBUFFERLAYOUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace VkHourglass
+{
+
+struct Configuration;
+
+// Layout of the GPU cell buffers, which is either the layout of `PackedGrid::getData()` or one with interleaved row
+// pairs (`Configuration::interleaveRowPairs`):
+//
+// Cell buffer `b` is always read with partition offset `b` (generations alternate between both offsets and buffers),
+// so its Margolus blocks span rows (2k - b, 2k + 1 - b). Interleaving the words of these row pairs makes both rows of a
+// block adjacent in memory, i.e. a block row is a single contiguous range. Within a plane, word `wordX` of `row` is at
+//
+//     ((row + b) / 2) * 2 * wordsPerRow + wordX * 2 + (row + b) % 2
+//
+// The pairs of buffer 1 start at row -1, hence each plane has room for one pair more, whose unused rows stay zero.
+// See `getWordIdx()` in 'shaders/shader.comp'.
+class CellBufferLayout
+{
+public:
+    CellBufferLayout(uint32_t gridWidth, uint32_t gridHeight, bool interleaveRowPairs);
+    explicit CellBufferLayout(const Configuration& configuration);
+
+    uint32_t getGridWidth(void) const { return _gridWidth; }
+    uint32_t getGridHeight(void) const { return _gridHeight; }
+    bool isInterleaved(void) const { return _interleaveRowPairs; }
+
+    // Word count of the grid in `PackedGrid` layout.
+    size_t getGridWordCount(void) const;
+    size_t getPlaneWordCount(void) const;
+    // Word count of a cell buffer (sand plane followed by the wall plane).
+    size_t getWordCount(void) const;
+    size_t getWordIndex(size_t bufferIndex, uint32_t row, uint32_t wordX) const;
+
+    // Convert between the `PackedGrid` layout (`getGridWordCount()` words) and the layout of cell buffer `bufferIndex`
+    // (`getWordCount()` words). The padding words of interleaved buffers are written as zero.
+    void pack(size_t bufferIndex, const uint32_t* gridWords, uint32_t* bufferWords) const;
+    void unpack(size_t bufferIndex, const uint32_t* bufferWords, uint32_t* gridWords) const;
+
+private:
+    uint32_t _gridWidth;
+    uint32_t _gridHeight;
+    uint32_t _wordsPerRow;
+    bool _interleaveRowPairs;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_CELLBUFFERLAYOUT_HPP
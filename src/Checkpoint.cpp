@@ -0,0 +1,174 @@
+#include "Checkpoint.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "PackedGrid.hpp"
+
+namespace VkHourglass::Checkpoint
+{
+
+// NOTE(MM): Bump the version whenever the file layout changes. Like the pipeline cache, the header is written in host
+// layout.
+static constexpr uint32_t FILE_MAGIC = 0x50434748; // "HGCP"
+static constexpr uint32_t FILE_VERSION = 2;
+
+// NOTE(MM): The cells start at a multiple of the (usual) page size, so that they can also be mapped on their own.
+static constexpr uint64_t CELLS_ALIGNMENT = 4096;
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t gridWidth;
+    uint32_t gridHeight;
+    uint32_t generation;
+    uint32_t currentGridBuffer;
+    uint32_t seed;
+    uint32_t reserved;
+    uint64_t cellsOffset;
+    uint64_t cellWordCount;
+};
+
+static uint64_t getExpectedCellWordCount(uint32_t gridWidth, uint32_t gridHeight)
+{
+    return static_cast<uint64_t>(gridWidth / PackedGrid::CELLS_PER_WORD) * gridHeight * 2;
+}
+
+bool writeFile(const std::filesystem::path& filePath, const State& state, const uint32_t* cells, size_t cellWordCount)
+{
+    FileHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.gridWidth = state.gridWidth;
+    header.gridHeight = state.gridHeight;
+    header.generation = state.generation;
+    header.currentGridBuffer = state.currentGridBuffer;
+    header.seed = state.seed;
+    header.cellsOffset = (sizeof(header) + CELLS_ALIGNMENT - 1) / CELLS_ALIGNMENT * CELLS_ALIGNMENT;
+    header.cellWordCount = cellWordCount;
+
+    std::filesystem::path temporaryPath(filePath);
+    temporaryPath += ".tmp";
+
+    {
+        const std::string padding(header.cellsOffset - sizeof(header), '\0');
+
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        file.write(reinterpret_cast<const char*>(cells),
+                   static_cast<std::streamsize>(cellWordCount * sizeof(cells[0])));
+        file.close();
+
+        if (!file)
+        {
+            fprintf(stderr, "Failed to write checkpoint to path: %s\n", temporaryPath.c_str());
+            std::error_code errorCode;
+            std::filesystem::remove(temporaryPath, errorCode);
+            return false;
+        }
+    }
+
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryPath, filePath, errorCode);
+    if (errorCode)
+    {
+        fprintf(stderr,
+                "Failed to replace checkpoint at path: %s (%s)\n",
+                filePath.c_str(),
+                errorCode.message().c_str());
+        std::filesystem::remove(temporaryPath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+MappedFile::MappedFile(const std::filesystem::path& filePath)
+    : _mapping(nullptr)
+    , _mappingSize(0)
+    , _state({0, 0, 0, 0, 0})
+    , _cells(nullptr)
+    , _cellWordCount(0)
+{
+    const int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        fprintf(stderr, "Failed to open checkpoint at path: %s\n", filePath.c_str());
+        return;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size < static_cast<off_t>(sizeof(FileHeader)))
+    {
+        fprintf(stderr, "Ignoring truncated checkpoint '%s'.\n", filePath.c_str());
+        close(fileDescriptor);
+        return;
+    }
+    const auto fileSize = static_cast<size_t>(fileStatus.st_size);
+
+    // NOTE(MM): The mapping stays valid after closing the file.
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "Failed to map checkpoint at path: %s\n", filePath.c_str());
+        return;
+    }
+    _mapping = mapping;
+    _mappingSize = fileSize;
+
+    const char* fileContent = static_cast<const char*>(mapping);
+    FileHeader header;
+    std::memcpy(&header, fileContent, sizeof(header));
+
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION)
+    {
+        fprintf(stderr, "Checkpoint '%s' has an unknown format.\n", filePath.c_str());
+        return;
+    }
+
+    const uint64_t cellsEnd = header.cellsOffset + header.cellWordCount * sizeof(uint32_t);
+    if (header.gridWidth % PackedGrid::CELLS_PER_WORD != 0 || header.currentGridBuffer > 1
+        || header.cellWordCount != getExpectedCellWordCount(header.gridWidth, header.gridHeight)
+        || header.cellsOffset % CELLS_ALIGNMENT != 0 || header.cellsOffset < sizeof(header) || cellsEnd != fileSize)
+    {
+        fprintf(stderr, "Checkpoint '%s' is corrupted.\n", filePath.c_str());
+        return;
+    }
+
+    // NOTE(MM): The cells are read once front to back when uploading them.
+    madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+    _state.gridWidth = header.gridWidth;
+    _state.gridHeight = header.gridHeight;
+    _state.generation = header.generation;
+    _state.currentGridBuffer = header.currentGridBuffer;
+    _state.seed = header.seed;
+    _cells = reinterpret_cast<const uint32_t*>(fileContent + header.cellsOffset);
+    _cellWordCount = static_cast<size_t>(header.cellWordCount);
+}
+
+MappedFile::~MappedFile()
+{
+    if (_mapping)
+    {
+        munmap(_mapping, _mappingSize);
+    }
+}
+
+MappedFile::operator bool() const
+{
+    return _cells != nullptr;
+}
+
+} // namespace VkHourglass::Checkpoint
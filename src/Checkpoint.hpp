@@ -0,0 +1,67 @@
+#ifndef VULKANHOURGLASS_CHECKPOINT_HPP
+#define VULKANHOURGLASS_CHECKPOINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace VkHourglass::Checkpoint
+{
+
+// Simulation state needed to continue a run exactly where it stopped: Stepping the restored cells with the restored
+// seed, starting at `currentGridBuffer` and `generation`, produces the same generations as the original run would
+// have.
+struct State
+{
+    uint32_t gridWidth;
+    uint32_t gridHeight;
+    // Counter as pushed to the compute shader (see PushConstants.hpp), i.e. the number of computed generations.
+    uint32_t generation;
+    // Index of the cell buffer holding the latest generation, determines the partition offset of the next one.
+    uint32_t currentGridBuffer;
+    // Key of the random numbers, see `PushConstants::seed`.
+    uint32_t seed;
+};
+
+// File layout: A versioned header and, starting at a page aligned offset, the cells in
+// the layout of `PackedGrid::getData()` (which is the layout of the GPU cell buffers unless their row pairs are
+// interleaved, see CellBufferLayout.hpp). Hence, a mapped file can usually be uploaded to the cell buffers as is.
+//
+// The file is replaced atomically (written to a temporary file first, then renamed), so that a crash while writing
+// never destroys the previous checkpoint.
+bool writeFile(const std::filesystem::path& filePath, const State& state, const uint32_t* cells, size_t cellWordCount);
+
+// Read-only memory mapping of a checkpoint file. Check with `operator bool()` if the file could be mapped and is valid.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& filePath);
+    ~MappedFile();
+
+    // NOTE(MM): We don't need copies/moves in our application. Therefore, delete copy/moves operations to avoid
+    // unwanted unmapping.
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) noexcept = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) noexcept = delete;
+
+    explicit operator bool() const;
+
+    const State& getState(void) const { return _state; }
+
+    // Points into the mapping, valid as long as this object lives.
+    const uint32_t* getCells(void) const { return _cells; }
+    size_t getCellWordCount(void) const { return _cellWordCount; }
+
+private:
+    void* _mapping;
+    size_t _mappingSize;
+
+    State _state;
+    const uint32_t* _cells;
+    size_t _cellWordCount;
+};
+
+} // namespace VkHourglass::Checkpoint
+
+#endif // VULKANHOURGLASS_CHECKPOINT_HPP
@@ -0,0 +1,125 @@
+#include "CheckpointWriter.hpp"
+
+#include <chrono>
+#include <vector>
+
+#include "CellBufferLayout.hpp"
+#include "GpuCommands.hpp"
+#include "Macros.hpp"
+#include "VulkanContext.hpp"
+
+namespace VkHourglass
+{
+
+// Writes a checkpoint of the cells copied from cell buffer `state.currentGridBuffer`. Checkpoints store them in
+// `PackedGrid` layout, independent of the cell buffer layout.
+static bool writeCheckpointFromBuffer(const std::filesystem::path& filePath,
+                                      const Checkpoint::State& state,
+                                      const CellBufferLayout& cellBufferLayout,
+                                      const uint32_t* bufferCells)
+{
+    if (!cellBufferLayout.isInterleaved())
+    {
+        return Checkpoint::writeFile(filePath, state, bufferCells, cellBufferLayout.getGridWordCount());
+    }
+
+    std::vector<uint32_t> cells(cellBufferLayout.getGridWordCount());
+    cellBufferLayout.unpack(state.currentGridBuffer, bufferCells, cells.data());
+    return Checkpoint::writeFile(filePath, state, cells.data(), cells.size());
+}
+
+CheckpointWriter::CheckpointWriter(const std::optional<std::filesystem::path>& path,
+                                   uint32_t interval,
+                                   uint32_t generation)
+    : _path(path)
+    , _interval(interval)
+    , _lastGeneration(generation)
+    , _pendingFrame(std::nullopt)
+    , _pendingState{}
+    , _writeFuture()
+{
+}
+
+void CheckpointWriter::recordCopy(const VulkanContext& context,
+                                  VkCommandBuffer commandBuffer,
+                                  size_t currentFrame,
+                                  size_t currentGridBuffer,
+                                  uint32_t generation,
+                                  uint32_t seed)
+{
+    // NOTE(MM): Unsigned arithmetic keeps this valid when the generation counter wraps around.
+    if (!_path.has_value() || _interval == 0 || generation - _lastGeneration < _interval || _pendingFrame.has_value())
+    {
+        return;
+    }
+
+    // The checkpoint buffer is still read by the previous write. Failures are reported by the write itself and don't
+    // stop the simulation, the next checkpoint may succeed.
+    if (_writeFuture.valid())
+    {
+        if (_writeFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return;
+        }
+        _writeFuture.get();
+    }
+
+    // NOTE(MM): Makes the copy available to the host, it becomes visible by waiting for the fence of the frame.
+    GpuCommands::recordCellBufferCopy(context,
+                                      commandBuffer,
+                                      currentGridBuffer,
+                                      context.checkpointBuffer,
+                                      VK_PIPELINE_STAGE_HOST_BIT,
+                                      VK_ACCESS_HOST_READ_BIT);
+
+    const Configuration& configuration = context.configuration;
+
+    _pendingFrame = currentFrame;
+    _pendingState = {
+        configuration.gridWidth, configuration.gridHeight, generation, static_cast<uint32_t>(currentGridBuffer), seed};
+    _lastGeneration = generation;
+}
+
+void CheckpointWriter::writePending(const VulkanContext& context, size_t currentFrame)
+{
+    if (_pendingFrame != currentFrame)
+    {
+        return;
+    }
+    _pendingFrame.reset();
+
+    // NOTE(MM): Path and state are copied to the worker thread, the cells are read straight from the mapped buffer.
+    const auto* cells = static_cast<const uint32_t*>(context.checkpointBufferMemory.mappedData);
+    _writeFuture = std::async(std::launch::async,
+                              writeCheckpointFromBuffer,
+                              _path.value(),
+                              _pendingState,
+                              CellBufferLayout(context.configuration),
+                              cells);
+}
+
+bool CheckpointWriter::writeFinal(const VulkanContext& context,
+                                  size_t currentGridBuffer,
+                                  uint32_t generation,
+                                  uint32_t seed)
+{
+    if (_writeFuture.valid())
+    {
+        _writeFuture.get();
+    }
+
+    if (!_path.has_value())
+    {
+        return true;
+    }
+
+    const auto cellsOpt = context.readCellBuffer(currentGridBuffer);
+    RETURN_ON_NULLOPT_V(cellsOpt, false);
+
+    const PackedGrid& cells = cellsOpt.value();
+    const Checkpoint::State state{
+        cells.getWidth(), cells.getHeight(), generation, static_cast<uint32_t>(currentGridBuffer), seed};
+    return Checkpoint::writeFile(_path.value(), state, cells.getData().data(), cells.getData().size());
+}
+
+} // namespace VkHourglass
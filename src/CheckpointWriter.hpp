@@ -0,0 +1,56 @@
+#ifndef VULKANHOURGLASS_CHECKPOINTWRITER_HPP
+#define VULKANHOURGLASS_CHECKPOINTWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <optional>
+
+#include <vulkan/vulkan_core.h>
+
+#include "Checkpoint.hpp"
+
+namespace VkHourglass
+{
+
+class VulkanContext;
+
+// Periodic checkpoints without stalling the frame loop: The command buffer of a frame copies the latest cells to
+// `VulkanContext::checkpointBuffer` (see `recordCopy()`). Once the fence of the frame is waited for the next time, the
+// file is written from the mapped buffer on a worker thread (see `writePending()`). Checkpoints due while the previous
+// one is still written are postponed.
+//
+// "Frames" are the command buffers used round robin by the caller, i.e. also headless or async compute submissions.
+class CheckpointWriter
+{
+public:
+    // Without `path`, no checkpoints are written. With an `interval` of 0, only the final one is written. `generation`
+    // is the one the run starts at.
+    CheckpointWriter(const std::optional<std::filesystem::path>& path, uint32_t interval, uint32_t generation);
+
+    // Copies the cells to the checkpoint buffer at the end of `commandBuffer` if a checkpoint is due.
+    void recordCopy(const VulkanContext& context,
+                    VkCommandBuffer commandBuffer,
+                    size_t currentFrame,
+                    size_t currentGridBuffer,
+                    uint32_t generation,
+                    uint32_t seed);
+    // Starts writing the checkpoint copied by `currentFrame`, expects the fence of the frame to be signaled.
+    void writePending(const VulkanContext& context, size_t currentFrame);
+    // Writes the latest cells, expects the device to be idle. Pending checkpoints are superseded by this one.
+    bool writeFinal(const VulkanContext& context, size_t currentGridBuffer, uint32_t generation, uint32_t seed);
+
+private:
+    const std::optional<std::filesystem::path> _path;
+    const uint32_t _interval;
+    uint32_t _lastGeneration;
+    // Frame whose command buffer copies the cells of `_pendingState`.
+    std::optional<size_t> _pendingFrame;
+    Checkpoint::State _pendingState;
+    std::future<bool> _writeFuture;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_CHECKPOINTWRITER_HPP
@@ -0,0 +1,412 @@
+#include "Configuration.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <variant>
+
+#include "ApplicationDefines.hpp"
+#include "CellBufferLayout.hpp"
+
+namespace VkHourglass
+{
+
+using SettingPointer = std::variant<uint32_t*, float*, bool*>;
+
+// NOTE(MM): Single place mapping keys to settings, used for parsing and printing.
+static std::array<std::pair<std::string_view, SettingPointer>, 23> getSettings(Configuration& configuration)
+{
+    return {{
+        {"grid_width", &configuration.gridWidth},
+        {"grid_height", &configuration.gridHeight},
+        {"compute_local_group_size_x", &configuration.computeLocalGroupSizeX},
+        {"compute_tile_width_words", &configuration.tileWidthWords},
+        {"compute_shared_memory_tiles", &configuration.useSharedMemoryTiles},
+        {"interleave_row_pairs", &configuration.interleaveRowPairs},
+        {"step_in_place", &configuration.stepInPlace},
+        {"compute_temporal_steps", &configuration.temporalSteps},
+        {"async_compute", &configuration.useAsyncCompute},
+        {"cpu_temporal_steps", &configuration.cpuTemporalSteps},
+        {"cpu_numa_bands", &configuration.cpuNumaBands},
+        {"enable_horizontal_wrapping", &configuration.enableHorizontalWrapping},
+        {"stuck_probability", &configuration.stuckProbability},
+        {"hourglass.width", &configuration.hourglass.width},
+        {"hourglass.height", &configuration.hourglass.height},
+        {"hourglass.border_width", &configuration.hourglass.borderWidth},
+        {"hourglass.center_width", &configuration.hourglass.centerWidth},
+        {"hourglass.fill_percentage", &configuration.hourglass.fillPercentage},
+        {"center_circle.radius", &configuration.centerCircle.radius},
+        {"random_circles.min_radius", &configuration.randomCircles.minRadius},
+        {"random_circles.max_radius", &configuration.randomCircles.maxRadius},
+        {"random_circles.circle_count", &configuration.randomCircles.circleCount},
+        {"random_noise.particle_count", &configuration.randomNoise.particleCount},
+    }};
+}
+
+static bool parseValue(const std::string& text, uint32_t& value)
+{
+    if (text.empty() || text[0] == '-' || text[0] == '+')
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = strtoull(text.c_str(), &end, 10);
+    if (*end != '\0' || errno != 0 || parsed > std::numeric_limits<uint32_t>::max())
+    {
+        return false;
+    }
+
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+static bool parseValue(const std::string& text, float& value)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    const float parsed = strtof(text.c_str(), &end);
+    if (*end != '\0' || errno != 0)
+    {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+static bool parseValue(const std::string& text, bool& value)
+{
+    if (text == "true" || text == "1")
+    {
+        value = true;
+        return true;
+    }
+
+    if (text == "false" || text == "0")
+    {
+        value = false;
+        return true;
+    }
+
+    return false;
+}
+
+static std::string formatValue(uint32_t value)
+{
+    return std::to_string(value);
+}
+
+static std::string formatValue(float value)
+{
+    std::array<char, 32> text{};
+    snprintf(text.data(), text.size(), "%g", static_cast<double>(value));
+    return text.data();
+}
+
+static std::string formatValue(bool value)
+{
+    return value ? "true" : "false";
+}
+
+static std::string_view trim(std::string_view text)
+{
+    constexpr std::string_view whitespace = " \t\r\n";
+
+    const size_t begin = text.find_first_not_of(whitespace);
+    if (begin == std::string_view::npos)
+    {
+        return {};
+    }
+
+    const size_t end = text.find_last_not_of(whitespace);
+    return text.substr(begin, end - begin + 1);
+}
+
+uint32_t Configuration::getGridSize(void) const
+{
+    return gridWidth * gridHeight;
+}
+
+uint32_t Configuration::getWordsPerRow(void) const
+{
+    return gridWidth / ApplicationDefines::NonModifiable::CELLS_PER_WORD;
+}
+
+uint32_t Configuration::getCellBufferWordCount(void) const
+{
+    return static_cast<uint32_t>(CellBufferLayout(*this).getWordCount());
+}
+
+uint32_t Configuration::getCellBufferCount(void) const
+{
+    return stepInPlace ? 1 : 2;
+}
+
+uint32_t Configuration::getTileHeightBlockRows(void) const
+{
+    return computeLocalGroupSizeX / tileWidthWords;
+}
+
+uint32_t Configuration::getTileColumnCount(void) const
+{
+    return getWordsPerRow() / tileWidthWords;
+}
+
+uint32_t Configuration::getTileRowCount(void) const
+{
+    return gridHeight / 2 / getTileHeightBlockRows();
+}
+
+uint32_t Configuration::getTileCount(void) const
+{
+    return getTileColumnCount() * getTileRowCount();
+}
+
+uint32_t Configuration::getSharedMemoryTileSize(void) const
+{
+    // NOTE(MM): Sand and wall plane of both rows of each block row, with a word of the neighbouring tiles on each side.
+    return getTileHeightBlockRows() * 2 * (tileWidthWords + 2) * 2 * static_cast<uint32_t>(sizeof(uint32_t));
+}
+
+uint32_t Configuration::getTemporalTileSize(void) const
+{
+    // NOTE(MM): Like the shared memory tiles, with a halo of the block rows reached within the temporal steps above and
+    // below, and the sand plane twice (current and next generation).
+    const uint32_t haloBlockRows = (temporalSteps + 1) / 2;
+    const uint32_t tileWordCount = (getTileHeightBlockRows() + 2 * haloBlockRows) * 2 * (tileWidthWords + 2);
+    return (tileWordCount * 3 + 1) * static_cast<uint32_t>(sizeof(uint32_t));
+}
+
+uint32_t Configuration::getComputeSharedMemorySize(void) const
+{
+    // NOTE(MM): The shader only sizes the shared memory of the tiles it uses, see 'shaders/shader.comp'.
+    return (useSharedMemoryTiles ? getSharedMemoryTileSize() : 0) + (temporalSteps > 1 ? getTemporalTileSize() : 0);
+}
+
+uint32_t Configuration::getActiveTilesBufferWordCount(void) const
+{
+    return ApplicationDefines::NonModifiable::ACTIVE_TILES_HEADER_WORD_COUNT + getTileCount() * 2;
+}
+
+uint32_t Configuration::getActiveTilesDispatchCount(void) const
+{
+    return (getTileCount() + computeLocalGroupSizeX - 1) / computeLocalGroupSizeX;
+}
+
+Configuration getDefaultConfiguration(void)
+{
+    using namespace ApplicationDefines;
+
+    Configuration configuration{};
+    configuration.gridWidth = GRID_WIDTH;
+    configuration.gridHeight = GRID_HEIGHT;
+    configuration.computeLocalGroupSizeX = COMPUTE_LOCAL_GROUP_SIZE_X;
+    configuration.tileWidthWords = TILE_WIDTH_WORDS;
+    configuration.useSharedMemoryTiles = USE_SHARED_MEMORY_TILES;
+    configuration.interleaveRowPairs = INTERLEAVE_ROW_PAIRS;
+    configuration.stepInPlace = STEP_IN_PLACE;
+    configuration.temporalSteps = TEMPORAL_STEPS;
+    configuration.useAsyncCompute = USE_ASYNC_COMPUTE;
+    configuration.cpuTemporalSteps = CPU_TEMPORAL_STEPS;
+    configuration.cpuNumaBands = CPU_NUMA_BANDS;
+    configuration.enableHorizontalWrapping = ENABLE_HORIZONTAL_WRAPPING;
+    configuration.stuckProbability = STUCK_PROBABILITY;
+    configuration.hourglass = {GenerateHourglass::HOURGLASS_WIDTH,
+                               GenerateHourglass::HOURGLASS_HEIGHT,
+                               GenerateHourglass::HOURGLASS_BORDER_WIDTH,
+                               GenerateHourglass::HOURGLASS_CENTER_WIDTH,
+                               GenerateHourglass::HOURGLASS_FILL_PERCENTAGE};
+    configuration.centerCircle = {GenerateCenterCircle::RADIUS};
+    configuration.randomCircles = {
+        GenerateRandomCircles::MIN_RADIUS, GenerateRandomCircles::MAX_RADIUS, GenerateRandomCircles::CIRCLE_COUNT};
+    configuration.randomNoise = {GenerateRandom::PARTICLE_COUNT};
+
+    return configuration;
+}
+
+bool setConfigurationValue(Configuration& configuration, std::string_view key, std::string_view value)
+{
+    for (const auto& [settingKey, settingPointer] : getSettings(configuration))
+    {
+        if (settingKey != key)
+        {
+            continue;
+        }
+
+        const std::string text(value);
+        const bool isParsed = std::visit(
+            [&text](auto* setting) {
+                return parseValue(text, *setting);
+            },
+            settingPointer);
+        if (!isParsed)
+        {
+            fprintf(stderr,
+                    "Invalid value '%s' for setting '%.*s'!\n",
+                    text.c_str(),
+                    static_cast<int>(key.size()),
+                    key.data());
+        }
+        return isParsed;
+    }
+
+    fprintf(stderr, "Unknown setting '%.*s'!\n", static_cast<int>(key.size()), key.data());
+    return false;
+}
+
+bool loadConfigurationFile(Configuration& configuration, const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        fprintf(stderr, "Failed to open config file '%s'!\n", path.string().c_str());
+        return false;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        std::string_view content = line;
+        content = trim(content.substr(0, content.find('#')));
+        if (content.empty())
+        {
+            continue;
+        }
+
+        const size_t separator = content.find('=');
+        if (separator == std::string_view::npos)
+        {
+            fprintf(stderr, "%s:%zu: Expected '<key> = <value>'!\n", path.string().c_str(), lineNumber);
+            return false;
+        }
+
+        if (!setConfigurationValue(configuration,
+                                   trim(content.substr(0, separator)),
+                                   trim(content.substr(separator + 1))))
+        {
+            fprintf(stderr, "%s:%zu: Invalid setting!\n", path.string().c_str(), lineNumber);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool validateConfiguration(const Configuration& configuration)
+{
+    using ApplicationDefines::NonModifiable::CELLS_PER_WORD;
+    using ApplicationDefines::NonModifiable::MAX_CPU_TEMPORAL_STEPS;
+    using ApplicationDefines::NonModifiable::MAX_TEMPORAL_STEPS;
+
+    const uint64_t gridWidth = configuration.gridWidth;
+    const uint64_t gridHeight = configuration.gridHeight;
+    const Configuration::Hourglass& hourglass = configuration.hourglass;
+    const Configuration::RandomCircles& randomCircles = configuration.randomCircles;
+
+    bool isValid = true;
+    const auto check = [&isValid](bool condition, const char* message) {
+        if (!condition)
+        {
+            fprintf(stderr, "Invalid configuration: %s\n", message);
+            isValid = false;
+        }
+    };
+
+    check(gridWidth >= 2 && gridHeight >= 2, "Grid has to be at least 2x2 cells");
+    check(gridWidth % 2 == 0 && gridHeight % 2 == 0, "Grid width and height have to be even");
+    check(gridWidth % CELLS_PER_WORD == 0, "Grid width has to be a multiple of 32");
+    // NOTE(MM): using uint32_t throughout application that holds 'grid size * sizeof(uint32_t)'
+    check(gridWidth * gridHeight < std::numeric_limits<uint32_t>::max() / sizeof(uint32_t), "Grid is too large");
+    check(gridWidth < std::numeric_limits<int32_t>::max() && gridHeight < std::numeric_limits<int32_t>::max(),
+          "Grid is too large");
+
+    const uint32_t tileWidthWords = configuration.tileWidthWords;
+    check(tileWidthWords >= 1, "Tile width has to be at least 1 word");
+    check(tileWidthWords >= 1 && configuration.computeLocalGroupSizeX >= 1
+              && configuration.computeLocalGroupSizeX % tileWidthWords == 0,
+          "Compute local group size has to be a multiple of the tile width");
+    if (tileWidthWords >= 1 && configuration.computeLocalGroupSizeX >= tileWidthWords
+        && gridWidth % CELLS_PER_WORD == 0)
+    {
+        check(configuration.getWordsPerRow() % tileWidthWords == 0,
+              "Words per grid row have to be a multiple of the tile width");
+        check((gridHeight / 2) % configuration.getTileHeightBlockRows() == 0,
+              "Block rows have to be a multiple of the tile height (compute local group size / tile width)");
+
+        // NOTE(MM): Cells outside of the tile and its halo are never read, hence a cell may only reach the neighbouring
+        // tiles (with their halo) within the temporal steps, see 'shaders/shader.comp'.
+        check(configuration.temporalSteps <= 2 * configuration.getTileHeightBlockRows(),
+              "Temporal steps can't exceed the tile height in rows");
+
+        // NOTE(MM): Minimum 'maxComputeSharedMemorySize' guaranteed by Vulkan, the limit of the device is checked when
+        // picking it.
+        check(configuration.getComputeSharedMemorySize() <= 16384,
+              "Shared memory tiles exceed 16 KiB, use fewer temporal steps or a smaller compute local group size");
+    }
+
+    check(configuration.temporalSteps >= 1 && configuration.temporalSteps <= MAX_TEMPORAL_STEPS,
+          "Temporal steps have to be within [1, 7]");
+    check(configuration.temporalSteps % 2 == 1, "Temporal steps have to be odd");
+    check(configuration.temporalSteps <= 1 || !configuration.stepInPlace,
+          "Temporal steps and stepping in place can't be combined");
+    // NOTE(MM): Temporal blocking has shared memory tiles of its own, 'sharedSand' and 'sharedWall' would be unused.
+    check(configuration.temporalSteps <= 1 || !configuration.useSharedMemoryTiles,
+          "Temporal steps and shared memory tiles can't be combined");
+    check(configuration.cpuTemporalSteps >= 1 && configuration.cpuTemporalSteps <= MAX_CPU_TEMPORAL_STEPS
+              && configuration.cpuTemporalSteps % 2 == 1,
+          "CPU temporal steps have to be odd and within [1, 31]");
+
+    check(!configuration.stepInPlace || !configuration.interleaveRowPairs,
+          "Stepping in place and interleaved row pairs can't be combined");
+
+    check(configuration.stuckProbability >= 0.0f && configuration.stuckProbability <= 1.0f,
+          "Stuck probability has to be within [0, 1]");
+
+    check(gridWidth >= uint64_t(hourglass.width) + hourglass.borderWidth, "Hourglass is wider than the grid");
+    check(gridHeight >= uint64_t(hourglass.height) + hourglass.borderWidth, "Hourglass is higher than the grid");
+    check(hourglass.centerWidth >= 2, "Hourglass center width has to be at least 2");
+    check(gridWidth >= uint64_t(hourglass.centerWidth) + hourglass.borderWidth,
+          "Hourglass center is wider than the grid");
+    check(hourglass.width % 2 == 0 && hourglass.height % 2 == 0, "Hourglass width and height have to be even");
+    check(hourglass.fillPercentage >= 0.0f && hourglass.fillPercentage <= 1.0f,
+          "Hourglass fill percentage has to be within [0, 1]");
+
+    check(configuration.centerCircle.radius < std::numeric_limits<int32_t>::max(), "Center circle radius is too large");
+    check(randomCircles.maxRadius < std::numeric_limits<int32_t>::max(), "Random circles radius is too large");
+    check(randomCircles.minRadius <= randomCircles.maxRadius,
+          "Random circles minimum radius is larger than the maximum radius");
+
+    return isValid;
+}
+
+void printConfigurationKeys(void)
+{
+    Configuration configuration = getDefaultConfiguration();
+
+    printf("Settings (default values):\n");
+    for (const auto& [key, settingPointer] : getSettings(configuration))
+    {
+        std::visit(
+            [key = key](auto* setting) {
+                printf("    %.*s = %s\n", static_cast<int>(key.size()), key.data(), formatValue(*setting).c_str());
+            },
+            settingPointer);
+    }
+}
+
+} // namespace VkHourglass
@@ -0,0 +1,105 @@
+#ifndef VULKANHOURGLASS_CONFIGURATION_HPP
+#define VULKANHOURGLASS_CONFIGURATION_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace VkHourglass
+{
+
+// Grid and simulation settings which can be changed without recompiling, via a config file ('--config <file>') and/or
+// the command line ('--set <key>=<value>'). Defaults are taken from ApplicationDefines.hpp.
+//
+// Config files consist of '<key> = <value>' lines, '#' starts a comment. Keys are the ones listed in
+// 'printConfigurationKeys()', e.g.:
+//
+//     grid_width = 2048
+//     grid_height = 2048
+//     compute_local_group_size_x = 64
+//     hourglass.width = 600
+struct Configuration
+{
+    uint32_t gridWidth;
+    uint32_t gridHeight;
+    uint32_t computeLocalGroupSizeX;
+    uint32_t tileWidthWords;
+    bool useSharedMemoryTiles;
+    bool interleaveRowPairs;
+    bool stepInPlace;
+    uint32_t temporalSteps;
+    bool useAsyncCompute;
+    uint32_t cpuTemporalSteps;
+    bool cpuNumaBands;
+    bool enableHorizontalWrapping;
+    float stuckProbability;
+
+    struct Hourglass
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t borderWidth;
+        uint32_t centerWidth;
+        float fillPercentage;
+    };
+    Hourglass hourglass;
+
+    struct CenterCircle
+    {
+        uint32_t radius;
+    };
+    CenterCircle centerCircle;
+
+    struct RandomCircles
+    {
+        uint32_t minRadius;
+        uint32_t maxRadius;
+        uint32_t circleCount;
+    };
+    RandomCircles randomCircles;
+
+    struct RandomNoise
+    {
+        uint32_t particleCount;
+    };
+    RandomNoise randomNoise;
+
+    // NOTE(MM): Sizes derived from the settings above, see the packed layout in PackedGrid.hpp, the cell buffer layout
+    // in CellBufferLayout.hpp and the tiles in 'shaders/tiles.comp'.
+    uint32_t getGridSize(void) const;
+    uint32_t getWordsPerRow(void) const;
+    uint32_t getCellBufferWordCount(void) const;
+    // Number of cell buffers the generations alternate between (1 when stepping in place).
+    uint32_t getCellBufferCount(void) const;
+    uint32_t getTileHeightBlockRows(void) const;
+    uint32_t getTileColumnCount(void) const;
+    uint32_t getTileRowCount(void) const;
+    uint32_t getTileCount(void) const;
+    // Shared memory used per workgroup of the cell update, see 'shaders/shader.comp'.
+    uint32_t getSharedMemoryTileSize(void) const;
+    // Same for temporal blocking (temporalSteps > 1).
+    uint32_t getTemporalTileSize(void) const;
+    // Shared memory used per workgroup of the cell update with the tiles enabled by this configuration.
+    uint32_t getComputeSharedMemorySize(void) const;
+    uint32_t getActiveTilesBufferWordCount(void) const;
+    // Workgroups needed to check every tile for activity (one invocation per tile).
+    uint32_t getActiveTilesDispatchCount(void) const;
+};
+
+Configuration getDefaultConfiguration(void);
+
+// Sets the setting `key` from its textual representation. Prints an error and returns false if the key is unknown or
+// the value can't be parsed.
+bool setConfigurationValue(Configuration& configuration, std::string_view key, std::string_view value);
+// Same for all settings of a config file, see `Configuration`.
+bool loadConfigurationFile(Configuration& configuration, const std::filesystem::path& path);
+
+// Checks the constraints between the settings (e.g. the hourglass has to fit into the grid). Prints every violated
+// constraint and returns false if there is any.
+bool validateConfiguration(const Configuration& configuration);
+
+void printConfigurationKeys(void);
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_CONFIGURATION_HPP
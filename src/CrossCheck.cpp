@@ -0,0 +1,58 @@
+#include "CrossCheck.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+
+#include "Macros.hpp"
+#include "MargolusEngine.hpp"
+#include "PackedGrid.hpp"
+#include "VulkanContext.hpp"
+
+namespace VkHourglass::CrossCheck
+{
+
+bool compareWithCpu(const VulkanContext& context,
+                    MargolusEngine& margolusEngine,
+                    size_t currentGridBuffer,
+                    size_t stepCount)
+{
+    for (size_t i = 0; i < stepCount; ++i)
+    {
+        margolusEngine.step();
+    }
+    assert(margolusEngine.getCurrentBuffer() == currentGridBuffer && "CPU and GPU buffers are out of sync!");
+
+    const auto gpuCellsOpt = context.readCellBuffer(currentGridBuffer);
+    RETURN_ON_NULLOPT_V(gpuCellsOpt, false);
+
+    const PackedGrid& gpuCells = gpuCellsOpt.value();
+    const PackedGrid& cpuCells = margolusEngine.getCells();
+    if (gpuCells == cpuCells)
+    {
+        return true;
+    }
+
+    for (uint32_t y = 0; y < gpuCells.getHeight(); ++y)
+    {
+        for (uint32_t x = 0; x < gpuCells.getWidth(); ++x)
+        {
+            if (gpuCells.getCell(x, y) != cpuCells.getCell(x, y))
+            {
+                fprintf(stderr,
+                        "CPU cross check failed at cell (%u, %u): GPU %u, CPU %u\n",
+                        x,
+                        y,
+                        gpuCells.getCell(x, y),
+                        cpuCells.getCell(x, y));
+                return false;
+            }
+        }
+    }
+
+    // NOTE(MM): Only reachable if the grids differ in padding, which doesn't exist for the current layout.
+    fprintf(stderr, "CPU cross check failed!\n");
+    return false;
+}
+
+} // namespace VkHourglass::CrossCheck
@@ -0,0 +1,27 @@
+#ifndef VULKANHOURGLASS_CROSSCHECK_HPP
+#define VULKANHOURGLASS_CROSSCHECK_HPP
+
+#include <cstddef>
+
+namespace VkHourglass
+{
+class MargolusEngine;
+class VulkanContext;
+} // namespace VkHourglass
+
+// Comparison of the GPU generations with the CPU reference implementation, see
+// `ApplicationDefines::ENABLE_CPU_CROSS_CHECK`.
+namespace VkHourglass::CrossCheck
+{
+
+// Steps `margolusEngine` by `stepCount` generations and compares them to cell buffer `currentGridBuffer`, which has to
+// hold the same generation. Reads the cell buffer back (see `VulkanContext::readCellBuffer()`), i.e. expects the
+// commands computing it to be submitted. Reports the first differing cell.
+bool compareWithCpu(const VulkanContext& context,
+                    MargolusEngine& margolusEngine,
+                    size_t currentGridBuffer,
+                    size_t stepCount);
+
+} // namespace VkHourglass::CrossCheck
+
+#endif // VULKANHOURGLASS_CROSSCHECK_HPP
@@ -0,0 +1,300 @@
+#include "DeviceMemoryArena.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdio>
+
+#include "Macros.hpp"
+
+namespace VkHourglass
+{
+
+static constexpr size_t POOL_TYPE_COUNT = static_cast<size_t>(DeviceMemoryArena::PoolType::Count);
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static double toMebibytes(VkDeviceSize bytes)
+{
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+DeviceMemoryArena::DeviceMemoryArena(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize)
+    : _device(device)
+    , _memoryProperties()
+    , _nonCoherentAtomSize(1)
+    , _blockSize(blockSize)
+{
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &_memoryProperties);
+
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    _nonCoherentAtomSize = std::max<VkDeviceSize>(deviceProperties.limits.nonCoherentAtomSize, 1);
+
+    _pools.resize(_memoryProperties.memoryTypeCount * POOL_TYPE_COUNT, Pool{{}, Statistics{0, 0, 0, 0, 0}});
+}
+
+DeviceMemoryArena::~DeviceMemoryArena()
+{
+    for (auto& pool : _pools)
+    {
+        for (auto& block : pool.blocks)
+        {
+            // NOTE(MM): Freeing memory implicitly unmaps it.
+            vkFreeMemory(_device, block.memory, nullptr);
+        }
+    }
+}
+
+std::optional<DeviceMemoryArena::Allocation> DeviceMemoryArena::allocate(const VkMemoryRequirements& requirements,
+                                                                         VkMemoryPropertyFlags properties,
+                                                                         PoolType poolType)
+{
+    const std::optional<uint32_t> memoryTypeIndexOpt = findMemoryType(requirements.memoryTypeBits, properties);
+    if (!memoryTypeIndexOpt.has_value())
+    {
+        fprintf(stderr, "Failed to find suitable memory type for properties: %u!\n", properties);
+        return std::nullopt;
+    }
+    const uint32_t memoryTypeIndex = memoryTypeIndexOpt.value();
+
+    // NOTE(MM): Host accesses to non-coherent memory are flushed/invalidated in multiples of 'nonCoherentAtomSize',
+    // which therefore must not cover neighbouring allocations.
+    VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+    VkDeviceSize size = requirements.size;
+    const VkMemoryPropertyFlags memoryTypeFlags = _memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    if ((memoryTypeFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        && !(memoryTypeFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+        alignment = std::max(alignment, _nonCoherentAtomSize);
+        size = alignUp(size, _nonCoherentAtomSize);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Pool& pool = getPool(memoryTypeIndex, poolType);
+
+    std::optional<VkDeviceSize> offset = std::nullopt;
+    Block* block = nullptr;
+    for (auto& candidate : pool.blocks)
+    {
+        if (poolType == PoolType::Linear)
+        {
+            const VkDeviceSize alignedOffset = alignUp(candidate.linearOffset, alignment);
+            if (alignedOffset + size <= candidate.size)
+            {
+                offset = alignedOffset;
+                block = &candidate;
+                break;
+            }
+            continue;
+        }
+
+        for (const auto& [rangeOffset, rangeSize] : candidate.freeRanges)
+        {
+            const VkDeviceSize alignedOffset = alignUp(rangeOffset, alignment);
+            if (alignedOffset + size <= rangeOffset + rangeSize)
+            {
+                offset = alignedOffset;
+                block = &candidate;
+                break;
+            }
+        }
+        if (block)
+        {
+            break;
+        }
+    }
+
+    if (!block)
+    {
+        block = createBlock(pool, memoryTypeIndex, std::max(_blockSize, size));
+        if (!block)
+        {
+            return std::nullopt;
+        }
+        offset = 0;
+    }
+
+    if (poolType == PoolType::Linear)
+    {
+        block->linearOffset = offset.value() + size;
+    }
+    else
+    {
+        // NOTE(MM): Split the free range containing the allocation, keeping the alignment padding in front and the
+        // rest behind it free.
+        auto range = std::prev(block->freeRanges.upper_bound(offset.value()));
+        const VkDeviceSize rangeOffset = range->first;
+        const VkDeviceSize rangeEnd = range->first + range->second;
+        block->freeRanges.erase(range);
+
+        if (rangeOffset < offset.value())
+        {
+            block->freeRanges.emplace(rangeOffset, offset.value() - rangeOffset);
+        }
+        if (offset.value() + size < rangeEnd)
+        {
+            block->freeRanges.emplace(offset.value() + size, rangeEnd - offset.value() - size);
+        }
+    }
+
+    ++block->allocationCount;
+    ++pool.statistics.allocationCount;
+    pool.statistics.usedBytes += size;
+    pool.statistics.peakUsedBytes = std::max(pool.statistics.peakUsedBytes, pool.statistics.usedBytes);
+
+    void* mappedData = block->mappedData ? static_cast<char*>(block->mappedData) + offset.value() : nullptr;
+    return Allocation{block->memory, offset.value(), size, mappedData, memoryTypeIndex, poolType};
+}
+
+bool DeviceMemoryArena::hasMemoryType(VkMemoryPropertyFlags properties) const
+{
+    return findMemoryType(~0u, properties).has_value();
+}
+
+void DeviceMemoryArena::free(const Allocation& allocation)
+{
+    if (allocation.memory == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Pool& pool = getPool(allocation.memoryTypeIndex, allocation.poolType);
+
+    auto block = std::find_if(pool.blocks.begin(), pool.blocks.end(), [&allocation](const Block& b) {
+        return b.memory == allocation.memory;
+    });
+    assert(block != pool.blocks.end() && "DeviceMemoryArena::free: Allocation doesn't belong to the arena!");
+    assert(block->allocationCount > 0 && "DeviceMemoryArena::free: Allocation freed twice!");
+
+    --block->allocationCount;
+    --pool.statistics.allocationCount;
+    pool.statistics.usedBytes -= allocation.size;
+
+    if (allocation.poolType == PoolType::Linear)
+    {
+        if (block->allocationCount == 0)
+        {
+            block->linearOffset = 0;
+        }
+        return;
+    }
+
+    VkDeviceSize rangeOffset = allocation.offset;
+    VkDeviceSize rangeSize = allocation.size;
+
+    auto next = block->freeRanges.lower_bound(rangeOffset);
+    if (next != block->freeRanges.end() && next->first == rangeOffset + rangeSize)
+    {
+        rangeSize += next->second;
+        next = block->freeRanges.erase(next);
+    }
+
+    if (next != block->freeRanges.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == rangeOffset)
+        {
+            rangeOffset = previous->first;
+            rangeSize += previous->second;
+            block->freeRanges.erase(previous);
+        }
+    }
+
+    block->freeRanges.emplace(rangeOffset, rangeSize);
+}
+
+DeviceMemoryArena::Statistics DeviceMemoryArena::getStatistics(PoolType poolType) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Statistics statistics{0, 0, 0, 0, 0};
+    for (size_t i = static_cast<size_t>(poolType); i < _pools.size(); i += POOL_TYPE_COUNT)
+    {
+        const Statistics& poolStatistics = _pools[i].statistics;
+        statistics.blockCount += poolStatistics.blockCount;
+        statistics.blockBytes += poolStatistics.blockBytes;
+        statistics.allocationCount += poolStatistics.allocationCount;
+        statistics.usedBytes += poolStatistics.usedBytes;
+        statistics.peakUsedBytes += poolStatistics.peakUsedBytes;
+    }
+
+    return statistics;
+}
+
+void DeviceMemoryArena::printStatistics(void) const
+{
+    constexpr std::array<const char*, POOL_TYPE_COUNT> POOL_NAMES = {"linear", "free list"};
+
+    for (size_t i = 0; i < POOL_TYPE_COUNT; ++i)
+    {
+        const Statistics statistics = getStatistics(static_cast<PoolType>(i));
+        printf("Device memory (%s): %zu blocks with %.2f MiB, %zu allocations using %.2f MiB (peak %.2f MiB)\n",
+               POOL_NAMES[i],
+               statistics.blockCount,
+               toMebibytes(statistics.blockBytes),
+               statistics.allocationCount,
+               toMebibytes(statistics.usedBytes),
+               toMebibytes(statistics.peakUsedBytes));
+    }
+}
+
+std::optional<uint32_t> DeviceMemoryArena::findMemoryType(uint32_t memoryTypeBits,
+                                                          VkMemoryPropertyFlags properties) const
+{
+    for (uint32_t i = 0; i < _memoryProperties.memoryTypeCount; i++)
+    {
+        // The i-th bit of the memory requirements is set if the i-th memory type of the device satisfies them. Hence
+        // the check of the bits before the property check.
+        if ((memoryTypeBits & (1 << i)) && (_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+        {
+            return i;
+        }
+    }
+
+    return std::nullopt;
+}
+
+DeviceMemoryArena::Block* DeviceMemoryArena::createBlock(Pool& pool, uint32_t memoryTypeIndex, VkDeviceSize size)
+{
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VkDeviceMemory memory;
+    VK_RETURN_ON_ERROR_V(vkAllocateMemory(_device, &allocInfo, nullptr, &memory), nullptr);
+
+    void* mappedData = nullptr;
+    if (_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        if (const VkResult result = vkMapMemory(_device, memory, 0, VK_WHOLE_SIZE, 0, &mappedData);
+            result != VK_SUCCESS)
+        {
+            fprintf(stderr, "Failed to map device memory block with result: %d\n", result);
+            vkFreeMemory(_device, memory, nullptr);
+            return nullptr;
+        }
+    }
+
+    Block block{memory, size, mappedData, 0, 0, {}};
+    block.freeRanges.emplace(0, size);
+    pool.blocks.push_back(std::move(block));
+
+    ++pool.statistics.blockCount;
+    pool.statistics.blockBytes += size;
+
+    return &pool.blocks.back();
+}
+
+DeviceMemoryArena::Pool& DeviceMemoryArena::getPool(uint32_t memoryTypeIndex, PoolType poolType)
+{
+    assert(poolType != PoolType::Count && "DeviceMemoryArena: Invalid pool type!");
+    return _pools[memoryTypeIndex * POOL_TYPE_COUNT + static_cast<size_t>(poolType)];
+}
+
+} // namespace VkHourglass
@@ -0,0 +1,118 @@
+#ifndef VULKANHOURGLASS_DEVICEMEMORYARENA_HPP
+#define VULKANHOURGLASS_DEVICEMEMORYARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+namespace VkHourglass
+{
+
+// Sub-allocates buffer memory from a few large `VkDeviceMemory` blocks instead of calling `vkAllocateMemory` per
+// buffer, which is slow and limited by `maxMemoryAllocationCount`.
+//
+// Blocks are grouped into pools by memory type and pool type. Host visible blocks are mapped once on creation and
+// stay mapped, allocations from them provide their address in `Allocation::mappedData`. Since memory must not be
+// mapped twice, never call `vkMapMemory` on the memory of an allocation.
+//
+// All methods are thread safe. The arena has to be destroyed before the device.
+class DeviceMemoryArena
+{
+public:
+    enum class PoolType
+    {
+        // Bump allocation for long living resources. The space of freed allocations is only reused once all
+        // allocations of a block are freed.
+        Linear,
+        // First fit allocation with coalescing of freed ranges, for resources which come and go (e.g. staging
+        // buffers).
+        FreeList,
+        Count,
+    };
+
+    struct Allocation
+    {
+        VkDeviceMemory memory;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        // Address of `offset` if the memory is host visible, `nullptr` otherwise.
+        void* mappedData;
+        uint32_t memoryTypeIndex;
+        PoolType poolType;
+    };
+
+    struct Statistics
+    {
+        // Blocks and their total size, i.e. what has been allocated from the device.
+        size_t blockCount;
+        VkDeviceSize blockBytes;
+        // Live sub-allocations and their total size, excluding alignment padding.
+        size_t allocationCount;
+        VkDeviceSize usedBytes;
+        VkDeviceSize peakUsedBytes;
+    };
+
+    // Allocations which don't fit into `blockSize` get a block of their own.
+    DeviceMemoryArena(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize);
+    ~DeviceMemoryArena();
+
+    // NOTE(MM): Handed out allocations reference the blocks, so the arena must neither be copied nor moved.
+    DeviceMemoryArena(const DeviceMemoryArena&) = delete;
+    DeviceMemoryArena& operator=(const DeviceMemoryArena&) = delete;
+    DeviceMemoryArena(DeviceMemoryArena&&) noexcept = delete;
+    DeviceMemoryArena& operator=(DeviceMemoryArena&&) noexcept = delete;
+
+    // Allocate memory satisfying `requirements` from a memory type with (at least) `properties`.
+    std::optional<Allocation>
+    allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, PoolType poolType);
+
+    // Whether the device has any memory type with (at least) `properties`.
+    bool hasMemoryType(VkMemoryPropertyFlags properties) const;
+
+    // Return `allocation` to its pool. Freeing an allocation with `VK_NULL_HANDLE` memory does nothing.
+    void free(const Allocation& allocation);
+
+    Statistics getStatistics(PoolType poolType) const;
+    void printStatistics(void) const;
+
+private:
+    struct Block
+    {
+        VkDeviceMemory memory;
+        VkDeviceSize size;
+        void* mappedData;
+        size_t allocationCount;
+        // Linear pools: Begin of the unused space at the end of the block.
+        VkDeviceSize linearOffset;
+        // Free list pools: Free ranges as offset -> size, neighbouring ranges are always merged.
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+    };
+
+    struct Pool
+    {
+        std::vector<Block> blocks;
+        Statistics statistics;
+    };
+
+    std::optional<uint32_t> findMemoryType(uint32_t memoryTypeBits, VkMemoryPropertyFlags properties) const;
+    Block* createBlock(Pool& pool, uint32_t memoryTypeIndex, VkDeviceSize size);
+    Pool& getPool(uint32_t memoryTypeIndex, PoolType poolType);
+
+    VkDevice _device;
+    VkPhysicalDeviceMemoryProperties _memoryProperties;
+    VkDeviceSize _nonCoherentAtomSize;
+    VkDeviceSize _blockSize;
+
+    mutable std::mutex _mutex;
+    // Indexed by `memoryTypeIndex * PoolType::Count + poolType`.
+    std::vector<Pool> _pools;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_DEVICEMEMORYARENA_HPP
@@ -0,0 +1,416 @@
+#include "FrameRecorder.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <string>
+
+#include "PackedGrid.hpp"
+
+namespace VkHourglass
+{
+
+// NOTE(MM): Bump the version whenever the layout of delta streams changes. Like checkpoints, the headers are written in
+// host layout.
+static constexpr uint32_t DELTA_FILE_MAGIC = 0x53524748; // "HGRS"
+static constexpr uint32_t DELTA_FILE_VERSION = 1;
+
+struct DeltaFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t gridWidth;
+    uint32_t gridHeight;
+    uint64_t cellWordCount;
+};
+
+struct DeltaFrameHeader
+{
+    uint32_t generation;
+    uint32_t isKeyFrame;
+    uint64_t encodedWordCount;
+};
+
+static constexpr uint8_t AIR_PIXEL = 0;
+static constexpr uint8_t WALL_PIXEL = 128;
+static constexpr uint8_t SAND_PIXEL = 255;
+
+static size_t getExpectedCellWordCount(uint32_t gridWidth, uint32_t gridHeight)
+{
+    return static_cast<size_t>(gridWidth / PackedGrid::CELLS_PER_WORD) * gridHeight * 2;
+}
+
+// Encode the XOR of `cells` and `previousCells` as runs of unchanged and changed words, see `FrameRecorder::Format`.
+static void
+encodeDelta(const uint32_t* cells, const std::vector<uint32_t>& previousCells, std::vector<uint32_t>& encodedCells)
+{
+    encodedCells.clear();
+
+    const size_t count = previousCells.size();
+    size_t i = 0;
+    while (i < count)
+    {
+        const size_t unchangedBegin = i;
+        while (i < count && cells[i] == previousCells[i])
+        {
+            ++i;
+        }
+
+        // NOTE(MM): A single unchanged word is cheaper to store as part of the changed words than as a new run.
+        const size_t changedBegin = i;
+        while (i < count && (cells[i] != previousCells[i] || (i + 1 < count && cells[i + 1] != previousCells[i + 1])))
+        {
+            ++i;
+        }
+
+        encodedCells.push_back(static_cast<uint32_t>(changedBegin - unchangedBegin));
+        encodedCells.push_back(static_cast<uint32_t>(i - changedBegin));
+        for (size_t j = changedBegin; j < i; ++j)
+        {
+            encodedCells.push_back(cells[j] ^ previousCells[j]);
+        }
+    }
+}
+
+// Apply the runs of `encodedCells` to `cells`. Returns false if they don't match the size of `cells`.
+static bool decodeDelta(const std::vector<uint32_t>& encodedCells, std::vector<uint32_t>& cells)
+{
+    size_t position = 0;
+    size_t i = 0;
+    while (i + 2 <= encodedCells.size())
+    {
+        position += encodedCells[i];
+        const size_t changedCount = encodedCells[i + 1];
+        i += 2;
+
+        if (position + changedCount > cells.size() || i + changedCount > encodedCells.size())
+        {
+            return false;
+        }
+
+        for (size_t j = 0; j < changedCount; ++j)
+        {
+            cells[position + j] ^= encodedCells[i + j];
+        }
+        position += changedCount;
+        i += changedCount;
+    }
+
+    return i == encodedCells.size() && position == cells.size();
+}
+
+static void unpackToPixels(const uint32_t* cells, uint32_t gridWidth, uint32_t gridHeight, std::vector<uint8_t>& pixels)
+{
+    const size_t wordsPerRow = gridWidth / PackedGrid::CELLS_PER_WORD;
+    const size_t planeWordCount = wordsPerRow * gridHeight;
+    pixels.resize(static_cast<size_t>(gridWidth) * gridHeight);
+
+    for (size_t word = 0; word < planeWordCount; ++word)
+    {
+        const uint32_t sand = cells[word];
+        const uint32_t wall = cells[planeWordCount + word];
+        uint8_t* wordPixels = pixels.data() + word * PackedGrid::CELLS_PER_WORD;
+        for (uint32_t bit = 0; bit < PackedGrid::CELLS_PER_WORD; ++bit)
+        {
+            wordPixels[bit] = (wall >> bit) & 1u ? WALL_PIXEL : ((sand >> bit) & 1u ? SAND_PIXEL : AIR_PIXEL);
+        }
+    }
+}
+
+// Write the stream header of the image formats. Returns the number of written bytes.
+static size_t writeImageStreamHeader(std::ofstream& file, FrameRecorder::Format format, uint32_t width, uint32_t height)
+{
+    if (format != FrameRecorder::Format::Y4m)
+    {
+        return 0;
+    }
+
+    // NOTE(MM): The frame rate is just a playback default, it doesn't relate to the simulation speed.
+    const std::string header =
+        "YUV4MPEG2 W" + std::to_string(width) + " H" + std::to_string(height) + " F30:1 Ip A1:1 Cmono\n";
+    file << header;
+    return header.size();
+}
+
+// Write a frame of the image formats. Returns the number of written bytes.
+static size_t writeImageFrame(std::ofstream& file,
+                              FrameRecorder::Format format,
+                              uint32_t width,
+                              uint32_t height,
+                              const std::vector<uint8_t>& pixels)
+{
+    const std::string header = format == FrameRecorder::Format::Y4m
+                                   ? std::string("FRAME\n")
+                                   : "P5\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    file << header;
+    file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+    return header.size() + pixels.size();
+}
+
+FrameRecorder::FrameRecorder(const std::filesystem::path& filePath,
+                             Format format,
+                             const CellBufferLayout& slotLayout,
+                             const std::vector<const uint32_t*>& slots)
+    : _filePath(filePath)
+    , _format(format)
+    , _gridWidth(slotLayout.getGridWidth())
+    , _gridHeight(slotLayout.getGridHeight())
+    , _slotLayout(slotLayout)
+    , _slots(slots)
+    , _file(filePath, std::ios::binary | std::ios::trunc)
+    , _gridCells(slotLayout.isInterleaved() ? slotLayout.getGridWordCount() : 0)
+    , _previousCells(getExpectedCellWordCount(_gridWidth, _gridHeight), 0)
+    , _encodedCells()
+    , _pixels()
+    , _writtenFrameCount(0)
+    , _queue()
+    , _isSlotFree(slots.size(), true)
+    , _statistics({0, 0, 0})
+    , _isFinished(false)
+{
+    if (!_file)
+    {
+        fprintf(stderr, "Failed to create recording at path: %s\n", filePath.c_str());
+        _isFinished = true;
+        return;
+    }
+
+    if (_format == Format::Delta)
+    {
+        const DeltaFileHeader header{
+            DELTA_FILE_MAGIC, DELTA_FILE_VERSION, _gridWidth, _gridHeight, _previousCells.size()};
+        _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _statistics.writtenBytes += sizeof(header);
+    }
+    else
+    {
+        _statistics.writtenBytes += writeImageStreamHeader(_file, _format, _gridWidth, _gridHeight);
+    }
+
+    _writer = std::thread(&FrameRecorder::writerLoop, this);
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    finish();
+}
+
+FrameRecorder::operator bool() const
+{
+    return _writer.joinable();
+}
+
+size_t FrameRecorder::getSlotWordCount(void) const
+{
+    return _slotLayout.getWordCount();
+}
+
+std::optional<size_t> FrameRecorder::acquireSlot(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto slot = std::find(_isSlotFree.begin(), _isSlotFree.end(), true);
+    if (_isFinished || slot == _isSlotFree.end())
+    {
+        ++_statistics.droppedFrames;
+        return std::nullopt;
+    }
+
+    *slot = false;
+    return static_cast<size_t>(slot - _isSlotFree.begin());
+}
+
+void FrameRecorder::submitSlot(size_t slot, uint32_t generation, size_t cellBufferIndex)
+{
+    assert(slot < _slots.size() && !_isSlotFree[slot] && "FrameRecorder::submitSlot: Slot wasn't acquired!");
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_isFinished)
+        {
+            _isSlotFree[slot] = true;
+            ++_statistics.droppedFrames;
+            return;
+        }
+        _queue.push_back({slot, generation, cellBufferIndex});
+    }
+    _frameQueued.notify_one();
+}
+
+void FrameRecorder::finish(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isFinished = true;
+    }
+    _frameQueued.notify_one();
+
+    if (_writer.joinable())
+    {
+        _writer.join();
+        _file.close();
+    }
+}
+
+FrameRecorder::Statistics FrameRecorder::getStatistics(void) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+}
+
+void FrameRecorder::printStatistics(void) const
+{
+    const Statistics statistics = getStatistics();
+    printf("Recorded %llu frames to '%s' (%llu dropped), %.2f MiB (%.1f KiB per frame)\n",
+           static_cast<unsigned long long>(statistics.recordedFrames),
+           _filePath.c_str(),
+           static_cast<unsigned long long>(statistics.droppedFrames),
+           static_cast<double>(statistics.writtenBytes) / (1024.0 * 1024.0),
+           statistics.recordedFrames > 0
+               ? static_cast<double>(statistics.writtenBytes) / static_cast<double>(statistics.recordedFrames) / 1024.0
+               : 0.0);
+}
+
+void FrameRecorder::writerLoop(void)
+{
+    while (true)
+    {
+        QueuedFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _frameQueued.wait(lock, [this]() {
+                return !_queue.empty() || _isFinished;
+            });
+            // NOTE(MM): Frames queued before finishing are still written.
+            if (_queue.empty())
+            {
+                return;
+            }
+            frame = _queue.front();
+            _queue.pop_front();
+        }
+
+        // NOTE(MM): Frames are written in `PackedGrid` layout, independent of the cell buffer layout.
+        const uint32_t* cells = _slots[frame.slot];
+        if (_slotLayout.isInterleaved())
+        {
+            _slotLayout.unpack(frame.cellBufferIndex, cells, _gridCells.data());
+            cells = _gridCells.data();
+        }
+
+        const bool isWritten = writeFrame(cells, frame.generation);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isSlotFree[frame.slot] = true;
+        ++(isWritten ? _statistics.recordedFrames : _statistics.droppedFrames);
+    }
+}
+
+bool FrameRecorder::writeFrame(const uint32_t* cells, uint32_t generation)
+{
+    if (!_file)
+    {
+        return false;
+    }
+
+    size_t writtenBytes = 0;
+    if (_format == Format::Delta)
+    {
+        const bool isKeyFrame = _writtenFrameCount % DELTA_KEY_FRAME_INTERVAL == 0;
+        if (isKeyFrame)
+        {
+            std::fill(_previousCells.begin(), _previousCells.end(), 0);
+        }
+
+        encodeDelta(cells, _previousCells, _encodedCells);
+        std::copy_n(cells, _previousCells.size(), _previousCells.begin());
+
+        const DeltaFrameHeader header{generation, isKeyFrame, _encodedCells.size()};
+        _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _file.write(reinterpret_cast<const char*>(_encodedCells.data()),
+                    static_cast<std::streamsize>(_encodedCells.size() * sizeof(uint32_t)));
+        writtenBytes = sizeof(header) + _encodedCells.size() * sizeof(uint32_t);
+    }
+    else
+    {
+        unpackToPixels(cells, _gridWidth, _gridHeight, _pixels);
+        writtenBytes = writeImageFrame(_file, _format, _gridWidth, _gridHeight, _pixels);
+    }
+
+    if (!_file)
+    {
+        fprintf(stderr, "Failed to write recording to path: %s\n", _filePath.c_str());
+        return false;
+    }
+
+    ++_writtenFrameCount;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _statistics.writtenBytes += writtenBytes;
+    return true;
+}
+
+bool FrameRecorder::convertDeltaStream(const std::filesystem::path& inputPath,
+                                       const std::filesystem::path& outputPath,
+                                       Format outputFormat)
+{
+    assert(outputFormat != Format::Delta && "FrameRecorder::convertDeltaStream: Output has to be an image format!");
+
+    std::ifstream input(inputPath, std::ios::binary);
+    DeltaFileHeader fileHeader;
+    if (!input.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader)) || fileHeader.magic != DELTA_FILE_MAGIC
+        || fileHeader.version != DELTA_FILE_VERSION || fileHeader.gridWidth % PackedGrid::CELLS_PER_WORD != 0
+        || fileHeader.cellWordCount != getExpectedCellWordCount(fileHeader.gridWidth, fileHeader.gridHeight))
+    {
+        fprintf(stderr, "'%s' isn't a valid delta recording!\n", inputPath.c_str());
+        return false;
+    }
+
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    writeImageStreamHeader(output, outputFormat, fileHeader.gridWidth, fileHeader.gridHeight);
+
+    std::vector<uint32_t> cells(fileHeader.cellWordCount, 0);
+    std::vector<uint32_t> encodedCells;
+    std::vector<uint8_t> pixels;
+    size_t frameCount = 0;
+
+    DeltaFrameHeader frameHeader;
+    while (input.read(reinterpret_cast<char*>(&frameHeader), sizeof(frameHeader)))
+    {
+        // NOTE(MM): Even a fully changed grid doesn't need more than two words per changed word.
+        if (frameHeader.encodedWordCount > cells.size() * 2 + 2)
+        {
+            fprintf(stderr, "Frame %zu of '%s' is corrupted!\n", frameCount, inputPath.c_str());
+            return false;
+        }
+
+        encodedCells.resize(static_cast<size_t>(frameHeader.encodedWordCount));
+        input.read(reinterpret_cast<char*>(encodedCells.data()),
+                   static_cast<std::streamsize>(encodedCells.size() * sizeof(uint32_t)));
+        if (frameHeader.isKeyFrame)
+        {
+            std::fill(cells.begin(), cells.end(), 0);
+        }
+
+        if (!input || !decodeDelta(encodedCells, cells))
+        {
+            fprintf(stderr, "Frame %zu of '%s' is corrupted!\n", frameCount, inputPath.c_str());
+            return false;
+        }
+
+        unpackToPixels(cells.data(), fileHeader.gridWidth, fileHeader.gridHeight, pixels);
+        writeImageFrame(output, outputFormat, fileHeader.gridWidth, fileHeader.gridHeight, pixels);
+        ++frameCount;
+    }
+
+    output.close();
+    if (!output)
+    {
+        fprintf(stderr, "Failed to write '%s'!\n", outputPath.c_str());
+        return false;
+    }
+
+    printf("Converted %zu frames to '%s'\n", frameCount, outputPath.c_str());
+    return true;
+}
+
+} // namespace VkHourglass
@@ -0,0 +1,126 @@
+#ifndef VULKANHOURGLASS_FRAMERECORDER_HPP
+#define VULKANHOURGLASS_FRAMERECORDER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "CellBufferLayout.hpp"
+
+namespace VkHourglass
+{
+
+// Writes generations to a file on a background thread, reading them from a ring of host visible buffers ("slots")
+// the GPU copies the cell buffer to. The recorder only tracks which slots are in use, copying is up to the caller:
+// `acquireSlot()`, record the copy, wait for its submission to finish and pass the slot to `submitSlot()`. If all
+// slots are in use (the writer falls behind), `acquireSlot()` fails and the frame is dropped instead of stalling the
+// caller. Slots hold the cells in the layout of the cell buffer they were copied from, see CellBufferLayout.hpp.
+//
+// Formats:
+// - `Delta`: Compact stream for analysis. Each frame stores its generation and the XOR of its cells (in the layout of
+//   `PackedGrid::getData()`) with the previous frame, run length encoded as pairs of (unchanged word count, changed
+//   word count) followed by the changed words. Since only falling grains change, most words are unchanged. Every
+//   `DELTA_KEY_FRAME_INTERVAL`th frame is a key frame, encoded against an empty grid. See `convertDeltaStream()`.
+// - `Y4m`: Uncompressed monochrome video (one byte per cell: air 0, wall 128, sand 255), readable by e.g. ffmpeg.
+// - `Pgm`: The same images as a sequence of binary PGM images in a single file.
+class FrameRecorder
+{
+public:
+    enum class Format
+    {
+        Delta,
+        Y4m,
+        Pgm,
+    };
+
+    static constexpr uint32_t DELTA_KEY_FRAME_INTERVAL = 256;
+
+    struct Statistics
+    {
+        uint64_t recordedFrames;
+        uint64_t droppedFrames;
+        uint64_t writtenBytes;
+    };
+
+    // `slots` point to host memory of `getSlotWordCount()` words each, which has to stay valid as long as the recorder
+    // exists. Check with `operator bool()` if the file could be created.
+    FrameRecorder(const std::filesystem::path& filePath,
+                  Format format,
+                  const CellBufferLayout& slotLayout,
+                  const std::vector<const uint32_t*>& slots);
+    ~FrameRecorder();
+
+    // NOTE(MM): The writer thread references the recorder, so it must neither be copied nor moved.
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+    FrameRecorder(FrameRecorder&&) noexcept = delete;
+    FrameRecorder& operator=(FrameRecorder&&) noexcept = delete;
+
+    explicit operator bool() const;
+
+    size_t getSlotWordCount(void) const;
+
+    // Returns a free slot, or `std::nullopt` if all slots are in use (counted as dropped frame).
+    std::optional<size_t> acquireSlot(void);
+    // Queue the cells in `slot` (fully written, copied from cell buffer `cellBufferIndex`) for writing. The slot is
+    // free again once they are written.
+    void submitSlot(size_t slot, uint32_t generation, size_t cellBufferIndex);
+
+    // Write all queued frames and stop the writer thread. Called by the destructor, further submissions are ignored.
+    void finish(void);
+
+    Statistics getStatistics(void) const;
+    void printStatistics(void) const;
+
+    // Convert a `Delta` stream to `outputFormat` (`Y4m` or `Pgm`).
+    static bool convertDeltaStream(const std::filesystem::path& inputPath,
+                                   const std::filesystem::path& outputPath,
+                                   Format outputFormat);
+
+private:
+    struct QueuedFrame
+    {
+        size_t slot;
+        uint32_t generation;
+        size_t cellBufferIndex;
+    };
+
+    void writerLoop(void);
+    bool writeFrame(const uint32_t* cells, uint32_t generation);
+
+    const std::filesystem::path _filePath;
+    const Format _format;
+    const uint32_t _gridWidth;
+    const uint32_t _gridHeight;
+    const CellBufferLayout _slotLayout;
+    const std::vector<const uint32_t*> _slots;
+
+    // Only accessed by the writer thread (after construction).
+    std::ofstream _file;
+    // Cells of the written frame in `PackedGrid` layout, only used for interleaved slots.
+    std::vector<uint32_t> _gridCells;
+    std::vector<uint32_t> _previousCells;
+    std::vector<uint32_t> _encodedCells;
+    std::vector<uint8_t> _pixels;
+    uint64_t _writtenFrameCount;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _frameQueued;
+    std::deque<QueuedFrame> _queue;
+    std::vector<bool> _isSlotFree;
+    Statistics _statistics;
+    bool _isFinished;
+
+    std::thread _writer;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_FRAMERECORDER_HPP
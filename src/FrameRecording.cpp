@@ -0,0 +1,98 @@
+#include "FrameRecording.hpp"
+
+#include <algorithm>
+
+#include "FrameRecorder.hpp"
+#include "GpuCommands.hpp"
+#include "VulkanContext.hpp"
+
+namespace VkHourglass
+{
+
+FrameRecording::FrameRecording(FrameRecorder* recorder, uint32_t interval, uint32_t generation, size_t frameCount)
+    : _recorder(recorder)
+    , _interval(interval)
+    , _lastGeneration(generation)
+    , _pendingCopies(frameCount)
+{
+}
+
+uint32_t FrameRecording::getGenerationsUntilNext(uint32_t generation) const
+{
+    return _interval - (generation - _lastGeneration);
+}
+
+void FrameRecording::recordCopy(const VulkanContext& context,
+                                VkCommandBuffer commandBuffer,
+                                size_t currentFrame,
+                                size_t currentGridBuffer,
+                                uint32_t generation)
+{
+    // NOTE(MM): Unsigned arithmetic keeps this valid when the generation counter wraps around.
+    if (!_recorder || generation - _lastGeneration < _interval)
+    {
+        return;
+    }
+    // Dropped generations count as recorded, so that the interval stays regular.
+    _lastGeneration = generation;
+
+    const std::optional<size_t> slotOpt = _recorder->acquireSlot();
+    if (!slotOpt.has_value())
+    {
+        return;
+    }
+
+    // NOTE(MM): Makes the copy available to the host, it becomes visible by waiting for the fence of the frame.
+    GpuCommands::recordCellBufferCopy(context,
+                                      commandBuffer,
+                                      currentGridBuffer,
+                                      context.recordingBuffers[slotOpt.value()],
+                                      VK_PIPELINE_STAGE_HOST_BIT,
+                                      VK_ACCESS_HOST_READ_BIT);
+
+    _pendingCopies[currentFrame] = PendingCopy{slotOpt.value(), generation, currentGridBuffer};
+}
+
+void FrameRecording::submitPending(size_t currentFrame)
+{
+    std::optional<PendingCopy>& pendingCopy = _pendingCopies[currentFrame];
+    if (pendingCopy.has_value())
+    {
+        _recorder->submitSlot(pendingCopy->slot, pendingCopy->generation, pendingCopy->cellBufferIndex);
+        pendingCopy.reset();
+    }
+}
+
+void FrameRecording::finish(bool printStatistics)
+{
+    if (!_recorder)
+    {
+        return;
+    }
+
+    // NOTE(MM): The frames in flight are submitted oldest first, i.e. ordered by their distance to the last recorded
+    // generation.
+    std::vector<size_t> pendingFrames;
+    for (size_t i = 0; i < _pendingCopies.size(); ++i)
+    {
+        if (_pendingCopies[i].has_value())
+        {
+            pendingFrames.push_back(i);
+        }
+    }
+    std::sort(pendingFrames.begin(), pendingFrames.end(), [this](size_t a, size_t b) {
+        return _lastGeneration - _pendingCopies[a]->generation > _lastGeneration - _pendingCopies[b]->generation;
+    });
+    for (const size_t frame : pendingFrames)
+    {
+        submitPending(frame);
+    }
+
+    _recorder->finish();
+    if (printStatistics)
+    {
+        _recorder->printStatistics();
+    }
+}
+
+} // namespace VkHourglass
@@ -0,0 +1,63 @@
+#ifndef VULKANHOURGLASS_FRAMERECORDING_HPP
+#define VULKANHOURGLASS_FRAMERECORDING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+namespace VkHourglass
+{
+
+class FrameRecorder;
+class VulkanContext;
+
+// Recording without stalling the frame loop, works like `CheckpointWriter`: The command buffer of a frame copies the
+// latest cells to a recording buffer acquired from the recorder (see `recordCopy()`). Once the fence of the frame is
+// waited for the next time, the buffer is handed to the writer thread of the recorder (see `submitPending()`).
+//
+// "Frames" are the command buffers used round robin by the caller, i.e. also headless or async compute submissions.
+class FrameRecording
+{
+public:
+    // Without `recorder`, nothing is recorded. Every `interval`th generation is recorded, counting from `generation`
+    // (the one the run starts at). `frameCount` is the number of command buffers used round robin.
+    FrameRecording(FrameRecorder* recorder, uint32_t interval, uint32_t generation, size_t frameCount);
+
+    bool isRecording(void) const { return _recorder != nullptr; }
+    // Generations from `generation` to the next recorded one, expects `isRecording()`.
+    uint32_t getGenerationsUntilNext(uint32_t generation) const;
+
+    // Copies the cells to a free recording buffer at the end of `commandBuffer` if a recording is due. Drops the
+    // generation if the writer thread falls behind.
+    void recordCopy(const VulkanContext& context,
+                    VkCommandBuffer commandBuffer,
+                    size_t currentFrame,
+                    size_t currentGridBuffer,
+                    uint32_t generation);
+    // Hands the recording buffer copied to by `currentFrame` to the writer thread, expects the fence of the frame to be
+    // signaled.
+    void submitPending(size_t currentFrame);
+    // Writes the remaining recorded generations, expects the device to be idle.
+    void finish(bool printStatistics);
+
+private:
+    struct PendingCopy
+    {
+        size_t slot;
+        uint32_t generation;
+        size_t cellBufferIndex;
+    };
+
+    FrameRecorder* const _recorder;
+    const uint32_t _interval;
+    uint32_t _lastGeneration;
+    // Recording buffer copied to by each frame.
+    std::vector<std::optional<PendingCopy>> _pendingCopies;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_FRAMERECORDING_HPP
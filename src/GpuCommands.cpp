@@ -0,0 +1,166 @@
+#include "GpuCommands.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+#include "Macros.hpp"
+#include "PushConstants.hpp"
+#include "VulkanContext.hpp"
+
+namespace VkHourglass::GpuCommands
+{
+
+// NOTE(MM): Expects the cell update pipeline to be bound and its push constants to be set, the list building pipeline
+// shares them.
+static void recordActiveTilesUpdate(const VulkanContext& context, const VkCommandBuffer commandBuffer)
+{
+    // The cell update has to be done reading the dispatch arguments and writing the tile generations before the list
+    // is reset and rebuilt.
+    addGlobalMemoryBarrier(commandBuffer,
+                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT);
+
+    vkCmdFillBuffer(commandBuffer, context.activeTilesBuffer, 0, sizeof(uint32_t), 0);
+    addGlobalMemoryBarrier(commandBuffer,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_ACCESS_TRANSFER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, context.computePipeline.activeTilesPipeline);
+    vkCmdDispatch(commandBuffer, context.configuration.getActiveTilesDispatchCount(), 1, 1);
+
+    addGlobalMemoryBarrier(commandBuffer,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT
+                               | VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+static void addMemoryBarrier(const VkCommandBuffer commandBuffer,
+                             VkBuffer writtenBuffer,
+                             VkPipelineStageFlags dstStageMask)
+{
+    // NOTE(MM): When stepping in place, the next dispatch also writes (atomically) to the buffer just written.
+    VkBufferMemoryBarrier bufferMemoryBarrier{};
+    bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    bufferMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    bufferMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    // NOTE(MM): No queue family ownership transfer, which buffers shared with async compute don't allow anyway.
+    bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferMemoryBarrier.buffer = writtenBuffer;
+    bufferMemoryBarrier.offset = 0;
+    bufferMemoryBarrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         dstStageMask,
+                         VK_DEPENDENCY_DEVICE_GROUP_BIT,
+                         0,
+                         nullptr,
+                         1,
+                         &bufferMemoryBarrier,
+                         0,
+                         nullptr);
+}
+
+bool beginCommandBuffer(const VkCommandBuffer commandBuffer)
+{
+    VkCommandBufferBeginInfo commandBufferBeginInfo{};
+    commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    VK_RETURN_ON_ERROR_V(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo), false);
+
+    return true;
+}
+
+size_t recordComputeCommands(const VulkanContext& context,
+                             const VkCommandBuffer commandBuffer,
+                             size_t currentBuffer,
+                             uint32_t& generation,
+                             uint32_t seed,
+                             size_t stepCount,
+                             VkPipelineStageFlags finalDstStageMask)
+{
+    const VulkanContext::ComputePipeline& computePipeline = context.computePipeline;
+    const VkPipelineLayout pipelineLayout = computePipeline.pipelineLayout;
+    const size_t temporalSteps = context.configuration.temporalSteps;
+    assert(stepCount % temporalSteps == 0 && "Step count has to be a multiple of the temporal steps!");
+
+    for (size_t i = 0; i < stepCount; i += temporalSteps)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline.pipeline);
+        vkCmdBindDescriptorSets(commandBuffer,
+                                VK_PIPELINE_BIND_POINT_COMPUTE,
+                                pipelineLayout,
+                                0,
+                                1,
+                                &computePipeline.descriptorSets[currentBuffer],
+                                0,
+                                0);
+
+        generation += static_cast<uint32_t>(temporalSteps);
+        const PushConstants pushConstants{static_cast<uint32_t>(currentBuffer), seed, generation};
+        vkCmdPushConstants(
+            commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+
+        vkCmdDispatchIndirect(commandBuffer, context.activeTilesBuffer, 0);
+        recordActiveTilesUpdate(context, commandBuffer);
+
+        // NOTE(MM): Temporal steps are odd, so the buffers swap once per dispatch like for single steps.
+        const bool isLastStep = i + temporalSteps == stepCount;
+        const VkPipelineStageFlags dstStageMask =
+            isLastStep ? finalDstStageMask : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        addMemoryBarrier(commandBuffer, context.getCellBuffer(!currentBuffer), dstStageMask);
+
+        currentBuffer = !currentBuffer;
+    }
+
+    return currentBuffer;
+}
+
+void addGlobalMemoryBarrier(const VkCommandBuffer commandBuffer,
+                            VkPipelineStageFlags srcStageMask,
+                            VkAccessFlags srcAccessMask,
+                            VkPipelineStageFlags dstStageMask,
+                            VkAccessFlags dstAccessMask)
+{
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = srcAccessMask;
+    memoryBarrier.dstAccessMask = dstAccessMask;
+
+    vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+// NOTE(MM): The copy also has to finish reading before later dispatches overwrite the cell buffer, which may happen in
+// the same command buffer or in the next submission while this one is still in flight. None of the other barriers wait
+// for the transfer stage, hence the compute shader stage is always part of the final barrier.
+void recordCellBufferCopy(const VulkanContext& context,
+                          VkCommandBuffer commandBuffer,
+                          size_t cellBufferIndex,
+                          VkBuffer dstBuffer,
+                          VkPipelineStageFlags dstStageMask,
+                          VkAccessFlags dstAccessMask)
+{
+    addGlobalMemoryBarrier(commandBuffer,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           VK_ACCESS_SHADER_WRITE_BIT,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_ACCESS_TRANSFER_READ_BIT);
+
+    VkBufferCopy copyRegion{};
+    copyRegion.size = context.configuration.getCellBufferWordCount() * sizeof(uint32_t);
+    vkCmdCopyBuffer(commandBuffer, context.getCellBuffer(cellBufferIndex), dstBuffer, 1, &copyRegion);
+
+    addGlobalMemoryBarrier(commandBuffer,
+                           VK_PIPELINE_STAGE_TRANSFER_BIT,
+                           VK_ACCESS_TRANSFER_WRITE_BIT,
+                           dstStageMask | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                           dstAccessMask);
+}
+
+} // namespace VkHourglass::GpuCommands
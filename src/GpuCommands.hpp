@@ -0,0 +1,52 @@
+#ifndef VULKANHOURGLASS_GPUCOMMANDS_HPP
+#define VULKANHOURGLASS_GPUCOMMANDS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vulkan/vulkan_core.h>
+
+namespace VkHourglass
+{
+class VulkanContext;
+}
+
+// Commands shared by the frame loop, the headless loop, checkpoints and recording.
+namespace VkHourglass::GpuCommands
+{
+
+bool beginCommandBuffer(const VkCommandBuffer commandBuffer);
+
+// Records `stepCount` generations, swapping in/out buffers after each dispatch (when stepping in place, only the
+// partition offset alternates, see `VulkanContext::getCellBuffer()`). With temporal blocking, a dispatch computes
+// `Configuration::temporalSteps` generations, so `stepCount` has to be a multiple of them. Dispatches are separated
+// by compute-to-compute barriers; the final barrier makes the last generation visible to `finalDstStageMask`. Only the
+// active tiles are dispatched (see 'shaders/tiles.comp'), the list of them is rebuilt after each dispatch.
+// Returns the index of the buffer holding the last generation and advances `generation` by `stepCount`.
+size_t recordComputeCommands(const VulkanContext& context,
+                             const VkCommandBuffer commandBuffer,
+                             size_t currentBuffer,
+                             uint32_t& generation,
+                             uint32_t seed,
+                             size_t stepCount,
+                             VkPipelineStageFlags finalDstStageMask);
+
+void addGlobalMemoryBarrier(const VkCommandBuffer commandBuffer,
+                            VkPipelineStageFlags srcStageMask,
+                            VkAccessFlags srcAccessMask,
+                            VkPipelineStageFlags dstStageMask,
+                            VkAccessFlags dstAccessMask);
+
+// Copies cell buffer `cellBufferIndex` to `dstBuffer` after the preceding dispatches and makes the copy available to
+// `dstStageMask`/`dstAccessMask`. Later dispatches (in this or a later submission) only overwrite the cell buffer once
+// the copy is done reading it.
+void recordCellBufferCopy(const VulkanContext& context,
+                          VkCommandBuffer commandBuffer,
+                          size_t cellBufferIndex,
+                          VkBuffer dstBuffer,
+                          VkPipelineStageFlags dstStageMask,
+                          VkAccessFlags dstAccessMask);
+
+} // namespace VkHourglass::GpuCommands
+
+#endif // VULKANHOURGLASS_GPUCOMMANDS_HPP
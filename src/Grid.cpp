@@ -1,7 +1,6 @@
 #include "Grid.hpp"
 
 #include <algorithm>
-#include <cstring>
 #include <ctime>
 #include <limits>
 #include <random>
@@ -12,110 +11,76 @@ namespace VkHourglass
 {
 using namespace ApplicationDefines;
 
-static constexpr int32_t AIR_VALUE = 0;
-static constexpr int32_t SAND_VALUE = 1;
-static constexpr int32_t WALL_VALUE = 2;
-
-static_assert(GRID_WIDTH >= 2 && GRID_HEIGHT >= 2);
-// NOTE(MM): using uint32_t throughout application that holds 'GRID_SIZE * sizeof(uint32_t)'
-static_assert(NonModifiable::GRID_SIZE < (std::numeric_limits<uint32_t>::max() / sizeof(uint32_t)));
-static_assert(GRID_WIDTH < std::numeric_limits<int32_t>::max());
-static_assert(GRID_HEIGHT < std::numeric_limits<int32_t>::max());
-static_assert(GRID_WIDTH >= GenerateHourglass::HOURGLASS_WIDTH + GenerateHourglass::HOURGLASS_BORDER_WIDTH);
-static_assert(GRID_HEIGHT >= GenerateHourglass::HOURGLASS_HEIGHT + GenerateHourglass::HOURGLASS_BORDER_WIDTH);
-static_assert(GenerateHourglass::HOURGLASS_CENTER_WIDTH >= 2);
-static_assert(GRID_WIDTH >= GenerateHourglass::HOURGLASS_CENTER_WIDTH + GenerateHourglass::HOURGLASS_BORDER_WIDTH);
-static_assert(GRID_WIDTH % 2 == 0 && GenerateHourglass::HOURGLASS_WIDTH % 2 == 0);
-static_assert(GRID_HEIGHT % 2 == 0 && GenerateHourglass::HOURGLASS_HEIGHT % 2 == 0);
-static_assert((NonModifiable::GRID_SIZE / NonModifiable::ELEMENTS_PER_CELL) % COMPUTE_LOCAL_GROUP_SIZE_X == 0);
-static_assert(GenerateCenterCircle::RADIUS < std::numeric_limits<int32_t>::max());
-static_assert(GenerateRandomCircles::MIN_RADIUS < std::numeric_limits<int32_t>::max());
-static_assert(GenerateRandomCircles::MAX_RADIUS < std::numeric_limits<int32_t>::max());
-
-// NOTE(MM): Due to double-buffering and margolus neighborhood, sand can't be in the first row, as well as in the first
-// column of the second and third row. Sand there would infinitely spawn new grains of sand, as they are only updated
-// every 2nd iteration.
-static void fixGridEdgeCases(std::vector<uint32_t>& grid)
-{
-    memset(grid.data(), 0, sizeof(uint32_t) * GRID_WIDTH);
-    grid[GRID_WIDTH] = 0;
+// NOTE(MM): Constraints of the runtime settings are checked by 'validateConfiguration()'.
+static_assert(COMPUTE_STEPS_PER_FRAME >= 1 && HEADLESS_STEPS_PER_SUBMIT >= 1);
+static_assert(MAX_FRAMES_IN_FLIGHT >= 1);
 
-    if (GRID_HEIGHT > 2)
-    {
-        grid[GRID_WIDTH * 2] = 0;
-    }
-}
-
-std::vector<uint32_t> generateHourglass(void)
+PackedGrid generateHourglass(const Configuration& configuration)
 {
-    constexpr uint32_t startRow = (GRID_HEIGHT - GenerateHourglass::HOURGLASS_HEIGHT) / 2;
-    constexpr uint32_t endRow = startRow + GenerateHourglass::HOURGLASS_HEIGHT;
-    constexpr uint32_t halfHourglassHeight = GenerateHourglass::HOURGLASS_HEIGHT / 2;
-    constexpr uint32_t upperCenterRow = startRow + halfHourglassHeight;
-    constexpr uint32_t lowerCenterRow = upperCenterRow + 1u;
+    const Configuration::Hourglass& hourglass = configuration.hourglass;
+
+    const uint32_t startRow = (configuration.gridHeight - hourglass.height) / 2;
+    const uint32_t endRow = startRow + hourglass.height;
+    const uint32_t halfHourglassHeight = hourglass.height / 2;
+    const uint32_t upperCenterRow = startRow + halfHourglassHeight;
+    const uint32_t lowerCenterRow = upperCenterRow + 1u;
 
-    constexpr uint32_t startColumn = (GRID_WIDTH - GenerateHourglass::HOURGLASS_WIDTH) / 2;
-    constexpr uint32_t halfHourglassWidth = GenerateHourglass::HOURGLASS_WIDTH / 2;
-    constexpr uint32_t leftCenterColumn = startColumn + halfHourglassWidth;
-    constexpr uint32_t rightCenterColumn = leftCenterColumn + 1u;
+    const uint32_t startColumn = (configuration.gridWidth - hourglass.width) / 2;
+    const uint32_t halfHourglassWidth = hourglass.width / 2;
+    const uint32_t leftCenterColumn = startColumn + halfHourglassWidth;
+    const uint32_t rightCenterColumn = leftCenterColumn + 1u;
 
-    std::vector<uint32_t> grid(NonModifiable::GRID_SIZE, AIR_VALUE);
+    PackedGrid grid(configuration.gridWidth, configuration.gridHeight);
 
     // NOTE(MM): "Drawing" the hourglass from the center to top and bottom in lock-step (each iteration goes up and down
-    // one row). The width at the center of the hourglass corresponds to the defined
-    // GenerateHourglass::HOURGLASS_CENTER_WIDTH and will be increased to the full size with each row. Seemed to be the
-    // most concise way to approach this.
-    uint32_t currentWidth = GenerateHourglass::HOURGLASS_CENTER_WIDTH;
+    // one row). The width at the center of the hourglass corresponds to the configured center width and will be
+    // increased to the full size with each row. Seemed to be the most concise way to approach this.
+    uint32_t currentWidth = hourglass.centerWidth;
     for (uint32_t yUp = upperCenterRow + 1, yDown = lowerCenterRow; yUp-- > startRow && yDown < endRow; ++yDown)
     {
         const uint32_t currentHalfWidth = currentWidth / 2;
 
         const uint32_t leftBorderEnd = leftCenterColumn - currentHalfWidth;
-        const uint32_t leftBorderBegin = leftBorderEnd - GenerateHourglass::HOURGLASS_BORDER_WIDTH;
+        const uint32_t leftBorderBegin = leftBorderEnd - hourglass.borderWidth;
 
         const uint32_t rightBorderBegin = rightCenterColumn + currentHalfWidth;
-        const uint32_t rightBorderEnd = rightBorderBegin + GenerateHourglass::HOURGLASS_BORDER_WIDTH;
+        const uint32_t rightBorderEnd = rightBorderBegin + hourglass.borderWidth;
 
-        const bool isTop = yUp <= startRow + GenerateHourglass::HOURGLASS_BORDER_WIDTH;
+        const bool isTop = yUp <= startRow + hourglass.borderWidth;
         const bool isFilled =
-            yUp <= static_cast<uint32_t>(startRow + halfHourglassHeight * GenerateHourglass::HOURGLASS_FILL_PERCENTAGE);
-        const bool isBottom = yDown >= endRow - GenerateHourglass::HOURGLASS_BORDER_WIDTH;
+            yUp <= static_cast<uint32_t>(static_cast<float>(startRow)
+                                         + static_cast<float>(halfHourglassHeight) * hourglass.fillPercentage);
+        const bool isBottom = yDown >= endRow - hourglass.borderWidth;
 
         for (uint32_t x = leftBorderBegin; x <= rightBorderEnd; ++x)
         {
-            const uint32_t idxUp = x + GRID_WIDTH * yUp;
-            const uint32_t idxDown = x + GRID_WIDTH * yDown;
-
             const bool isBorder = isTop || isBottom || x < leftBorderEnd || x > rightBorderBegin;
             if (isBorder)
             {
-                grid[idxUp] = grid[idxDown] = WALL_VALUE;
+                grid.setCell(x, yUp, WALL_VALUE);
+                grid.setCell(x, yDown, WALL_VALUE);
             }
             else
             {
-                grid[idxUp] = isFilled ? SAND_VALUE : AIR_VALUE;
-                grid[idxDown] = AIR_VALUE;
+                grid.setCell(x, yUp, isFilled ? SAND_VALUE : AIR_VALUE);
+                grid.setCell(x, yDown, AIR_VALUE);
             }
         }
 
-        currentWidth = std::min(currentWidth + 1u, GenerateHourglass::HOURGLASS_WIDTH);
-    }
-
-    if (GenerateHourglass::HOURGLASS_BORDER_WIDTH == 0)
-    {
-        fixGridEdgeCases(grid);
+        currentWidth = std::min(currentWidth + 1u, hourglass.width);
     }
 
     return grid;
 }
 
-static void generateCircle(int32_t centerX, int32_t centerY, int32_t radius, std::vector<uint32_t>& grid)
+static void generateCircle(int32_t centerX, int32_t centerY, int32_t radius, PackedGrid& grid)
 {
     for (int y = centerY - radius; y <= centerY + radius; ++y)
     {
         for (int x = centerX - radius; x <= centerX + radius; ++x)
         {
-            if (x < 0 || x >= static_cast<int32_t>(GRID_WIDTH) || y < 0 || y >= static_cast<int32_t>(GRID_HEIGHT))
+            if (x < 0 || x >= static_cast<int32_t>(grid.getWidth()) || y < 0
+                || y >= static_cast<int32_t>(grid.getHeight()))
             {
                 continue;
             }
@@ -125,39 +90,36 @@ static void generateCircle(int32_t centerX, int32_t centerY, int32_t radius, std
 
             if (dy * dy + dx * dx < radius * radius)
             {
-                // NOTE(MM): No need to bound check here, as idx is in range:
-                // [0, (GRID_HEIGHT - 1) * GRID_WIDTH + (GRID_WIDTH - 1) ]
-                uint32_t idx = static_cast<uint32_t>(y) * GRID_WIDTH + static_cast<uint32_t>(x);
-                grid[idx] = SAND_VALUE;
+                grid.setCell(static_cast<uint32_t>(x), static_cast<uint32_t>(y), SAND_VALUE);
             }
         }
     }
 }
 
-std::vector<uint32_t> generateCenterCircle(void)
+PackedGrid generateCenterCircle(const Configuration& configuration)
 {
-    std::vector<uint32_t> grid(NonModifiable::GRID_SIZE, AIR_VALUE);
-
-    const int32_t centerX = GRID_WIDTH / 2;
-    const int32_t centerY = GRID_HEIGHT / 2;
+    PackedGrid grid(configuration.gridWidth, configuration.gridHeight);
 
-    generateCircle(centerX, centerY, GenerateCenterCircle::RADIUS, grid);
+    const auto centerX = static_cast<int32_t>(configuration.gridWidth / 2);
+    const auto centerY = static_cast<int32_t>(configuration.gridHeight / 2);
 
-    fixGridEdgeCases(grid);
+    generateCircle(centerX, centerY, static_cast<int32_t>(configuration.centerCircle.radius), grid);
     return grid;
 }
 
-std::vector<uint32_t> generateRandomCircles(void)
+PackedGrid generateRandomCircles(const Configuration& configuration)
 {
-    std::vector<uint32_t> grid(NonModifiable::GRID_SIZE, AIR_VALUE);
+    const Configuration::RandomCircles& randomCircles = configuration.randomCircles;
+
+    PackedGrid grid(configuration.gridWidth, configuration.gridHeight);
 
     std::default_random_engine rndEngine((unsigned)time(nullptr));
-    std::uniform_int_distribution<int32_t> radiusDist(GenerateRandomCircles::MIN_RADIUS,
-                                                      GenerateRandomCircles::MAX_RADIUS);
-    std::uniform_int_distribution<int32_t> xDist(0, GRID_WIDTH);
-    std::uniform_int_distribution<int32_t> yDist(0, GRID_HEIGHT);
+    std::uniform_int_distribution<int32_t> radiusDist(static_cast<int32_t>(randomCircles.minRadius),
+                                                      static_cast<int32_t>(randomCircles.maxRadius));
+    std::uniform_int_distribution<int32_t> xDist(0, static_cast<int32_t>(configuration.gridWidth));
+    std::uniform_int_distribution<int32_t> yDist(0, static_cast<int32_t>(configuration.gridHeight));
 
-    for (size_t i = 0; i < GenerateRandomCircles::CIRCLE_COUNT; ++i)
+    for (size_t i = 0; i < randomCircles.circleCount; ++i)
     {
         const int32_t centerX = xDist(rndEngine);
         const int32_t centerY = yDist(rndEngine);
@@ -165,26 +127,24 @@ std::vector<uint32_t> generateRandomCircles(void)
 
         generateCircle(centerX, centerY, radius, grid);
     }
-
-    fixGridEdgeCases(grid);
     return grid;
 }
 
-std::vector<uint32_t> generateRandomNoise(void)
+PackedGrid generateRandomNoise(const Configuration& configuration)
 {
     std::default_random_engine rndEngine((unsigned)time(nullptr));
     std::uniform_real_distribution<float> rndDist(0.0f, 1.0f);
 
-    std::vector<uint32_t> grid(NonModifiable::GRID_SIZE, AIR_VALUE);
+    const uint32_t gridWidth = configuration.gridWidth;
+    const uint32_t gridSize = configuration.getGridSize();
+    PackedGrid grid(gridWidth, configuration.gridHeight);
 
-    for (size_t i = 0; i < GenerateRandom::PARTICLE_COUNT; ++i)
+    for (size_t i = 0; i < configuration.randomNoise.particleCount; ++i)
     {
-        size_t idx = static_cast<size_t>(NonModifiable::GRID_SIZE * rndDist(rndEngine));
-        idx = idx % grid.size(); // NOTE(MM): in case random value would be 1.0f
-        grid[idx] = SAND_VALUE;
+        size_t idx = static_cast<size_t>(static_cast<float>(gridSize) * rndDist(rndEngine));
+        idx = idx % gridSize; // NOTE(MM): in case random value would be 1.0f
+        grid.setCell(static_cast<uint32_t>(idx % gridWidth), static_cast<uint32_t>(idx / gridWidth), SAND_VALUE);
     }
-
-    fixGridEdgeCases(grid);
     return grid;
 }
 
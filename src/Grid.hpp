@@ -1,16 +1,17 @@
 #ifndef VULKANHOURGLASS_GRID_HPP
 #define VULKANHOURGLASS_GRID_HPP
 
-#include <cstdint>
-#include <vector>
+#include "Configuration.hpp"
+#include "PackedGrid.hpp"
 
 namespace VkHourglass
 {
 
-std::vector<uint32_t> generateHourglass(void);
-std::vector<uint32_t> generateCenterCircle(void);
-std::vector<uint32_t> generateRandomCircles(void);
-std::vector<uint32_t> generateRandomNoise(void);
+// NOTE(MM): All generators expect a validated configuration, see `validateConfiguration()`.
+PackedGrid generateHourglass(const Configuration& configuration);
+PackedGrid generateCenterCircle(const Configuration& configuration);
+PackedGrid generateRandomCircles(const Configuration& configuration);
+PackedGrid generateRandomNoise(const Configuration& configuration);
 
 } // namespace VkHourglass
 
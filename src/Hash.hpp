@@ -0,0 +1,45 @@
+#ifndef VULKANHOURGLASS_HASH_HPP
+#define VULKANHOURGLASS_HASH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace VkHourglass
+{
+
+// NOTE(MM): Constants of Philox2x32-10, see 'shaders/hash.comp'.
+constexpr uint32_t PHILOX_MULTIPLIER = 0xD256D193U;
+constexpr uint32_t PHILOX_KEY_INCREMENT = 0x9E3779B9U;
+constexpr uint32_t PHILOX_ROUND_COUNT = 10;
+
+// NOTE(MM): CPU port of 'getBlockRandom' in 'shaders/hash.comp'. Output will be in range [0, 2^31). Only integer
+// arithmetic, so the result is meant to be bit identical to the shader version. Verified against the Random123
+// known-answer vectors, but not yet against the shader, which is what 'make check-gpu' is for.
+inline uint32_t getBlockRandom(uint32_t seed, uint32_t generation, uint32_t blockIdx)
+{
+    uint32_t counter0 = blockIdx;
+    uint32_t counter1 = generation;
+    uint32_t key = seed;
+    for (uint32_t i = 0; i < PHILOX_ROUND_COUNT; ++i)
+    {
+        const uint64_t product = static_cast<uint64_t>(PHILOX_MULTIPLIER) * counter0;
+        counter0 = static_cast<uint32_t>(product >> 32) ^ key ^ counter1;
+        counter1 = static_cast<uint32_t>(product);
+        key += PHILOX_KEY_INCREMENT;
+    }
+
+    return counter0 >> 1;
+}
+
+// Sand gets stuck if `getBlockRandom() < getStuckThreshold(stuckProbability)`. The threshold is the probability scaled
+// by 2^31, so that a probability of 0 never and 1 always gets stuck.
+inline uint32_t getStuckThreshold(float stuckProbability)
+{
+    const double probability = std::clamp(static_cast<double>(stuckProbability), 0.0, 1.0);
+    return static_cast<uint32_t>(std::llround(probability * 2147483648.0));
+}
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_HASH_HPP
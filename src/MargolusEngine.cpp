@@ -0,0 +1,116 @@
+#include "MargolusEngine.hpp"
+
+#include "Hash.hpp"
+#include "StateTransitions.hpp"
+
+namespace VkHourglass
+{
+
+MargolusEngine::MargolusEngine(bool enableHorizontalWrapping,
+                               float stuckProbability,
+                               const PackedGrid& cellGrid,
+                               size_t currentBuffer,
+                               uint32_t seed,
+                               uint32_t generation)
+    : _enableHorizontalWrapping(enableHorizontalWrapping)
+    , _stuckThreshold(getStuckThreshold(stuckProbability))
+    , _seed(seed)
+    , _cellBuffers({cellGrid, cellGrid})
+    , _currentBuffer(currentBuffer)
+    , _generation(generation)
+{
+}
+
+void MargolusEngine::step(void)
+{
+    const uint32_t cellOffset = static_cast<uint32_t>(_currentBuffer);
+    ++_generation;
+
+    // NOTE(MM): Cells which aren't part of a valid block in this generation (e.g. the first row when using an offset)
+    // keep their state, so start off with a copy of the input.
+    _cellBuffers[!_currentBuffer] = _cellBuffers[_currentBuffer];
+
+    const PackedGrid& cellsIn = _cellBuffers[_currentBuffer];
+    const uint32_t blockCountX = cellsIn.getWidth() / 2;
+    const uint32_t blockCountY = cellsIn.getHeight() / 2;
+
+    for (uint32_t blockY = 0; blockY < blockCountY; ++blockY)
+    {
+        for (uint32_t blockX = 0; blockX < blockCountX; ++blockX)
+        {
+            updateBlock(blockX, blockY, cellOffset);
+        }
+    }
+
+    _currentBuffer = !_currentBuffer;
+}
+
+const PackedGrid& MargolusEngine::getCells(void) const
+{
+    return _cellBuffers[_currentBuffer];
+}
+
+size_t MargolusEngine::getCurrentBuffer(void) const
+{
+    return _currentBuffer;
+}
+
+uint32_t MargolusEngine::getGeneration(void) const
+{
+    return _generation;
+}
+
+void MargolusEngine::updateBlock(uint32_t blockX, uint32_t blockY, uint32_t cellOffset)
+{
+    const PackedGrid& cellsIn = _cellBuffers[_currentBuffer];
+    PackedGrid& cellsOut = _cellBuffers[!_currentBuffer];
+
+    const uint32_t left = blockX * 2 + cellOffset;
+    const uint32_t top = blockY * 2 + cellOffset;
+    const uint32_t bottom = top + 1;
+    uint32_t right = left + 1;
+
+    if (right == cellsIn.getWidth())
+    {
+        if (!_enableHorizontalWrapping)
+        {
+            return;
+        }
+        right = 0;
+    }
+
+    if (bottom == cellsIn.getHeight())
+    {
+        return;
+    }
+
+    // See 'stateTransitions.comp' for state representation in bits.
+    uint32_t val = cellsIn.isSand(left, top);
+    val = val | cellsIn.isSand(right, top) << 1;
+    val = val | cellsIn.isSand(left, bottom) << 2;
+    val = val | cellsIn.isSand(right, bottom) << 3;
+
+    val = val | cellsIn.isWall(left, top) << 4;
+    val = val | cellsIn.isWall(right, top) << 5;
+    val = val | cellsIn.isWall(left, bottom) << 6;
+    val = val | cellsIn.isWall(right, bottom) << 7;
+
+    uint32_t newState = StateTransitions::STATE_TRANSITION[val];
+
+    if (val == StateTransitions::RANDOM_CASE_VALUE)
+    {
+        // NOTE(MM): Same row-major block index as 'blockIdx' in the shader.
+        const uint32_t blockIdx = blockY * (cellsIn.getWidth() / 2) + blockX;
+        if (getBlockRandom(_seed, _generation, blockIdx) < _stuckThreshold)
+        {
+            newState = StateTransitions::RANDOM_CASE_VALUE;
+        }
+    }
+
+    cellsOut.setSand(left, top, newState & 1);
+    cellsOut.setSand(right, top, newState & 2);
+    cellsOut.setSand(left, bottom, newState & 4);
+    cellsOut.setSand(right, bottom, newState & 8);
+}
+
+} // namespace VkHourglass
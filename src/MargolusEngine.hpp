@@ -0,0 +1,56 @@
+#ifndef VULKANHOURGLASS_MARGOLUSENGINE_HPP
+#define VULKANHOURGLASS_MARGOLUSENGINE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "PackedGrid.hpp"
+
+namespace VkHourglass
+{
+
+// CPU reference implementation of the cell transitions in 'shaders/shader.comp'.
+//
+// Updates one 2x2 block at a time via the same transition table, horizontal wrapping and stuck probability handling as
+// the shader, and uses the same double buffering. Hence, given the same seed as pushed to the compute shader, it
+// results in bit identical grids. Meant as baseline for correctness checks and benchmarks of faster implementations,
+// not for speed.
+class MargolusEngine
+{
+public:
+    // `currentBuffer` is the index of the buffer `cellGrid` is in, which determines the partition offset of the next
+    // generation (0 for a new grid, see `Checkpoint::State::currentGridBuffer` for restored ones). `seed` is the key of
+    // the random numbers and `generation` the number of generations computed before `cellGrid` (see
+    // `PushConstants`).
+    MargolusEngine(bool enableHorizontalWrapping,
+                   float stuckProbability,
+                   const PackedGrid& cellGrid,
+                   size_t currentBuffer,
+                   uint32_t seed,
+                   uint32_t generation);
+
+    // Perform a single generation. Equivalent to a dispatch of 'shader.comp' with the push constants
+    // `{getCurrentBuffer(), seed, getGeneration() + 1}`, followed by swapping in/out buffers.
+    void step(void);
+
+    // Cells of the latest generation (equivalent to `cellBuffers[getCurrentBuffer()]` on the GPU).
+    const PackedGrid& getCells(void) const;
+    size_t getCurrentBuffer(void) const;
+    uint32_t getGeneration(void) const;
+
+private:
+    void updateBlock(uint32_t blockX, uint32_t blockY, uint32_t cellOffset);
+
+    const bool _enableHorizontalWrapping;
+    const uint32_t _stuckThreshold;
+    const uint32_t _seed;
+
+    std::array<PackedGrid, 2> _cellBuffers;
+    size_t _currentBuffer;
+    uint32_t _generation;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_MARGOLUSENGINE_HPP
@@ -0,0 +1,143 @@
+#include "NumaTopology.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace VkHourglass::NumaTopology
+{
+
+// Parse a list like "0-3,8,10-11" as used by sysfs.
+static std::vector<uint32_t> parseCpuList(const std::string& list)
+{
+    std::vector<uint32_t> cpus;
+    const char* text = list.c_str();
+    while (*text != '\0')
+    {
+        char* end = nullptr;
+        const unsigned long first = strtoul(text, &end, 10);
+        if (end == text)
+        {
+            break;
+        }
+
+        unsigned long last = first;
+        if (*end == '-')
+        {
+            text = end + 1;
+            last = strtoul(text, &end, 10);
+            if (end == text)
+            {
+                break;
+            }
+        }
+
+        for (unsigned long cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(static_cast<uint32_t>(cpu));
+        }
+
+        if (*end != ',')
+        {
+            break;
+        }
+        text = end + 1;
+    }
+    return cpus;
+}
+
+static std::string readLine(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+static bool isCpuAllowed(uint32_t cpu)
+{
+#ifdef __linux__
+    cpu_set_t allowedCpus;
+    CPU_ZERO(&allowedCpus);
+    if (sched_getaffinity(0, sizeof(allowedCpus), &allowedCpus) != 0 || cpu >= CPU_SETSIZE)
+    {
+        return true;
+    }
+    return CPU_ISSET(cpu, &allowedCpus);
+#else
+    (void)cpu;
+    return true;
+#endif
+}
+
+std::vector<Node> getNodes(void)
+{
+    std::vector<Node> nodes;
+
+    for (const uint32_t id : parseCpuList(readLine("/sys/devices/system/node/online")))
+    {
+        Node node{id, parseCpuList(readLine("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist"))};
+        const auto isCpuForbidden = [](uint32_t cpu) { return !isCpuAllowed(cpu); };
+        node.cpus.erase(std::remove_if(node.cpus.begin(), node.cpus.end(), isCpuForbidden), node.cpus.end());
+
+        // NOTE(MM): Memory-only nodes (e.g. CXL expanders) don't get any threads.
+        if (!node.cpus.empty())
+        {
+            nodes.push_back(std::move(node));
+        }
+    }
+
+    if (nodes.empty())
+    {
+        Node node{0, {}};
+        for (uint32_t cpu = 0; cpu < std::max(std::thread::hardware_concurrency(), 1u); ++cpu)
+        {
+            node.cpus.push_back(cpu);
+        }
+        nodes.push_back(std::move(node));
+    }
+
+    return nodes;
+}
+
+std::vector<uint32_t> getThreadCpus(const std::vector<Node>& nodes, size_t threadCount)
+{
+    std::vector<uint32_t> threadCpus;
+    std::vector<size_t> nodeThreadCounts(nodes.size(), 0);
+
+    for (size_t thread = 0; thread < threadCount; ++thread)
+    {
+        const size_t node = thread * nodes.size() / threadCount;
+        const std::vector<uint32_t>& cpus = nodes[node].cpus;
+        threadCpus.push_back(cpus[nodeThreadCounts[node]++ % cpus.size()]);
+    }
+
+    return threadCpus;
+}
+
+bool pinCurrentThread(uint32_t cpu)
+{
+#ifdef __linux__
+    if (cpu >= CPU_SETSIZE)
+    {
+        return false;
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+} // namespace VkHourglass::NumaTopology
@@ -0,0 +1,30 @@
+#ifndef VULKANHOURGLASS_NUMATOPOLOGY_HPP
+#define VULKANHOURGLASS_NUMATOPOLOGY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VkHourglass::NumaTopology
+{
+
+struct Node
+{
+    uint32_t id;
+    std::vector<uint32_t> cpus;
+};
+
+// NUMA nodes with CPUs the process may run on, read from '/sys/devices/system/node' on Linux. Without NUMA
+// information, all CPUs form a single node.
+std::vector<Node> getNodes(void);
+
+// CPU for each of `threadCount` threads: Threads are spread evenly over the nodes, consecutive threads share a node.
+// Hence threads owning consecutive bands of the grid keep them on the same node.
+std::vector<uint32_t> getThreadCpus(const std::vector<Node>& nodes, size_t threadCount);
+
+// Restrict the calling thread to `cpu`. Returns false if it couldn't be pinned (or pinning isn't supported).
+bool pinCurrentThread(uint32_t cpu);
+
+} // namespace VkHourglass::NumaTopology
+
+#endif // VULKANHOURGLASS_NUMATOPOLOGY_HPP
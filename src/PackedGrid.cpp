@@ -0,0 +1,97 @@
+#include "PackedGrid.hpp"
+
+#include <cassert>
+
+namespace VkHourglass
+{
+
+PackedGrid::PackedGrid(uint32_t width, uint32_t height)
+    : PackedGrid(width, height, true)
+{
+}
+
+PackedGrid PackedGrid::createUninitialized(uint32_t width, uint32_t height)
+{
+    return PackedGrid(width, height, false);
+}
+
+PackedGrid::PackedGrid(uint32_t width, uint32_t height, bool initialize)
+    : _width(width)
+    , _height(height)
+    , _wordsPerRow(width / CELLS_PER_WORD)
+    , _planeWordCount(static_cast<size_t>(_wordsPerRow) * height)
+{
+    assert(width % CELLS_PER_WORD == 0 && "PackedGrid: Width needs to be a multiple of 32!");
+
+    if (initialize)
+    {
+        _data.resize(_planeWordCount * 2, 0);
+    }
+    else
+    {
+        _data.resize(_planeWordCount * 2);
+    }
+}
+
+PackedGrid PackedGrid::pack(const std::vector<uint32_t>& cells, uint32_t width, uint32_t height)
+{
+    assert(cells.size() == static_cast<size_t>(width) * height && "PackedGrid: Cells don't match given dimensions!");
+
+    PackedGrid grid(width, height);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            grid.setCell(x, y, cells[static_cast<size_t>(y) * width + x]);
+        }
+    }
+    return grid;
+}
+
+std::vector<uint32_t> PackedGrid::unpack(void) const
+{
+    std::vector<uint32_t> cells(static_cast<size_t>(_width) * _height, AIR_VALUE);
+    for (uint32_t y = 0; y < _height; ++y)
+    {
+        for (uint32_t x = 0; x < _width; ++x)
+        {
+            cells[static_cast<size_t>(y) * _width + x] = getCell(x, y);
+        }
+    }
+    return cells;
+}
+
+uint32_t PackedGrid::getCell(uint32_t x, uint32_t y) const
+{
+    return (isSand(x, y) ? SAND_VALUE : AIR_VALUE) | (isWall(x, y) ? WALL_VALUE : AIR_VALUE);
+}
+
+void PackedGrid::setCell(uint32_t x, uint32_t y, uint32_t value)
+{
+    setBit(0, x, y, value & SAND_VALUE);
+    setBit(_planeWordCount, x, y, value & WALL_VALUE);
+}
+
+bool PackedGrid::operator==(const PackedGrid& other) const
+{
+    return _width == other._width && _height == other._height && _data == other._data;
+}
+
+bool PackedGrid::getBit(size_t planeOffset, uint32_t x, uint32_t y) const
+{
+    assert(x < _width && y < _height && "PackedGrid: Cell out of range!");
+
+    const size_t wordIdx = planeOffset + static_cast<size_t>(y) * _wordsPerRow + x / CELLS_PER_WORD;
+    return (_data[wordIdx] >> (x % CELLS_PER_WORD)) & 1u;
+}
+
+void PackedGrid::setBit(size_t planeOffset, uint32_t x, uint32_t y, bool value)
+{
+    assert(x < _width && y < _height && "PackedGrid: Cell out of range!");
+
+    const size_t wordIdx = planeOffset + static_cast<size_t>(y) * _wordsPerRow + x / CELLS_PER_WORD;
+    const uint32_t mask = 1u << (x % CELLS_PER_WORD);
+    _data[wordIdx] = value ? (_data[wordIdx] | mask) : (_data[wordIdx] & ~mask);
+}
+
+} // namespace VkHourglass
@@ -0,0 +1,114 @@
+#ifndef VULKANHOURGLASS_PACKEDGRID_HPP
+#define VULKANHOURGLASS_PACKEDGRID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace VkHourglass
+{
+
+// Cell values as used by the unpacked (one `uint32_t` per cell) representation.
+constexpr uint32_t AIR_VALUE = 0;
+constexpr uint32_t SAND_VALUE = 1;
+constexpr uint32_t WALL_VALUE = 2;
+
+// NOTE(MM): Allocator leaving value initialized elements (e.g. of `std::vector::resize()`) uninitialized, so that the
+// pages of a freshly allocated buffer aren't touched until they are written the first time. Linux places pages on the
+// NUMA node of the thread touching them first.
+template<typename T>
+class DefaultInitAllocator : public std::allocator<T>
+{
+public:
+    template<typename U>
+    struct rebind
+    {
+        using other = DefaultInitAllocator<U>;
+    };
+
+    DefaultInitAllocator(void) = default;
+    template<typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U>& other) noexcept
+        : std::allocator<T>(other)
+    {
+    }
+
+    template<typename U>
+    void construct(U* pointer) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+    template<typename U, typename... Args>
+    void construct(U* pointer, Args&&... args)
+    {
+        std::allocator_traits<std::allocator<T>>::construct(
+            static_cast<std::allocator<T>&>(*this), pointer, std::forward<Args>(args)...);
+    }
+};
+
+// Cell grid with 2 bits per cell, stored as two separate bit-planes (sand and wall) in a single `uint32_t` array.
+//
+// Layout of `getData()` (this is also the layout of the GPU cell buffers):
+// - `[0, getPlaneWordCount())`: sand plane
+// - `[getPlaneWordCount(), 2 * getPlaneWordCount())`: wall plane
+//
+// Within a plane, rows are stored consecutively with `getWordsPerRow()` words each. Cell `(x, y)` is bit `x % 32` of
+// word `y * getWordsPerRow() + x / 32`.
+class PackedGrid
+{
+public:
+    static constexpr uint32_t CELLS_PER_WORD = 32;
+
+    using Words = std::vector<uint32_t, DefaultInitAllocator<uint32_t>>;
+
+    // Create a grid filled with air. The width needs to be a multiple of `CELLS_PER_WORD`.
+    PackedGrid(uint32_t width, uint32_t height);
+    // Create a grid without initializing its cells, which leaves placing its pages to the threads writing them first
+    // (see `SimdMargolusEngine`).
+    static PackedGrid createUninitialized(uint32_t width, uint32_t height);
+
+    static PackedGrid pack(const std::vector<uint32_t>& cells, uint32_t width, uint32_t height);
+    std::vector<uint32_t> unpack(void) const;
+
+    uint32_t getWidth(void) const { return _width; }
+    uint32_t getHeight(void) const { return _height; }
+    uint32_t getWordsPerRow(void) const { return _wordsPerRow; }
+    size_t getPlaneWordCount(void) const { return _planeWordCount; }
+
+    uint32_t getCell(uint32_t x, uint32_t y) const;
+    void setCell(uint32_t x, uint32_t y, uint32_t value);
+
+    bool isSand(uint32_t x, uint32_t y) const { return getBit(0, x, y); }
+    bool isWall(uint32_t x, uint32_t y) const { return getBit(_planeWordCount, x, y); }
+    void setSand(uint32_t x, uint32_t y, bool isSand) { setBit(0, x, y, isSand); }
+
+    const Words& getData(void) const { return _data; }
+    Words& getData(void) { return _data; }
+
+    uint32_t* getSandPlane(void) { return _data.data(); }
+    const uint32_t* getSandPlane(void) const { return _data.data(); }
+    const uint32_t* getWallPlane(void) const { return _data.data() + _planeWordCount; }
+
+    bool operator==(const PackedGrid& other) const;
+    bool operator!=(const PackedGrid& other) const { return !(*this == other); }
+
+private:
+    PackedGrid(uint32_t width, uint32_t height, bool initialize);
+
+    bool getBit(size_t planeOffset, uint32_t x, uint32_t y) const;
+    void setBit(size_t planeOffset, uint32_t x, uint32_t y, bool value);
+
+    uint32_t _width;
+    uint32_t _height;
+    uint32_t _wordsPerRow;
+    size_t _planeWordCount;
+    Words _data;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_PACKEDGRID_HPP
@@ -0,0 +1,156 @@
+#include "PipelineCache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#include "FileReading.hpp"
+
+namespace VkHourglass::PipelineCache
+{
+
+// NOTE(MM): Bump the version whenever the file layout changes. The header is written in host layout, which is fine
+// since the key ties a file to a single device anyway.
+static constexpr uint32_t FILE_MAGIC = 0x48475043; // "CPGH"
+static constexpr uint32_t FILE_VERSION = 1;
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    Key key;
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+static bool operator==(const Key& lhs, const Key& rhs)
+{
+    return lhs.vendorId == rhs.vendorId && lhs.deviceId == rhs.deviceId && lhs.driverVersion == rhs.driverVersion
+           && lhs.pipelineCacheUuid == rhs.pipelineCacheUuid && lhs.shaderHash == rhs.shaderHash;
+}
+
+// NOTE(MM): Checks the header the driver writes in front of its data (see 'VkPipelineCacheHeaderVersionOne'), which
+// has to match the key as well.
+static bool isValidVulkanCacheHeader(const std::vector<char>& data, const Key& key)
+{
+    VkPipelineCacheHeaderVersionOne vulkanHeader;
+    if (data.size() < sizeof(vulkanHeader))
+    {
+        return false;
+    }
+    std::memcpy(&vulkanHeader, data.data(), sizeof(vulkanHeader));
+
+    return vulkanHeader.headerSize >= sizeof(vulkanHeader) && vulkanHeader.headerSize <= data.size()
+           && vulkanHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+           && vulkanHeader.vendorID == key.vendorId && vulkanHeader.deviceID == key.deviceId
+           && std::equal(key.pipelineCacheUuid.cbegin(), key.pipelineCacheUuid.cend(), vulkanHeader.pipelineCacheUUID);
+}
+
+Key createKey(const VkPhysicalDeviceProperties& deviceProperties, uint64_t shaderHash)
+{
+    Key key{deviceProperties.vendorID, deviceProperties.deviceID, deviceProperties.driverVersion, {}, shaderHash};
+    std::copy_n(deviceProperties.pipelineCacheUUID, VK_UUID_SIZE, key.pipelineCacheUuid.begin());
+    return key;
+}
+
+uint64_t hashData(const std::vector<char>& data, uint64_t hash)
+{
+    for (const char byte : data)
+    {
+        hash ^= static_cast<uint8_t>(byte);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::optional<std::vector<char>> loadData(const std::filesystem::path& filePath, const Key& key)
+{
+    // NOTE(MM): A missing file is the regular case on first start, don't report it as error.
+    std::error_code errorCode;
+    if (!std::filesystem::exists(filePath, errorCode))
+    {
+        return std::nullopt;
+    }
+
+    auto fileContentOpt = FileReading::readFile(filePath, std::ios::ate | std::ios::binary);
+    if (!fileContentOpt.has_value())
+    {
+        return std::nullopt;
+    }
+    const std::vector<char>& fileContent = fileContentOpt.value();
+
+    FileHeader header;
+    if (fileContent.size() < sizeof(header))
+    {
+        fprintf(stderr, "Ignoring truncated pipeline cache '%s'.\n", filePath.c_str());
+        return std::nullopt;
+    }
+    std::memcpy(&header, fileContent.data(), sizeof(header));
+
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION)
+    {
+        fprintf(stderr, "Ignoring pipeline cache '%s' of unknown format.\n", filePath.c_str());
+        return std::nullopt;
+    }
+
+    if (!(header.key == key))
+    {
+        // NOTE(MM): Expected after driver updates or shader changes, the cache gets replaced on shutdown.
+        return std::nullopt;
+    }
+
+    std::vector<char> data(fileContent.cbegin() + sizeof(header), fileContent.cend());
+    if (header.dataSize != data.size() || header.dataHash != hashData(data) || !isValidVulkanCacheHeader(data, key))
+    {
+        fprintf(stderr, "Ignoring corrupted pipeline cache '%s'.\n", filePath.c_str());
+        return std::nullopt;
+    }
+
+    return data;
+}
+
+bool storeData(const std::filesystem::path& filePath, const Key& key, const std::vector<char>& data)
+{
+    std::filesystem::path temporaryPath(filePath);
+    temporaryPath += ".tmp";
+
+    FileHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.key = key;
+    header.dataSize = data.size();
+    header.dataHash = hashData(data);
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        file.close();
+
+        if (!file)
+        {
+            fprintf(stderr, "Failed to write pipeline cache to path: %s\n", temporaryPath.c_str());
+            std::error_code errorCode;
+            std::filesystem::remove(temporaryPath, errorCode);
+            return false;
+        }
+    }
+
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryPath, filePath, errorCode);
+    if (errorCode)
+    {
+        fprintf(stderr,
+                "Failed to replace pipeline cache at path: %s (%s)\n",
+                filePath.c_str(),
+                errorCode.message().c_str());
+        std::filesystem::remove(temporaryPath, errorCode);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace VkHourglass::PipelineCache
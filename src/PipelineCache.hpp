@@ -0,0 +1,44 @@
+#ifndef VULKANHOURGLASS_PIPELINECACHE_HPP
+#define VULKANHOURGLASS_PIPELINECACHE_HPP
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+namespace VkHourglass::PipelineCache
+{
+
+// Identifies the device, driver and shaders a pipeline cache file was written for. Cache data is only passed to the
+// driver if the key of the file matches exactly.
+//
+// NOTE(MM): Drivers are supposed to validate the data themselves, but some are known to crash on data written by
+// another driver version. The shader hash also lets us discard caches of outdated shaders instead of growing them.
+struct Key
+{
+    uint32_t vendorId;
+    uint32_t deviceId;
+    uint32_t driverVersion;
+    std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUuid;
+    uint64_t shaderHash;
+};
+
+Key createKey(const VkPhysicalDeviceProperties& deviceProperties, uint64_t shaderHash);
+
+// 64 bit FNV-1a hash of `data`, pass the previous result as `hash` to hash multiple buffers.
+uint64_t hashData(const std::vector<char>& data, uint64_t hash = 0xcbf29ce484222325ULL);
+
+// Read the cache data stored at `filePath`. Returns `std::nullopt` if there is no file, or the file is corrupted or
+// doesn't match `key`.
+std::optional<std::vector<char>> loadData(const std::filesystem::path& filePath, const Key& key);
+
+// Store `data` (as returned by `vkGetPipelineCacheData`) at `filePath`. The file is replaced atomically (written to a
+// temporary file first, then renamed), so that a crash never leaves a partially written cache behind.
+bool storeData(const std::filesystem::path& filePath, const Key& key, const std::vector<char>& data);
+
+} // namespace VkHourglass::PipelineCache
+
+#endif // VULKANHOURGLASS_PIPELINECACHE_HPP
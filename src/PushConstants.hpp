@@ -9,7 +9,18 @@ namespace VkHourglass
 struct PushConstants
 {
     alignas(4) uint32_t cellOffset;
-    alignas(4) int32_t seed;
+    // Key of the random numbers of the stuck rule, the same for all generations of a run (see 'shaders/hash.comp').
+    alignas(4) uint32_t seed;
+    // Counts computed generations (starting at 1), used to track when tiles changed the last time and as counter of
+    // the random numbers. With temporal blocking (`Configuration::temporalSteps`), a dispatch computes several
+    // generations and this counts the last one.
+    alignas(4) uint32_t generation;
+};
+
+struct FragmentPushConstants
+{
+    // Index of the drawn cell buffer, which determines its layout (see CellBufferLayout.hpp).
+    alignas(4) uint32_t cellBufferIndex;
 };
 
 } // namespace VkHourglass
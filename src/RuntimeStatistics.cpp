@@ -1,17 +1,120 @@
 #include "RuntimeStatistics.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 namespace VkHourglass
 {
 
+// NOTE(MM): Values below '2^LINEAR_BITS' get a bucket each, larger ones keep their 'LINEAR_BITS' most significant bits
+// (i.e. '2^(LINEAR_BITS - 1)' buckets per power of two).
+static constexpr uint32_t LINEAR_BITS = 7;
+static constexpr uint64_t LINEAR_BUCKET_COUNT = uint64_t(1) << LINEAR_BITS;
+static constexpr uint64_t SUB_BUCKET_COUNT = LINEAR_BUCKET_COUNT / 2;
+// Durations are clamped to ~12.7 days.
+static constexpr uint32_t MAX_VALUE_BITS = 40;
+static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - LINEAR_BITS + 2) * SUB_BUCKET_COUNT;
+
+static constexpr std::array<const char*, static_cast<size_t>(RuntimeStatistics::Stage::Count)> STAGE_NAMES = {
+    "frame",
+    "fence wait",
+    "acquire",
+    "present",
+    "GPU compute",
+    "GPU draw",
+};
+
+static size_t getBucket(uint64_t value)
+{
+    if (value < LINEAR_BUCKET_COUNT)
+    {
+        return static_cast<size_t>(value);
+    }
+
+    uint32_t shift = 1;
+    while ((value >> shift) >= LINEAR_BUCKET_COUNT)
+    {
+        ++shift;
+    }
+    return static_cast<size_t>(shift * SUB_BUCKET_COUNT + (value >> shift));
+}
+
+static uint64_t getBucketLowerBound(size_t bucket)
+{
+    if (bucket < LINEAR_BUCKET_COUNT)
+    {
+        return bucket;
+    }
+
+    const uint64_t shift = bucket / SUB_BUCKET_COUNT - 1;
+    return (bucket % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT) << shift;
+}
+
+RuntimeStatistics::Histogram::Histogram()
+    : _buckets(BUCKET_COUNT, 0)
+    , _count(0)
+    , _sum(0)
+    , _min(std::numeric_limits<uint64_t>::max())
+    , _max(0)
+{
+}
+
+void RuntimeStatistics::Histogram::add(uint64_t valueUs)
+{
+    const uint64_t value = std::min(valueUs, MAX_VALUE);
+    ++_buckets[getBucket(value)];
+    ++_count;
+    _sum += value;
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+}
+
+uint64_t RuntimeStatistics::Histogram::getCount(void) const
+{
+    return _count;
+}
+
+uint64_t RuntimeStatistics::Histogram::getPercentile(double percentile) const
+{
+    const auto rank = std::max<uint64_t>(
+        static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(_count))), 1);
+
+    uint64_t count = 0;
+    for (size_t bucket = 0; bucket < _buckets.size(); ++bucket)
+    {
+        count += _buckets[bucket];
+        if (count >= rank)
+        {
+            return std::clamp(getBucketLowerBound(bucket), _min, _max);
+        }
+    }
+
+    return _max;
+}
+
+void RuntimeStatistics::Histogram::print(const char* name) const
+{
+    if (_count == 0)
+    {
+        return;
+    }
+
+    printf("%-12s %10llu %10.1f %10llu %10llu %10llu %10llu %10llu\n",
+           name,
+           static_cast<unsigned long long>(_count),
+           static_cast<double>(_sum) / static_cast<double>(_count),
+           static_cast<unsigned long long>(_min),
+           static_cast<unsigned long long>(getPercentile(50.0)),
+           static_cast<unsigned long long>(getPercentile(90.0)),
+           static_cast<unsigned long long>(getPercentile(99.0)),
+           static_cast<unsigned long long>(_max));
+}
+
 RuntimeStatistics::RuntimeStatistics()
     : _runtimeStart(std::chrono::steady_clock::now())
-    , _longestFrameTime(std::numeric_limits<long>::min())
-    , _shortestFrameTime(std::numeric_limits<long>::max())
     , _frameCount(0)
-    , _isFirstFrame(true)
 {
 }
 
@@ -23,29 +126,47 @@ void RuntimeStatistics::notifyFrameBegin(void)
     const auto now = std::chrono::steady_clock::now();
     _previousFrameStart = now;
 
-    if (_isFirstFrame)
+    if (_frameCount == 1)
     {
-        _isFirstFrame = false;
         return;
     }
 
-    const auto frameTime = std::chrono::duration_cast<std::chrono::milliseconds>(now - previousStart);
-    _shortestFrameTime = std::min(_shortestFrameTime, frameTime.count());
-    _longestFrameTime = std::max(_longestFrameTime, frameTime.count());
+    addStageTime(Stage::Frame, now - previousStart);
+}
+
+void RuntimeStatistics::addStageTime(Stage stage, std::chrono::nanoseconds time)
+{
+    const auto timeUs = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+    _stageHistograms[static_cast<size_t>(stage)].add(static_cast<uint64_t>(std::max<int64_t>(timeUs, 0)));
 }
 
 void RuntimeStatistics::printResults(void) const
 {
     const auto now = std::chrono::steady_clock::now();
-    const auto runtime = std::chrono::duration_cast<std::chrono::milliseconds>(now - _runtimeStart);
+    const double runtimeMs = std::chrono::duration<double, std::milli>(now - _runtimeStart).count();
 
-    printf("Overall runtime: %zums\n", runtime.count());
-    printf("Drawn Frames: %zu\n", _frameCount);
+    printf("Overall runtime: %.1fms\n", runtimeMs);
+    printf("Drawn Frames: %llu\n", static_cast<unsigned long long>(_frameCount));
 
-    const long averageFrameTime = runtime.count() / _frameCount;
-    printf("Average frame time: %zums / %zu fps\n", averageFrameTime, 1000 / averageFrameTime);
-    printf("Best frame time: %zums\n", _shortestFrameTime);
-    printf("Worst frame time: %zums\n", _longestFrameTime);
+    if (_frameCount > 0)
+    {
+        const double averageFrameTimeMs = runtimeMs / static_cast<double>(_frameCount);
+        printf("Average frame time: %.3fms / %.1f fps\n", averageFrameTimeMs, 1000.0 / averageFrameTimeMs);
+    }
+
+    printf("\n%-12s %10s %10s %10s %10s %10s %10s %10s\n",
+           "Stage [us]",
+           "count",
+           "mean",
+           "min",
+           "p50",
+           "p90",
+           "p99",
+           "max");
+    for (size_t stage = 0; stage < _stageHistograms.size(); ++stage)
+    {
+        _stageHistograms[stage].print(STAGE_NAMES[stage]);
+    }
 }
 
 } // namespace VkHourglass
@@ -1,27 +1,68 @@
 #ifndef VULKANHOURGLASS_RUNTIMESTATISTICS_HPP
 #define VULKANHOURGLASS_RUNTIMESTATISTICS_HPP
 
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <cstdio>
+#include <vector>
 
 namespace VkHourglass
 {
 
+// Collects frame times and the time spent in the individual stages of a frame (CPU waits and GPU timestamps) at
+// microsecond resolution and prints percentiles of them at exit.
 class RuntimeStatistics
 {
 public:
+    enum class Stage
+    {
+        // CPU time between the begin of two frames
+        Frame,
+        // CPU time waiting for the frame in flight to finish on the GPU
+        FenceWait,
+        // CPU time waiting for the next swapchain image
+        Acquire,
+        // CPU time of queueing the presentation
+        Present,
+        // GPU time of all generations computed in the frame, including their barriers
+        GpuCompute,
+        // GPU time of drawing the grid
+        GpuDraw,
+        Count,
+    };
+
     RuntimeStatistics();
 
     void notifyFrameBegin(void);
+    void addStageTime(Stage stage, std::chrono::nanoseconds time);
     void printResults(void) const;
 
 private:
+    // Log-linear histogram of durations in microseconds: exact below 128us, above that with a relative error of at
+    // most 1/64 (like HDR histograms), so long runs need constant memory.
+    class Histogram
+    {
+    public:
+        Histogram();
+
+        void add(uint64_t valueUs);
+        uint64_t getCount(void) const;
+        uint64_t getPercentile(double percentile) const;
+        void print(const char* name) const;
+
+    private:
+        std::vector<uint64_t> _buckets;
+        uint64_t _count;
+        uint64_t _sum;
+        uint64_t _min;
+        uint64_t _max;
+    };
+
     std::chrono::steady_clock::time_point _runtimeStart;
     std::chrono::steady_clock::time_point _previousFrameStart;
-    long _longestFrameTime;
-    long _shortestFrameTime;
-    long _frameCount;
-    bool _isFirstFrame;
+    std::array<Histogram, static_cast<size_t>(Stage::Count)> _stageHistograms;
+    uint64_t _frameCount;
 };
 
 } // namespace VkHourglass
@@ -0,0 +1,1098 @@
+#include "SimdMargolusEngine.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "ApplicationDefines.hpp"
+#include "Hash.hpp"
+#include "NumaTopology.hpp"
+#include "StateTransitionLogic.hpp"
+#include "StateTransitions.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VKHOURGLASS_X86 1
+#endif
+
+namespace VkHourglass
+{
+
+static constexpr uint32_t BLOCKS_PER_WORD = PackedGrid::CELLS_PER_WORD / 2;
+
+// NOTE(MM): Tiles for active region tracking (see 'shaders/tiles.comp'). Narrow tiles skip the most settled cells, to
+// still update many words at once, neighbouring active tiles of a tile row are merged into runs.
+static constexpr size_t TILE_WIDTH_WORDS = 1;
+static constexpr size_t TILE_HEIGHT_BLOCK_ROWS = 32;
+
+// NOTE(MM): Temporal rounds only update the tiles within two tiles of recently changed ones (see
+// `updateTemporalTileRuns()`), which requires changes to take more generations to cross a tile than there are in a
+// round. The halo has to stay within the neighbouring bands.
+static constexpr uint32_t MAX_TEMPORAL_STEPS = ApplicationDefines::NonModifiable::MAX_CPU_TEMPORAL_STEPS;
+static_assert(MAX_TEMPORAL_STEPS <= TILE_WIDTH_WORDS * PackedGrid::CELLS_PER_WORD);
+static_assert(MAX_TEMPORAL_STEPS < TILE_HEIGHT_BLOCK_ROWS * 2);
+
+// Rows above and below a band which are computed along with it, rounded up to block rows so that the band copy starts
+// at an even row.
+static constexpr size_t getTemporalHaloRows(uint32_t temporalSteps)
+{
+    return (temporalSteps + 1) / 2 * 2;
+}
+
+// Aligned sand/wall rows (4), new aligned rows (2) and random case flags (1).
+static constexpr size_t SCRATCH_ROW_COUNT = 7;
+
+// NOTE(MM): The generated logic has to match the table the GPU uses, i.e. for every valid state (no cell being sand
+// and wall at the same time). Regenerate it if this fails.
+static constexpr bool isStateTransitionLogicUpToDate(void)
+{
+    for (uint32_t state = 0; state < StateTransitions::STATE_TRANSITION.size(); ++state)
+    {
+        if ((state & 0xf) & (state >> 4))
+        {
+            continue;
+        }
+
+        uint32_t newTL = 0, newTR = 0, newBL = 0, newBR = 0;
+        StateTransitionLogic::transition<uint32_t>(state & 1,
+                                                   state >> 1 & 1,
+                                                   state >> 2 & 1,
+                                                   state >> 3 & 1,
+                                                   state >> 4 & 1,
+                                                   state >> 5 & 1,
+                                                   state >> 6 & 1,
+                                                   state >> 7 & 1,
+                                                   newTL,
+                                                   newTR,
+                                                   newBL,
+                                                   newBR);
+
+        const uint32_t newState = (newTL & 1) | (newTR & 1) << 1 | (newBL & 1) << 2 | (newBR & 1) << 3;
+        if (newState != StateTransitions::STATE_TRANSITION[state]
+            || StateTransitionLogic::STATE_TRANSITION[state] != StateTransitions::STATE_TRANSITION[state])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+static_assert(isStateTransitionLogicUpToDate());
+
+// Inputs of the stuck rule of a generation, see 'shaders/hash.comp'.
+struct StuckRule
+{
+    uint32_t seed;
+    uint32_t generation;
+    uint32_t threshold;
+};
+
+// NOTE(MM): Input words are "aligned", i.e. block k of a word consists of bits (2 * k, 2 * k + 1) of the top and bottom
+// row words. Writes the new sand state of all blocks of `wordCount` words and sets bit k of `randomCaseBlocks[i]` if
+// block k of word i is in the random case. `firstBlockIdx` is the block index (see 'shader.comp') of the first block of
+// the first word.
+using TransitionWordsFunction = void (*)(const uint32_t* sandTop,
+                                         const uint32_t* sandBottom,
+                                         const uint32_t* wallTop,
+                                         const uint32_t* wallBottom,
+                                         uint32_t* newSandTop,
+                                         uint32_t* newSandBottom,
+                                         uint32_t* randomCaseBlocks,
+                                         size_t wordCount,
+                                         uint32_t firstBlockIdx,
+                                         const StuckRule& stuckRule);
+
+static void transitionWordsScalar(const uint32_t* sandTop,
+                                  const uint32_t* sandBottom,
+                                  const uint32_t* wallTop,
+                                  const uint32_t* wallBottom,
+                                  uint32_t* newSandTop,
+                                  uint32_t* newSandBottom,
+                                  uint32_t* randomCaseBlocks,
+                                  size_t wordCount,
+                                  uint32_t firstBlockIdx,
+                                  const StuckRule& stuckRule)
+{
+    for (size_t i = 0; i < wordCount; ++i)
+    {
+        uint32_t newTop = 0;
+        uint32_t newBottom = 0;
+        uint32_t randomBlocks = 0;
+
+        for (uint32_t block = 0; block < BLOCKS_PER_WORD; ++block)
+        {
+            const uint32_t shift = block * 2;
+
+            // See 'stateTransitions.comp' for state representation in bits.
+            uint32_t val = (sandTop[i] >> shift) & 3;
+            val = val | ((sandBottom[i] >> shift) & 3) << 2;
+            val = val | ((wallTop[i] >> shift) & 3) << 4;
+            val = val | ((wallBottom[i] >> shift) & 3) << 6;
+
+            uint32_t newState = StateTransitions::STATE_TRANSITION[val];
+            if (val == StateTransitions::RANDOM_CASE_VALUE)
+            {
+                randomBlocks = randomBlocks | 1u << block;
+                const uint32_t blockIdx = firstBlockIdx + static_cast<uint32_t>(i) * BLOCKS_PER_WORD + block;
+                if (getBlockRandom(stuckRule.seed, stuckRule.generation, blockIdx) < stuckRule.threshold)
+                {
+                    newState = StateTransitions::RANDOM_CASE_VALUE;
+                }
+            }
+
+            newTop = newTop | (newState & 3) << shift;
+            newBottom = newBottom | (newState >> 2) << shift;
+        }
+
+        newSandTop[i] = newTop;
+        newSandBottom[i] = newBottom;
+        randomCaseBlocks[i] = randomBlocks;
+    }
+}
+
+// Gathers the even bits of `x` into the lower 32 bits.
+static inline uint64_t compressEvenBits(uint64_t x)
+{
+    x &= 0x5555555555555555ull;
+    x = (x | (x >> 1)) & 0x3333333333333333ull;
+    x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x >> 4)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x >> 8)) & 0x0000ffff0000ffffull;
+    x = (x | (x >> 16)) & 0x00000000ffffffffull;
+    return x;
+}
+
+// Inverse of `compressEvenBits()`: Spreads the lower 32 bits of `x` to the even bits.
+static inline uint64_t spreadToEvenBits(uint64_t x)
+{
+    x &= 0x00000000ffffffffull;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+// Splits 4 consecutive row words (64 blocks) into the left and right cells of the blocks, one block per bit.
+static inline void sliceWords(const uint32_t* words, uint64_t& left, uint64_t& right)
+{
+    const uint64_t low = words[0] | static_cast<uint64_t>(words[1]) << 32;
+    const uint64_t high = words[2] | static_cast<uint64_t>(words[3]) << 32;
+    left = compressEvenBits(low) | compressEvenBits(high) << 32;
+    right = compressEvenBits(low >> 1) | compressEvenBits(high >> 1) << 32;
+}
+
+static inline void unsliceWords(uint64_t left, uint64_t right, uint32_t* words)
+{
+    const uint64_t low = spreadToEvenBits(left) | spreadToEvenBits(right) << 1;
+    const uint64_t high = spreadToEvenBits(left >> 32) | spreadToEvenBits(right >> 32) << 1;
+    words[0] = static_cast<uint32_t>(low);
+    words[1] = static_cast<uint32_t>(low >> 32);
+    words[2] = static_cast<uint32_t>(high);
+    words[3] = static_cast<uint32_t>(high >> 32);
+}
+
+// NOTE(MM): Bit-sliced version: Instead of looking up the table per block, 64 blocks are updated at once with the
+// boolean expressions generated from the table (see 'tools/generateStateTransitionLogic.cpp'). Only blocks in the
+// random case are hashed individually.
+static void transitionWordsBitSliced(const uint32_t* sandTop,
+                                     const uint32_t* sandBottom,
+                                     const uint32_t* wallTop,
+                                     const uint32_t* wallBottom,
+                                     uint32_t* newSandTop,
+                                     uint32_t* newSandBottom,
+                                     uint32_t* randomCaseBlocks,
+                                     size_t wordCount,
+                                     uint32_t firstBlockIdx,
+                                     const StuckRule& stuckRule)
+{
+    constexpr size_t WORDS_PER_SLICE = 4;
+
+    for (size_t i = 0; i < wordCount; i += WORDS_PER_SLICE)
+    {
+        // NOTE(MM): Pad the last slice with air, those blocks stay air and are dropped.
+        const size_t sliceWordCount = std::min(WORDS_PER_SLICE, wordCount - i);
+        uint32_t sT[WORDS_PER_SLICE] = {};
+        uint32_t sB[WORDS_PER_SLICE] = {};
+        uint32_t wT[WORDS_PER_SLICE] = {};
+        uint32_t wB[WORDS_PER_SLICE] = {};
+        std::copy_n(sandTop + i, sliceWordCount, sT);
+        std::copy_n(sandBottom + i, sliceWordCount, sB);
+        std::copy_n(wallTop + i, sliceWordCount, wT);
+        std::copy_n(wallBottom + i, sliceWordCount, wB);
+
+        uint64_t sandTL, sandTR, sandBL, sandBR, wallTL, wallTR, wallBL, wallBR;
+        sliceWords(sT, sandTL, sandTR);
+        sliceWords(sB, sandBL, sandBR);
+        sliceWords(wT, wallTL, wallTR);
+        sliceWords(wB, wallBL, wallBR);
+
+        uint64_t newTL, newTR, newBL, newBR;
+        StateTransitionLogic::transition(sandTL,
+                                         sandTR,
+                                         sandBL,
+                                         sandBR,
+                                         wallTL,
+                                         wallTR,
+                                         wallBL,
+                                         wallBR,
+                                         newTL,
+                                         newTR,
+                                         newBL,
+                                         newBR);
+
+        // Blocks in the random case (`StateTransitions::RANDOM_CASE_VALUE`) may get stuck instead.
+        const uint64_t randomCaseMask = sandTL & sandTR & ~sandBL & ~sandBR & ~(wallTL | wallTR | wallBL | wallBR);
+        for (size_t word = 0; word < sliceWordCount; ++word)
+        {
+            randomCaseBlocks[i + word] = static_cast<uint32_t>(randomCaseMask >> (word * BLOCKS_PER_WORD)) & 0xffff;
+        }
+
+        uint64_t remainingMask = randomCaseMask;
+        uint64_t stuckMask = 0;
+        while (remainingMask != 0)
+        {
+            const auto lane = static_cast<uint32_t>(__builtin_ctzll(remainingMask));
+            remainingMask &= remainingMask - 1;
+
+            const uint32_t blockIdx = firstBlockIdx + static_cast<uint32_t>(i) * BLOCKS_PER_WORD + lane;
+            if (getBlockRandom(stuckRule.seed, stuckRule.generation, blockIdx) < stuckRule.threshold)
+            {
+                stuckMask |= 1ull << lane;
+            }
+        }
+        newTL |= stuckMask;
+        newTR |= stuckMask;
+        newBL &= ~stuckMask;
+        newBR &= ~stuckMask;
+
+        unsliceWords(newTL, newTR, sT);
+        unsliceWords(newBL, newBR, sB);
+        std::copy_n(sT, sliceWordCount, newSandTop + i);
+        std::copy_n(sB, sliceWordCount, newSandBottom + i);
+    }
+}
+
+#ifdef VKHOURGLASS_X86
+// NOTE(MM): Vectorized 'getBlockRandom', bit identical to the scalar version. AVX2 only multiplies the even lanes to
+// 64 bits, so the high halves of the odd lanes are computed separately.
+__attribute__((target("avx2"))) static inline __m256i getBlockRandomAvx2(__m256i blockIndices,
+                                                                        const StuckRule& stuckRule)
+{
+    const __m256i multiplier = _mm256_set1_epi32(static_cast<int>(PHILOX_MULTIPLIER));
+    __m256i counter0 = blockIndices;
+    __m256i counter1 = _mm256_set1_epi32(static_cast<int>(stuckRule.generation));
+    uint32_t key = stuckRule.seed;
+
+    for (uint32_t i = 0; i < PHILOX_ROUND_COUNT; ++i)
+    {
+        const __m256i evenProducts = _mm256_mul_epu32(counter0, multiplier);
+        const __m256i oddProducts = _mm256_mul_epu32(_mm256_srli_epi64(counter0, 32), multiplier);
+        const __m256i high = _mm256_blend_epi32(_mm256_srli_epi64(evenProducts, 32), oddProducts, 0xaa);
+        const __m256i low = _mm256_mullo_epi32(counter0, multiplier);
+
+        counter0 = _mm256_xor_si256(_mm256_xor_si256(high, _mm256_set1_epi32(static_cast<int>(key))), counter1);
+        counter1 = low;
+        key += PHILOX_KEY_INCREMENT;
+    }
+
+    return _mm256_srli_epi32(counter0, 1);
+}
+
+__attribute__((target("avx2"))) static inline uint32_t horizontalOrAvx2(__m256i v)
+{
+    __m128i x = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    x = _mm_or_si128(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = _mm_or_si128(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(x));
+}
+
+// Transition 8 blocks (one per lane) of a word. `shifts` holds the bit offset (2 * block) of each lane's block.
+// Returns the new sand state of the top and bottom cells, already shifted to their position in the word, and a mask of
+// the lanes in the random case.
+__attribute__((target("avx2"))) static inline uint32_t transitionBlocksAvx2(__m256i sandTop,
+                                                                       __m256i sandBottom,
+                                                                       __m256i wallTop,
+                                                                       __m256i wallBottom,
+                                                                       __m256i shifts,
+                                                                       __m256i blockIndices,
+                                                                       const StuckRule& stuckRule,
+                                                                       __m256i& newTop,
+                                                                       __m256i& newBottom)
+{
+    const __m256i three = _mm256_set1_epi32(3);
+
+    __m256i val = _mm256_and_si256(_mm256_srlv_epi32(sandTop, shifts), three);
+    val = _mm256_or_si256(val, _mm256_slli_epi32(_mm256_and_si256(_mm256_srlv_epi32(sandBottom, shifts), three), 2));
+    val = _mm256_or_si256(val, _mm256_slli_epi32(_mm256_and_si256(_mm256_srlv_epi32(wallTop, shifts), three), 4));
+    val = _mm256_or_si256(val, _mm256_slli_epi32(_mm256_and_si256(_mm256_srlv_epi32(wallBottom, shifts), three), 6));
+
+    __m256i newState = _mm256_i32gather_epi32(
+        reinterpret_cast<const int*>(StateTransitions::STATE_TRANSITION.data()), val, sizeof(uint32_t));
+
+    // NOTE(MM): The random case is rare (sand on top of air), so skip the random numbers if no lane needs them. The
+    // threshold may be 2^31, hence the unsigned comparison (random < threshold <=> max(random, threshold) != random).
+    const __m256i randomCaseMask = _mm256_cmpeq_epi32(val, three);
+    if (_mm256_movemask_epi8(randomCaseMask) != 0)
+    {
+        const __m256i random = getBlockRandomAvx2(blockIndices, stuckRule);
+        const __m256i threshold = _mm256_set1_epi32(static_cast<int>(stuckRule.threshold));
+        const __m256i notStuckMask = _mm256_cmpeq_epi32(_mm256_max_epu32(random, threshold), random);
+        newState = _mm256_blendv_epi8(newState, three, _mm256_andnot_si256(notStuckMask, randomCaseMask));
+    }
+
+    newTop = _mm256_sllv_epi32(_mm256_and_si256(newState, three), shifts);
+    newBottom = _mm256_sllv_epi32(_mm256_srli_epi32(newState, 2), shifts);
+
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(randomCaseMask)));
+}
+
+__attribute__((target("avx2"))) static void transitionWordsAvx2(const uint32_t* sandTop,
+                                                               const uint32_t* sandBottom,
+                                                               const uint32_t* wallTop,
+                                                               const uint32_t* wallBottom,
+                                                               uint32_t* newSandTop,
+                                                               uint32_t* newSandBottom,
+                                                               uint32_t* randomCaseBlocks,
+                                                               size_t wordCount,
+                                                               uint32_t firstBlockIdx,
+                                                               const StuckRule& stuckRule)
+{
+    const __m256i shiftsLow = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m256i shiftsHigh = _mm256_setr_epi32(16, 18, 20, 22, 24, 26, 28, 30);
+    const __m256i blockOffsetsLow = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i blockOffsetsHigh = _mm256_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15);
+
+    for (size_t i = 0; i < wordCount; ++i)
+    {
+        const __m256i sT = _mm256_set1_epi32(static_cast<int>(sandTop[i]));
+        const __m256i sB = _mm256_set1_epi32(static_cast<int>(sandBottom[i]));
+        const __m256i wT = _mm256_set1_epi32(static_cast<int>(wallTop[i]));
+        const __m256i wB = _mm256_set1_epi32(static_cast<int>(wallBottom[i]));
+
+        const uint32_t wordFirstBlockIdx = firstBlockIdx + static_cast<uint32_t>(i) * BLOCKS_PER_WORD;
+        const __m256i wordFirstBlockIdxV = _mm256_set1_epi32(static_cast<int>(wordFirstBlockIdx));
+
+        __m256i topLow, bottomLow, topHigh, bottomHigh;
+        const uint32_t randomLow = transitionBlocksAvx2(sT,
+                                                        sB,
+                                                        wT,
+                                                        wB,
+                                                        shiftsLow,
+                                                        _mm256_add_epi32(wordFirstBlockIdxV, blockOffsetsLow),
+                                                        stuckRule,
+                                                        topLow,
+                                                        bottomLow);
+        const uint32_t randomHigh = transitionBlocksAvx2(sT,
+                                                         sB,
+                                                         wT,
+                                                         wB,
+                                                         shiftsHigh,
+                                                         _mm256_add_epi32(wordFirstBlockIdxV, blockOffsetsHigh),
+                                                         stuckRule,
+                                                         topHigh,
+                                                         bottomHigh);
+
+        newSandTop[i] = horizontalOrAvx2(_mm256_or_si256(topLow, topHigh));
+        newSandBottom[i] = horizontalOrAvx2(_mm256_or_si256(bottomLow, bottomHigh));
+        randomCaseBlocks[i] = randomLow | randomHigh << 8;
+    }
+}
+#endif
+
+static bool isAvx2Supported(void)
+{
+#ifdef VKHOURGLASS_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+SimdMargolusEngine::SimdMargolusEngine(bool enableHorizontalWrapping,
+                                       float stuckProbability,
+                                       const PackedGrid& cellGrid,
+                                       uint32_t seed,
+                                       size_t threadCount,
+                                       Kernel kernel,
+                                       uint32_t temporalSteps,
+                                       bool numaBands)
+    : _enableHorizontalWrapping(enableHorizontalWrapping)
+    , _stuckThreshold(getStuckThreshold(stuckProbability))
+    , _seed(seed)
+    , _kernel(kernel == Kernel::Avx2 && !isAvx2Supported() ? Kernel::Scalar : kernel)
+    , _cellBuffers({PackedGrid::createUninitialized(cellGrid.getWidth(), cellGrid.getHeight()),
+                    PackedGrid::createUninitialized(cellGrid.getWidth(), cellGrid.getHeight())})
+    , _currentBuffer(0)
+    , _generation(0)
+    , _tileColumnCount((cellGrid.getWordsPerRow() + TILE_WIDTH_WORDS - 1) / TILE_WIDTH_WORDS)
+    , _tileRowCount((cellGrid.getHeight() / 2 + TILE_HEIGHT_BLOCK_ROWS - 1) / TILE_HEIGHT_BLOCK_ROWS)
+    , _tileChangeGenerations(_tileColumnCount * _tileRowCount)
+    , _temporalSteps(temporalSteps)
+    , _gridMemoryTraffic(0)
+    , _numaBands(numaBands)
+    , _numaNodeCount(1)
+    , _threadPool(threadCount)
+{
+    assert(temporalSteps % 2 == 1 && temporalSteps <= MAX_TEMPORAL_STEPS
+           && "SimdMargolusEngine: Temporal steps have to be odd and at most MAX_CPU_TEMPORAL_STEPS!");
+
+    for (size_t thread = 0; thread <= getThreadCount(); ++thread)
+    {
+        _threadTileRows.push_back(thread * _tileRowCount / getThreadCount());
+    }
+
+    if (numaBands)
+    {
+        const std::vector<NumaTopology::Node> nodes = NumaTopology::getNodes();
+        const std::vector<uint32_t> threadCpus = NumaTopology::getThreadCpus(nodes, getThreadCount());
+        _numaNodeCount = std::min(nodes.size(), getThreadCount());
+
+        // NOTE(MM): Includes the calling thread, which stays pinned to the first CPU after the engine is gone.
+        std::atomic<bool> isPinned(true);
+        _threadPool.runOnEachThread([&](size_t thread) {
+            if (!NumaTopology::pinCurrentThread(threadCpus[thread]))
+            {
+                isPinned.store(false);
+            }
+        });
+        if (!isPinned.load())
+        {
+            fprintf(stderr, "Failed to pin the CPU threads, their bands may be placed on other NUMA nodes!\n");
+        }
+    }
+
+    // The pages of the cell buffers are placed by the thread writing them first, which is the owner of the band.
+    _threadPool.runOnEachThread([&](size_t thread) {
+        const auto [beginRow, endRow] = getThreadRows(thread);
+        const size_t beginWord = beginRow * cellGrid.getWordsPerRow();
+        const size_t wordCount = (endRow - beginRow) * cellGrid.getWordsPerRow();
+        for (PackedGrid& cells : _cellBuffers)
+        {
+            for (const size_t planeOffset : {size_t{0}, cellGrid.getPlaneWordCount()})
+            {
+                std::copy_n(cellGrid.getData().data() + planeOffset + beginWord,
+                            wordCount,
+                            cells.getData().data() + planeOffset + beginWord);
+            }
+        }
+    });
+
+    // NOTE(MM): Higher bands compute less halo rows per row, but each thread needs a band of its own.
+    const size_t rowSize = cellGrid.getWordsPerRow() * sizeof(uint32_t) * 3;
+    const size_t haloSize = getTemporalHaloRows(temporalSteps) * 2 * rowSize;
+    const size_t tileRowSize = TILE_HEIGHT_BLOCK_ROWS * 2 * rowSize;
+    const size_t fittingTileRows =
+        ApplicationDefines::CPU_TEMPORAL_BAND_SIZE > haloSize
+            ? (ApplicationDefines::CPU_TEMPORAL_BAND_SIZE - haloSize) / tileRowSize
+            : 0;
+    const size_t tileRowsPerThread = (_tileRowCount + getThreadCount() - 1) / getThreadCount();
+    _temporalBandTileRows = std::max<size_t>(std::min(fittingTileRows, tileRowsPerThread), 1);
+    _temporalBandCount = (_tileRowCount + _temporalBandTileRows - 1) / _temporalBandTileRows;
+
+    // NOTE(MM): All tiles "changed" in generation 0, so that the first two generations are computed completely.
+    for (auto& tileChangeGeneration : _tileChangeGenerations)
+    {
+        tileChangeGeneration.store(0, std::memory_order_relaxed);
+    }
+    updateActiveTileRuns();
+}
+
+void SimdMargolusEngine::step(void)
+{
+    const uint32_t cellOffset = static_cast<uint32_t>(_currentBuffer);
+    const PackedGrid& cellsIn = _cellBuffers[_currentBuffer];
+    PackedGrid& cellsOut = _cellBuffers[!_currentBuffer];
+    ++_generation;
+
+    // NOTE(MM): With an offset, the first row isn't part of any block. The last row is handled by the last block row.
+    if (cellOffset > 0)
+    {
+        std::copy_n(cellsIn.getSandPlane(), cellsIn.getWordsPerRow(), cellsOut.getSandPlane());
+    }
+
+    // Each updated word reads both planes of both rows and writes the sand of both rows.
+    const size_t blockRowCount = cellsIn.getHeight() / 2;
+    for (const TileRun& tileRun : _activeTileRuns)
+    {
+        const size_t wordCount =
+            std::min<size_t>(tileRun.endColumn * TILE_WIDTH_WORDS, cellsIn.getWordsPerRow())
+            - tileRun.beginColumn * TILE_WIDTH_WORDS;
+        const size_t beginBlockRow = tileRun.tileRow * TILE_HEIGHT_BLOCK_ROWS;
+        const size_t runBlockRowCount = std::min(beginBlockRow + TILE_HEIGHT_BLOCK_ROWS, blockRowCount) - beginBlockRow;
+        _gridMemoryTraffic += wordCount * runBlockRowCount * 6 * sizeof(uint32_t);
+    }
+
+    parallelForTileRows(
+        _activeTileRuns.size(),
+        [this](size_t run) { return _activeTileRuns[run].tileRow; },
+        [&](size_t begin, size_t end) { updateTileRuns(begin, end, cellOffset); });
+    updateActiveTileRuns();
+
+    _currentBuffer = !_currentBuffer;
+}
+
+void SimdMargolusEngine::step(size_t count)
+{
+    size_t remaining = count;
+    if (_temporalSteps > 1)
+    {
+        for (; remaining >= _temporalSteps; remaining -= _temporalSteps)
+        {
+            stepTemporal();
+        }
+    }
+
+    for (; remaining > 0; --remaining)
+    {
+        step();
+    }
+}
+
+const PackedGrid& SimdMargolusEngine::getCells(void) const
+{
+    return _cellBuffers[_currentBuffer];
+}
+
+size_t SimdMargolusEngine::getCurrentBuffer(void) const
+{
+    return _currentBuffer;
+}
+
+SimdMargolusEngine::Kernel SimdMargolusEngine::getKernel(void) const
+{
+    return _kernel;
+}
+
+const char* SimdMargolusEngine::getKernelName(void) const
+{
+    switch (_kernel)
+    {
+    case Kernel::Scalar:
+        return "scalar";
+    case Kernel::Avx2:
+        return "AVX2";
+    case Kernel::BitSliced:
+        return "bit-sliced";
+    }
+
+    return "unknown";
+}
+
+size_t SimdMargolusEngine::getThreadCount(void) const
+{
+    return _threadPool.getThreadCount();
+}
+
+uint32_t SimdMargolusEngine::getTemporalSteps(void) const
+{
+    return _temporalSteps;
+}
+
+bool SimdMargolusEngine::isUsingNumaBands(void) const
+{
+    return _numaBands;
+}
+
+size_t SimdMargolusEngine::getNumaNodeCount(void) const
+{
+    return _numaNodeCount;
+}
+
+size_t SimdMargolusEngine::getActiveTileCount(void) const
+{
+    return _activeTileCount;
+}
+
+size_t SimdMargolusEngine::getTileCount(void) const
+{
+    return _tileChangeGenerations.size();
+}
+
+uint64_t SimdMargolusEngine::getGridMemoryTraffic(void) const
+{
+    return _gridMemoryTraffic;
+}
+
+std::pair<size_t, size_t> SimdMargolusEngine::getThreadRows(size_t thread) const
+{
+    // NOTE(MM): The last thread also gets the rows below the last tile row, if any.
+    const size_t tileRowHeight = TILE_HEIGHT_BLOCK_ROWS * 2;
+    const size_t height = _cellBuffers[0].getHeight();
+    const size_t beginRow = std::min(_threadTileRows[thread] * tileRowHeight, height);
+    const size_t endRow = thread + 1 < getThreadCount() ? std::min(_threadTileRows[thread + 1] * tileRowHeight, height)
+                                                        : height;
+    return {beginRow, endRow};
+}
+
+void SimdMargolusEngine::parallelForTileRows(size_t count,
+                                             const std::function<size_t(size_t)>& getTileRow,
+                                             const std::function<void(size_t, size_t)>& task)
+{
+    if (!_numaBands)
+    {
+        _threadPool.parallelFor(count, task);
+        return;
+    }
+
+    // First item at or after `tileRow`.
+    const auto findItem = [&](size_t tileRow) {
+        size_t low = 0;
+        size_t high = count;
+        while (low < high)
+        {
+            const size_t middle = (low + high) / 2;
+            if (getTileRow(middle) < tileRow)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return low;
+    };
+
+    _threadPool.runOnEachThread([&](size_t thread) {
+        const size_t begin = findItem(_threadTileRows[thread]);
+        const size_t end = findItem(_threadTileRows[thread + 1]);
+        if (begin < end)
+        {
+            task(begin, end);
+        }
+    });
+}
+
+bool SimdMargolusEngine::isTileChangedNear(int64_t tileX, int64_t tileY, int64_t distance) const
+{
+    const auto columnCount = static_cast<int64_t>(_tileColumnCount);
+    const auto rowCount = static_cast<int64_t>(_tileRowCount);
+
+    for (int64_t y = std::max<int64_t>(tileY - distance, 0); y <= std::min(tileY + distance, rowCount - 1); ++y)
+    {
+        for (int64_t x = tileX - distance; x <= tileX + distance; ++x)
+        {
+            if (!_enableHorizontalWrapping && (x < 0 || x >= columnCount))
+            {
+                continue;
+            }
+
+            const auto neighbour = static_cast<size_t>(y * columnCount + (x % columnCount + columnCount) % columnCount);
+            const uint32_t changeGeneration = _tileChangeGenerations[neighbour].load(std::memory_order_relaxed);
+            if (_generation - changeGeneration <= 1)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void SimdMargolusEngine::appendTileRun(std::vector<TileRun>& tileRuns, uint32_t tileRow, uint32_t tileColumn)
+{
+    if (!tileRuns.empty() && tileRuns.back().tileRow == tileRow && tileRuns.back().endColumn == tileColumn)
+    {
+        ++tileRuns.back().endColumn;
+    }
+    else
+    {
+        tileRuns.push_back({tileRow, tileColumn, tileColumn + 1});
+    }
+}
+
+void SimdMargolusEngine::updateActiveTileRuns(void)
+{
+    _activeTileRuns.clear();
+    _activeTileCount = 0;
+
+    for (size_t tileY = 0; tileY < _tileRowCount; ++tileY)
+    {
+        for (size_t tileX = 0; tileX < _tileColumnCount; ++tileX)
+        {
+            // Same as 'shaders/activeTiles.comp': A tile is active if it or one of its neighbours changed within the
+            // last two generations.
+            if (isTileChangedNear(static_cast<int64_t>(tileX), static_cast<int64_t>(tileY), 1))
+            {
+                ++_activeTileCount;
+                appendTileRun(_activeTileRuns, static_cast<uint32_t>(tileY), static_cast<uint32_t>(tileX));
+            }
+        }
+    }
+}
+
+void SimdMargolusEngine::updateTileRuns(size_t beginRun, size_t endRun, uint32_t cellOffset)
+{
+    const PackedGrid& cellsIn = _cellBuffers[_currentBuffer];
+    PackedGrid& cellsOut = _cellBuffers[!_currentBuffer];
+    const size_t wordsPerRow = cellsIn.getWordsPerRow();
+    const size_t blockRowCount = cellsIn.getHeight() / 2;
+    const BlockRowTarget target{cellsIn.getSandPlane(),
+                                cellsIn.getWallPlane(),
+                                cellsOut.getSandPlane(),
+                                cellsIn.getHeight(),
+                                0,
+                                0,
+                                cellsIn.getHeight(),
+                                _generation};
+
+    // NOTE(MM): Scratch rows for the offset case and the random case flags, see 'updateBlockRowWords()'.
+    std::vector<uint32_t> scratch((wordsPerRow + 1) * SCRATCH_ROW_COUNT);
+
+    for (size_t run = beginRun; run < endRun; ++run)
+    {
+        const TileRun& tileRun = _activeTileRuns[run];
+        const size_t beginWord = tileRun.beginColumn * TILE_WIDTH_WORDS;
+        const size_t endWord = std::min<size_t>(tileRun.endColumn * TILE_WIDTH_WORDS, wordsPerRow);
+        const size_t beginBlockRow = tileRun.tileRow * TILE_HEIGHT_BLOCK_ROWS;
+        const size_t endBlockRow = std::min(beginBlockRow + TILE_HEIGHT_BLOCK_ROWS, blockRowCount);
+
+        for (size_t blockRow = beginBlockRow; blockRow < endBlockRow; ++blockRow)
+        {
+            updateBlockRowWords(target, blockRow, beginWord, endWord, cellOffset, scratch.data());
+        }
+    }
+}
+
+void SimdMargolusEngine::updateBlockRowWords(const BlockRowTarget& target,
+                                             size_t blockRow,
+                                             size_t beginWord,
+                                             size_t endWord,
+                                             uint32_t cellOffset,
+                                             uint32_t* scratch)
+{
+    const size_t wordsPerRow = _cellBuffers[0].getWordsPerRow();
+    const uint32_t blocksPerRow = _cellBuffers[0].getWidth() / 2;
+    const size_t wordCount = endWord - beginWord;
+
+    const size_t topRow = blockRow * 2 + cellOffset;
+    const size_t rowIdx = topRow * wordsPerRow;
+    uint32_t* outTop = target.sandOut + rowIdx;
+
+    if (topRow + 1 >= target.rowCount)
+    {
+        std::copy_n(target.sandIn + rowIdx + beginWord, wordCount, outTop + beginWord);
+        return;
+    }
+
+    TransitionWordsFunction transitionWords = transitionWordsScalar;
+    if (_kernel == Kernel::BitSliced)
+    {
+        transitionWords = transitionWordsBitSliced;
+    }
+#ifdef VKHOURGLASS_X86
+    else if (_kernel == Kernel::Avx2)
+    {
+        transitionWords = transitionWordsAvx2;
+    }
+#endif
+
+    const uint32_t* sandTop = target.sandIn + rowIdx;
+    const uint32_t* sandBottom = sandTop + wordsPerRow;
+    const uint32_t* wallTop = target.wallIn + rowIdx;
+    const uint32_t* wallBottom = wallTop + wordsPerRow;
+    uint32_t* outBottom = outTop + wordsPerRow;
+
+    const auto rowFirstBlockIdx = static_cast<uint32_t>(target.firstRow / 2 + blockRow) * blocksPerRow;
+    const StuckRule stuckRule{_seed, target.generation, _stuckThreshold};
+
+    // NOTE(MM): Scratch rows hold one word more than the range to update, see below.
+    const size_t scratchSize = wordsPerRow + 1;
+    uint32_t* alignedSandTop = scratch;
+    uint32_t* alignedSandBottom = alignedSandTop + scratchSize;
+    uint32_t* alignedWallTop = alignedSandBottom + scratchSize;
+    uint32_t* alignedWallBottom = alignedWallTop + scratchSize;
+    uint32_t* newAlignedTop = alignedWallBottom + scratchSize;
+    uint32_t* newAlignedBottom = newAlignedTop + scratchSize;
+    uint32_t* randomCaseBlocks = newAlignedBottom + scratchSize;
+
+    // Flags the words of a row whose cells changed (or which contain blocks in the random case, which may change in
+    // any later generation) in their tiles.
+    const auto markChangedTiles = [&](size_t row, const uint32_t* oldWords, const uint32_t* newWords, auto isRandom) {
+        const size_t gridRow = target.firstRow + row;
+        if (gridRow < target.beginTrackedRow || gridRow >= target.endTrackedRow)
+        {
+            return;
+        }
+
+        const size_t tileRowIdx = gridRow / 2 / TILE_HEIGHT_BLOCK_ROWS * _tileColumnCount;
+        for (size_t word = beginWord; word < endWord; ++word)
+        {
+            if (oldWords[word] != newWords[word] || isRandom(word))
+            {
+                _tileChangeGenerations[tileRowIdx + word / TILE_WIDTH_WORDS].store(target.generation,
+                                                                                   std::memory_order_relaxed);
+            }
+        }
+    };
+
+    if (cellOffset == 0)
+    {
+        transitionWords(sandTop + beginWord,
+                        sandBottom + beginWord,
+                        wallTop + beginWord,
+                        wallBottom + beginWord,
+                        outTop + beginWord,
+                        outBottom + beginWord,
+                        randomCaseBlocks,
+                        wordCount,
+                        rowFirstBlockIdx + static_cast<uint32_t>(beginWord) * BLOCKS_PER_WORD,
+                        stuckRule);
+
+        const auto isRandom = [&](size_t word) {
+            return randomCaseBlocks[word - beginWord] != 0;
+        };
+        markChangedTiles(topRow, sandTop, outTop, isRandom);
+        markChangedTiles(topRow + 1, sandBottom, outBottom, isRandom);
+        return;
+    }
+
+    // NOTE(MM): With an offset, blocks start at odd columns. Shift the rows by one cell (pulling in the first cell of
+    // the next word) to get blocks at even bits again, update them like without offset and shift back. Without
+    // wrapping, the last cell of a row isn't part of a block and zero is pulled in instead.
+    // Scratch index 0 holds the word before the range (if there is one), as the last block of it covers the first
+    // cell of the range.
+    const bool hasPreviousWord = beginWord > 0 || _enableHorizontalWrapping;
+    const size_t previousWord = beginWord > 0 ? beginWord - 1 : wordsPerRow - 1;
+
+    const auto alignWord = [&](const uint32_t* row, size_t word) {
+        uint32_t next = 0;
+        if (word + 1 < wordsPerRow)
+        {
+            next = row[word + 1];
+        }
+        else if (_enableHorizontalWrapping)
+        {
+            next = row[0];
+        }
+        return (row[word] >> 1) | (next << 31);
+    };
+    const auto alignWords = [&](size_t scratchIdx, size_t word) {
+        alignedSandTop[scratchIdx] = alignWord(sandTop, word);
+        alignedSandBottom[scratchIdx] = alignWord(sandBottom, word);
+        alignedWallTop[scratchIdx] = alignWord(wallTop, word);
+        alignedWallBottom[scratchIdx] = alignWord(wallBottom, word);
+    };
+    const auto transitionAlignedWords = [&](size_t scratchIdx, size_t word, size_t count) {
+        transitionWords(alignedSandTop + scratchIdx,
+                        alignedSandBottom + scratchIdx,
+                        alignedWallTop + scratchIdx,
+                        alignedWallBottom + scratchIdx,
+                        newAlignedTop + scratchIdx,
+                        newAlignedBottom + scratchIdx,
+                        randomCaseBlocks + scratchIdx,
+                        count,
+                        rowFirstBlockIdx + static_cast<uint32_t>(word) * BLOCKS_PER_WORD,
+                        stuckRule);
+    };
+
+    if (hasPreviousWord)
+    {
+        alignWords(0, previousWord);
+        transitionAlignedWords(0, previousWord, 1);
+    }
+    else
+    {
+        randomCaseBlocks[0] = 0;
+    }
+
+    for (size_t word = beginWord; word < endWord; ++word)
+    {
+        alignWords(word - beginWord + 1, word);
+    }
+    transitionAlignedWords(1, beginWord, wordCount);
+
+    if (!_enableHorizontalWrapping && endWord == wordsPerRow)
+    {
+        // The last block of a row isn't valid, restore it.
+        constexpr uint32_t lastBlockMask = 3u << 30;
+        newAlignedTop[wordCount] =
+            (newAlignedTop[wordCount] & ~lastBlockMask) | (alignedSandTop[wordCount] & lastBlockMask);
+        newAlignedBottom[wordCount] =
+            (newAlignedBottom[wordCount] & ~lastBlockMask) | (alignedSandBottom[wordCount] & lastBlockMask);
+        randomCaseBlocks[wordCount] &= ~(1u << (BLOCKS_PER_WORD - 1));
+    }
+
+    for (size_t word = beginWord; word < endWord; ++word)
+    {
+        const size_t scratchIdx = word - beginWord + 1;
+
+        uint32_t firstCellTop = sandTop[0] & 1;
+        uint32_t firstCellBottom = sandBottom[0] & 1;
+        if (word > beginWord || hasPreviousWord)
+        {
+            firstCellTop = newAlignedTop[scratchIdx - 1] >> 31;
+            firstCellBottom = newAlignedBottom[scratchIdx - 1] >> 31;
+        }
+
+        outTop[word] = (newAlignedTop[scratchIdx] << 1) | firstCellTop;
+        outBottom[word] = (newAlignedBottom[scratchIdx] << 1) | firstCellBottom;
+    }
+
+    // NOTE(MM): The last block of the previous (aligned) word covers the first cell of a word.
+    const auto isRandom = [&](size_t word) {
+        const size_t scratchIdx = word - beginWord + 1;
+        return randomCaseBlocks[scratchIdx] != 0 || (randomCaseBlocks[scratchIdx - 1] >> (BLOCKS_PER_WORD - 1)) != 0;
+    };
+    markChangedTiles(topRow, sandTop, outTop, isRandom);
+    markChangedTiles(topRow + 1, sandBottom, outBottom, isRandom);
+}
+
+void SimdMargolusEngine::stepTemporal(void)
+{
+    PackedGrid& cellsIn = _cellBuffers[_currentBuffer];
+    PackedGrid& cellsOut = _cellBuffers[!_currentBuffer];
+    const size_t wordsPerRow = cellsIn.getWordsPerRow();
+    const size_t height = cellsIn.getHeight();
+    const size_t haloRows = getTemporalHaloRows(_temporalSteps);
+
+    updateTemporalTileRuns();
+
+    // NOTE(MM): Bands only read the input buffer and write their own rows of the output buffer, so they are
+    // independent.
+    const auto getBandTileRow = [this](size_t band) { return band * _temporalBandTileRows; };
+    parallelForTileRows(_temporalBandCount, getBandTileRow, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> bandCells;
+        std::vector<uint32_t> scratch((wordsPerRow + 1) * SCRATCH_ROW_COUNT);
+        for (size_t band = begin; band < end; ++band)
+        {
+            if (isTemporalBandActive(band))
+            {
+                updateTemporalBand(band, bandCells, scratch.data());
+            }
+        }
+    });
+
+    // Tiles skipped by the next generation have to be the same in both buffers (see `step()`), but the input buffer
+    // can only be updated once no band reads its halo from it anymore.
+    parallelForTileRows(_temporalBandCount, getBandTileRow, [&](size_t begin, size_t end) {
+        for (size_t band = begin; band < end; ++band)
+        {
+            if (isTemporalBandActive(band))
+            {
+                const auto [beginRow, endRow] = getTemporalBandRows(band);
+                std::copy_n(cellsOut.getSandPlane() + beginRow * wordsPerRow,
+                            (endRow - beginRow) * wordsPerRow,
+                            cellsIn.getSandPlane() + beginRow * wordsPerRow);
+            }
+        }
+    });
+
+    // Each band reads both planes of its rows and halo, writes its sand rows to the output buffer and copies them to
+    // the input buffer.
+    for (size_t band = 0; band < _temporalBandCount; ++band)
+    {
+        if (isTemporalBandActive(band))
+        {
+            const auto [beginRow, endRow] = getTemporalBandRows(band);
+            const size_t bandRowCount = std::min(endRow + haloRows, height) - (beginRow - std::min(beginRow, haloRows));
+            _gridMemoryTraffic += (bandRowCount * 2 + (endRow - beginRow) * 3) * wordsPerRow * sizeof(uint32_t);
+        }
+    }
+
+    // NOTE(MM): Temporal steps are odd, so the partition offset of the next generation is the buffer index again.
+    _generation += _temporalSteps;
+    _currentBuffer = !_currentBuffer;
+    updateActiveTileRuns();
+}
+
+void SimdMargolusEngine::updateTemporalTileRuns(void)
+{
+    _temporalTileRuns.clear();
+    _temporalTileRunOffsets.assign(1, 0);
+
+    // NOTE(MM): Active tiles are the only ones which may change in the next generation, and changes spread by a cell
+    // per generation at most. A round has less generations than a tile is wide or high, so tiles which aren't next to
+    // an active one at its beginning don't change within it.
+    for (size_t tileY = 0; tileY < _tileRowCount; ++tileY)
+    {
+        for (size_t tileX = 0; tileX < _tileColumnCount; ++tileX)
+        {
+            if (isTileChangedNear(static_cast<int64_t>(tileX), static_cast<int64_t>(tileY), 2))
+            {
+                appendTileRun(_temporalTileRuns, static_cast<uint32_t>(tileY), static_cast<uint32_t>(tileX));
+            }
+        }
+        _temporalTileRunOffsets.push_back(_temporalTileRuns.size());
+    }
+}
+
+std::pair<size_t, size_t> SimdMargolusEngine::getTemporalBandRows(size_t band) const
+{
+    const size_t bandRowCount = _temporalBandTileRows * TILE_HEIGHT_BLOCK_ROWS * 2;
+    const size_t beginRow = band * bandRowCount;
+    return {beginRow, std::min<size_t>(beginRow + bandRowCount, _cellBuffers[0].getHeight())};
+}
+
+bool SimdMargolusEngine::isTemporalBandActive(size_t band) const
+{
+    // NOTE(MM): The block rows of the neighbouring tile rows cover the first and last row of a band with an offset.
+    const size_t beginTileRow = band * _temporalBandTileRows;
+    const size_t endTileRow = std::min(beginTileRow + _temporalBandTileRows + 1, _tileRowCount);
+    return _temporalTileRunOffsets[endTileRow] > _temporalTileRunOffsets[beginTileRow > 0 ? beginTileRow - 1 : 0];
+}
+
+void SimdMargolusEngine::updateTemporalBand(size_t band, std::vector<uint32_t>& bandCells, uint32_t* scratch)
+{
+    const PackedGrid& cellsIn = _cellBuffers[_currentBuffer];
+    PackedGrid& cellsOut = _cellBuffers[!_currentBuffer];
+    const size_t wordsPerRow = cellsIn.getWordsPerRow();
+    const size_t height = cellsIn.getHeight();
+    const size_t haloRows = getTemporalHaloRows(_temporalSteps);
+
+    const auto [beginRow, endRow] = getTemporalBandRows(band);
+    const size_t firstRow = beginRow - std::min(beginRow, haloRows);
+    const size_t rowCount = std::min(endRow + haloRows, height) - firstRow;
+    const size_t planeWordCount = rowCount * wordsPerRow;
+
+    // Sand of the current and the next generation (alternating), followed by the walls.
+    bandCells.resize(planeWordCount * 3);
+    uint32_t* const sand[2] = {bandCells.data(), bandCells.data() + planeWordCount};
+    uint32_t* const wall = sand[1] + planeWordCount;
+    std::copy_n(cellsIn.getSandPlane() + firstRow * wordsPerRow, planeWordCount, sand[0]);
+    std::copy_n(sand[0], planeWordCount, sand[1]);
+    std::copy_n(cellsIn.getWallPlane() + firstRow * wordsPerRow, planeWordCount, wall);
+
+    for (uint32_t step = 0; step < _temporalSteps; ++step)
+    {
+        const auto cellOffset = static_cast<uint32_t>((_currentBuffer + step) % 2);
+        const BlockRowTarget target{
+            sand[step % 2], wall, sand[(step + 1) % 2], rowCount, firstRow, beginRow, endRow, _generation + step + 1};
+
+        // NOTE(MM): Like in `step()`, except that the first row is only a halo row unless the band is the first one.
+        if (cellOffset > 0)
+        {
+            std::copy_n(target.sandIn, wordsPerRow, target.sandOut);
+        }
+
+        // Only the block rows covering the rows the band depends on in the remaining generations are needed.
+        const size_t margin = _temporalSteps - 1 - step;
+        const size_t beginNeededRow = beginRow - std::min(beginRow, firstRow + margin);
+        const size_t endNeededRow = std::min(endRow + margin, firstRow + rowCount) - firstRow;
+        const size_t beginBlockRow = beginNeededRow > cellOffset ? (beginNeededRow - cellOffset) / 2 : 0;
+        const size_t endBlockRow = std::min((endNeededRow - cellOffset + 1) / 2, rowCount / 2);
+
+        for (size_t blockRow = beginBlockRow; blockRow < endBlockRow; ++blockRow)
+        {
+            const size_t tileRow = (firstRow / 2 + blockRow) / TILE_HEIGHT_BLOCK_ROWS;
+            for (size_t run = _temporalTileRunOffsets[tileRow]; run < _temporalTileRunOffsets[tileRow + 1]; ++run)
+            {
+                const TileRun& tileRun = _temporalTileRuns[run];
+                const size_t beginWord = tileRun.beginColumn * TILE_WIDTH_WORDS;
+                const size_t endWord = std::min<size_t>(tileRun.endColumn * TILE_WIDTH_WORDS, wordsPerRow);
+                updateBlockRowWords(target, blockRow, beginWord, endWord, cellOffset, scratch);
+            }
+        }
+    }
+
+    // NOTE(MM): Odd temporal steps, hence the last generation is in `sand[1]`.
+    std::copy_n(sand[1] + (beginRow - firstRow) * wordsPerRow,
+                (endRow - beginRow) * wordsPerRow,
+                cellsOut.getSandPlane() + beginRow * wordsPerRow);
+}
+
+} // namespace VkHourglass
@@ -0,0 +1,183 @@
+#ifndef VULKANHOURGLASS_SIMDMARGOLUSENGINE_HPP
+#define VULKANHOURGLASS_SIMDMARGOLUSENGINE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "PackedGrid.hpp"
+#include "ThreadPool.hpp"
+
+namespace VkHourglass
+{
+
+// Multithreaded CPU implementation of the cell transitions in 'shaders/shader.comp', bit identical to
+// `MargolusEngine` (and thus the GPU) when given the same seed.
+//
+// Works directly on the bit-packed planes. By default, 64 blocks are updated at once via boolean expressions generated
+// from the transition table (bit-slicing, see 'tools/generateStateTransitionLogic.cpp'). Alternatively, one word of a
+// block row (16 blocks) is updated at once with the table lookups of its blocks vectorized via AVX2 gathers (or scalar
+// lookups). Blocks of a generation are independent, hence block rows are distributed over a thread pool.
+//
+// Like the GPU path, only tiles with changes in their neighbourhood within the last two generations are updated (see
+// 'shaders/tiles.comp'), so the cost of a generation scales with the amount of moving sand instead of the grid size.
+//
+// With temporal blocking (`temporalSteps` > 1), each generation no longer streams the active tiles through memory.
+// Instead, the grid is processed in bands of tile rows, which are copied into cache sized buffers (see
+// `ApplicationDefines::CPU_TEMPORAL_BAND_SIZE`) together with a halo of `temporalSteps` rows above and below and
+// advanced by `temporalSteps` generations at once. Cells depend on at most one neighbouring cell per generation, so
+// the rows needed for the band shrink by a row per generation towards it (a trapezoid in space-time), and the band is
+// exact when written back. The halos are computed redundantly by the neighbouring bands, like the halos of the temporal
+// tiles of 'shaders/shader.comp'.
+//
+// With NUMA bands (`numaBands`), each thread is pinned to a CPU, spread evenly over the NUMA nodes (see
+// NumaTopology.hpp), and owns a fixed band of tile rows instead of taking chunks of work from the pool. The cell
+// buffers are written first by the owning threads, so the pages of a band are placed on the node of its thread. A block
+// row only reaches into the neighbouring band at its border rows (with an offset), hence only these rows are shared
+// between nodes from one generation (or temporal round) to the next. The work isn't balanced between threads anymore,
+// which pays off once a single memory controller can't keep up with all cores.
+class SimdMargolusEngine
+{
+public:
+    enum class Kernel
+    {
+        Scalar,
+        Avx2,
+        BitSliced,
+    };
+
+    // A `threadCount` of 0 uses all hardware threads. Falls back to `Kernel::Scalar` if `kernel` isn't supported by
+    // the CPU. `Kernel::BitSliced` is the fastest one and doesn't require any CPU extensions. `temporalSteps` has to be
+    // odd and at most `ApplicationDefines::NonModifiable::MAX_CPU_TEMPORAL_STEPS`. `seed` is the key of the random
+    // numbers, see `MargolusEngine`.
+    SimdMargolusEngine(bool enableHorizontalWrapping,
+                       float stuckProbability,
+                       const PackedGrid& cellGrid,
+                       uint32_t seed,
+                       size_t threadCount,
+                       Kernel kernel,
+                       uint32_t temporalSteps,
+                       bool numaBands);
+
+    // Perform a single generation, see `MargolusEngine::step()`.
+    void step(void);
+    // Perform `count` generations. With temporal blocking, they are computed `getTemporalSteps()` at a time, the
+    // remaining ones as single generations. Only the cells of the last generation can be observed.
+    void step(size_t count);
+
+    const PackedGrid& getCells(void) const;
+    size_t getCurrentBuffer(void) const;
+
+    Kernel getKernel(void) const;
+    const char* getKernelName(void) const;
+    size_t getThreadCount(void) const;
+    uint32_t getTemporalSteps(void) const;
+    bool isUsingNumaBands(void) const;
+    // Number of NUMA nodes the threads are spread over, 1 without NUMA bands.
+    size_t getNumaNodeCount(void) const;
+
+    // Number of tiles updated by the next generation.
+    size_t getActiveTileCount(void) const;
+    size_t getTileCount(void) const;
+
+    // Bytes of the cell buffers read and written by all generations so far, counting each accessed word once per
+    // generation (or temporal round), i.e. assuming nothing stays cached in between. Compares the memory traffic of
+    // temporal blocking to single generations.
+    uint64_t getGridMemoryTraffic(void) const;
+
+private:
+    // Consecutive active tiles of a tile row.
+    struct TileRun
+    {
+        uint32_t tileRow;
+        uint32_t beginColumn;
+        uint32_t endColumn;
+    };
+
+    // Rows a generation is computed on, either the cell buffers or a band copied for temporal blocking. Changes of the
+    // grid rows `[beginTrackedRow, endTrackedRow)` are tracked in the tiles.
+    struct BlockRowTarget
+    {
+        const uint32_t* sandIn;
+        const uint32_t* wallIn;
+        uint32_t* sandOut;
+        size_t rowCount;
+        // Grid row of the first row (even, so that the partition offset is the same).
+        size_t firstRow;
+        size_t beginTrackedRow;
+        size_t endTrackedRow;
+        uint32_t generation;
+    };
+
+    // Grid rows `[first, second)` first written by `thread`, its band with NUMA bands.
+    std::pair<size_t, size_t> getThreadRows(size_t thread) const;
+    // Call `task(begin, end)` for chunks of `[0, count)`, whose items have to be sorted by `getTileRow(item)`. With
+    // NUMA bands, each thread gets the items in its own tile rows, otherwise the pool distributes them.
+    void parallelForTileRows(size_t count,
+                             const std::function<size_t(size_t)>& getTileRow,
+                             const std::function<void(size_t, size_t)>& task);
+
+    // Whether a tile within `distance` tiles of the given one changed within the last two generations.
+    bool isTileChangedNear(int64_t tileX, int64_t tileY, int64_t distance) const;
+    // NOTE(MM): Neighbouring tiles of a tile row are merged, so that the kernels process as many words at once as
+    // possible.
+    static void appendTileRun(std::vector<TileRun>& tileRuns, uint32_t tileRow, uint32_t tileColumn);
+    void updateActiveTileRuns(void);
+    void updateTileRuns(size_t beginRun, size_t endRun, uint32_t cellOffset);
+    void updateBlockRowWords(const BlockRowTarget& target,
+                             size_t blockRow,
+                             size_t beginWord,
+                             size_t endWord,
+                             uint32_t cellOffset,
+                             uint32_t* scratch);
+
+    // Temporal blocking, see above: Computes `_temporalSteps` generations band by band.
+    void stepTemporal(void);
+    void updateTemporalTileRuns(void);
+    // Grid rows `[first, second)` of a band.
+    std::pair<size_t, size_t> getTemporalBandRows(size_t band) const;
+    bool isTemporalBandActive(size_t band) const;
+    void updateTemporalBand(size_t band, std::vector<uint32_t>& bandCells, uint32_t* scratch);
+
+    const bool _enableHorizontalWrapping;
+    const uint32_t _stuckThreshold;
+    const uint32_t _seed;
+    const Kernel _kernel;
+
+    std::array<PackedGrid, 2> _cellBuffers;
+    size_t _currentBuffer;
+
+    // NOTE(MM): Counts generations like 'PushConstants::generation'. Tiles store the generation they changed the last
+    // time in, written concurrently by the workers.
+    uint32_t _generation;
+    const size_t _tileColumnCount;
+    const size_t _tileRowCount;
+    std::vector<std::atomic<uint32_t>> _tileChangeGenerations;
+    std::vector<TileRun> _activeTileRuns;
+    size_t _activeTileCount;
+
+    const uint32_t _temporalSteps;
+    // NOTE(MM): Tiles updated by a temporal round, i.e. the ones which may change within its generations. Runs of tile
+    // row `r` are `[_temporalTileRunOffsets[r], _temporalTileRunOffsets[r + 1])`.
+    std::vector<TileRun> _temporalTileRuns;
+    std::vector<size_t> _temporalTileRunOffsets;
+    size_t _temporalBandTileRows;
+    size_t _temporalBandCount;
+
+    uint64_t _gridMemoryTraffic;
+
+    const bool _numaBands;
+    size_t _numaNodeCount;
+
+    ThreadPool _threadPool;
+    // NOTE(MM): Thread `t` owns the tile rows `[_threadTileRows[t], _threadTileRows[t + 1])`.
+    std::vector<size_t> _threadTileRows;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_SIMDMARGOLUSENGINE_HPP
@@ -3,9 +3,9 @@
 namespace VkHourglass
 {
 
-std::array<VkSpecializationMapEntry, 5> ComputeSpecializationConstants::getSpecializationMapEntries(void)
+std::array<VkSpecializationMapEntry, 10> ComputeSpecializationConstants::getSpecializationMapEntries(void)
 {
-    std::array<VkSpecializationMapEntry, 5> constants;
+    std::array<VkSpecializationMapEntry, 10> constants;
 
     constants[0].constantID = 0;
     constants[0].offset = 0;
@@ -24,15 +24,35 @@ std::array<VkSpecializationMapEntry, 5> ComputeSpecializationConstants::getSpeci
     constants[3].size = sizeof(uint32_t);
 
     constants[4].constantID = 4;
-    constants[4].offset = offsetof(ComputeSpecializationConstants, stuckProbability);
-    constants[4].size = sizeof(float);
+    constants[4].offset = offsetof(ComputeSpecializationConstants, stuckThreshold);
+    constants[4].size = sizeof(uint32_t);
+
+    constants[5].constantID = 5;
+    constants[5].offset = offsetof(ComputeSpecializationConstants, tileWidthWords);
+    constants[5].size = sizeof(uint32_t);
+
+    constants[6].constantID = 6;
+    constants[6].offset = offsetof(ComputeSpecializationConstants, useSharedMemoryTiles);
+    constants[6].size = sizeof(uint32_t);
+
+    constants[7].constantID = 7;
+    constants[7].offset = offsetof(ComputeSpecializationConstants, interleaveRowPairs);
+    constants[7].size = sizeof(uint32_t);
+
+    constants[8].constantID = 8;
+    constants[8].offset = offsetof(ComputeSpecializationConstants, stepInPlace);
+    constants[8].size = sizeof(uint32_t);
+
+    constants[9].constantID = 9;
+    constants[9].offset = offsetof(ComputeSpecializationConstants, temporalSteps);
+    constants[9].size = sizeof(uint32_t);
 
     return constants;
 }
 
-std::array<VkSpecializationMapEntry, 2> FragmentSpecializationConstants::getSpecializationMapEntries(void)
+std::array<VkSpecializationMapEntry, 3> FragmentSpecializationConstants::getSpecializationMapEntries(void)
 {
-    std::array<VkSpecializationMapEntry, 2> constants;
+    std::array<VkSpecializationMapEntry, 3> constants;
 
     constants[0].constantID = 0;
     constants[0].offset = 0;
@@ -42,6 +62,10 @@ std::array<VkSpecializationMapEntry, 2> FragmentSpecializationConstants::getSpec
     constants[1].offset = offsetof(FragmentSpecializationConstants, gridHeight);
     constants[1].size = sizeof(uint32_t);
 
+    constants[2].constantID = 2;
+    constants[2].offset = offsetof(FragmentSpecializationConstants, interleaveRowPairs);
+    constants[2].size = sizeof(uint32_t);
+
     return constants;
 }
 
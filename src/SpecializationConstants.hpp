@@ -11,21 +11,28 @@ namespace VkHourglass
 
 struct ComputeSpecializationConstants
 {
-    static std::array<VkSpecializationMapEntry, 5> getSpecializationMapEntries(void);
+    static std::array<VkSpecializationMapEntry, 10> getSpecializationMapEntries(void);
 
     alignas(4) uint32_t localGroupSizeX;
     alignas(4) uint32_t gridWidth;
     alignas(4) uint32_t gridHeight;
     alignas(4) uint32_t enableHorizontalWrapping;
-    alignas(4) float stuckProbability;
+    // Stuck probability scaled by 2^31, see `getStuckThreshold()` in Hash.hpp.
+    alignas(4) uint32_t stuckThreshold;
+    alignas(4) uint32_t tileWidthWords;
+    alignas(4) uint32_t useSharedMemoryTiles;
+    alignas(4) uint32_t interleaveRowPairs;
+    alignas(4) uint32_t stepInPlace;
+    alignas(4) uint32_t temporalSteps;
 };
 
 struct FragmentSpecializationConstants
 {
-    static std::array<VkSpecializationMapEntry, 2> getSpecializationMapEntries(void);
+    static std::array<VkSpecializationMapEntry, 3> getSpecializationMapEntries(void);
 
     alignas(4) uint32_t gridWidth;
     alignas(4) uint32_t gridHeight;
+    alignas(4) uint32_t interleaveRowPairs;
 };
 
 } // namespace VkHourglass
@@ -0,0 +1,67 @@
+#ifndef VULKANHOURGLASS_STATETRANSITIONS_HPP
+#define VULKANHOURGLASS_STATETRANSITIONS_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace VkHourglass::StateTransitions
+{
+
+// NOTE(MM): CPU copy of the transition table in 'shaders/stateTransitions.comp'. See the shader for the meaning of the
+// individual bits. Both tables have to be kept in sync, otherwise CPU and GPU results will diverge.
+constexpr std::array<uint32_t, 256> STATE_TRANSITION{
+    // No walls
+    0, 4, 8, 12, 4, 12, 12, 13, 8, 12, 12, 14, 12, 13, 14, 15,
+
+    // top-left wall
+    0, 0, 8, 8, 4, 4, 12, 12, 8, 8, 12, 12, 12, 12, 14, 14,
+
+    // top-right wall
+    0, 4, 0, 4, 4, 12, 4, 12, 8, 12, 8, 12, 12, 13, 12, 13,
+
+    // top wall
+    0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12,
+
+    // bottom-left wall
+    0, 8, 8, 9, 0, 8, 8, 9, 8, 9, 9, 11, 8, 9, 9, 11,
+
+    // left wall
+    0, 0, 8, 8, 0, 0, 8, 8, 8, 8, 10, 10, 8, 8, 10, 10,
+
+    // bottom-left and top-right wall
+    0, 1, 0, 1, 0, 1, 0, 1, 8, 9, 8, 9, 8, 9, 8, 9,
+
+    // left and top wall
+    0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 8, 8, 8, 8, 8, 8,
+
+    // bottom-right wall
+    0, 4, 4, 6, 4, 6, 6, 7, 0, 4, 4, 6, 4, 6, 6, 7,
+
+    // bottom-right and top-left wall
+    0, 0, 2, 2, 4, 4, 6, 6, 0, 0, 2, 2, 4, 4, 6, 6,
+
+    // right wall
+    0, 4, 0, 4, 4, 5, 4, 5, 0, 4, 0, 4, 4, 5, 4, 5,
+
+    // bottom-right and top wall
+    0, 0, 0, 0, 4, 4, 4, 4, 0, 0, 0, 0, 4, 4, 4, 4,
+
+    // bottom wall
+    0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3,
+
+    // bottom and top-left wall
+    0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2,
+
+    // bottom and top-right wall
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+
+    // full wall
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// Sand in both top cells and nothing below. Sand gets stuck with 'STUCK_PROBABILITY' in this case.
+constexpr uint32_t RANDOM_CASE_VALUE = 3;
+
+} // namespace VkHourglass::StateTransitions
+
+#endif // VULKANHOURGLASS_STATETRANSITIONS_HPP
@@ -0,0 +1,163 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace VkHourglass
+{
+
+// NOTE(MM): More chunks than threads, so uneven chunk costs (e.g. empty vs. busy rows) even out.
+static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : _generation(0)
+    , _busyWorkers(0)
+    , _exit(false)
+    , _task(nullptr)
+    , _threadTask(nullptr)
+    , _count(0)
+    , _chunkSize(1)
+    , _nextChunk(0)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        _workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _exit = true;
+    }
+    _workAvailable.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+size_t ThreadPool::getThreadCount(void) const
+{
+    return _workers.size() + 1;
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& task)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (_workers.empty() || count == 1)
+    {
+        task(0, count);
+        return;
+    }
+
+    const size_t chunkCount = std::min(count, getThreadCount() * CHUNKS_PER_THREAD);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = &task;
+        _count = count;
+        _chunkSize = (count + chunkCount - 1) / chunkCount;
+        _nextChunk.store(0);
+    }
+    startWorkers();
+
+    runChunks();
+
+    waitForWorkers();
+}
+
+void ThreadPool::runOnEachThread(const std::function<void(size_t)>& task)
+{
+    if (_workers.empty())
+    {
+        task(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _threadTask = &task;
+    }
+    startWorkers();
+
+    task(0);
+
+    waitForWorkers();
+}
+
+void ThreadPool::startWorkers(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _busyWorkers = _workers.size();
+        ++_generation;
+    }
+    _workAvailable.notify_all();
+}
+
+void ThreadPool::waitForWorkers(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _workDone.wait(lock, [this]() { return _busyWorkers == 0; });
+    _task = nullptr;
+    _threadTask = nullptr;
+}
+
+void ThreadPool::workerLoop(size_t threadIndex)
+{
+    uint64_t seenGeneration = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _workAvailable.wait(lock, [&]() { return _exit || _generation != seenGeneration; });
+            if (_exit)
+            {
+                return;
+            }
+            seenGeneration = _generation;
+        }
+
+        if (_threadTask != nullptr)
+        {
+            (*_threadTask)(threadIndex);
+        }
+        else
+        {
+            runChunks();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_busyWorkers;
+        }
+        _workDone.notify_one();
+    }
+}
+
+void ThreadPool::runChunks(void)
+{
+    while (true)
+    {
+        const size_t begin = _nextChunk.fetch_add(1) * _chunkSize;
+        if (begin >= _count)
+        {
+            return;
+        }
+
+        (*_task)(begin, std::min(begin + _chunkSize, _count));
+    }
+}
+
+} // namespace VkHourglass
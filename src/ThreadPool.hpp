@@ -0,0 +1,65 @@
+#ifndef VULKANHOURGLASS_THREADPOOL_HPP
+#define VULKANHOURGLASS_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VkHourglass
+{
+
+// Fixed size pool of worker threads for data parallel loops. The calling thread takes part in the work, hence a pool
+// with thread count N spawns N - 1 workers. The calling thread is thread 0, the workers are threads 1 to N - 1.
+class ThreadPool
+{
+public:
+    // A `threadCount` of 0 uses `std::thread::hardware_concurrency()` threads.
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    // NOTE(MM): Workers reference the pool, so it must neither be copied nor moved.
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) noexcept = delete;
+    ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+    size_t getThreadCount(void) const;
+
+    // Split `[0, count)` into chunks and call `task(begin, end)` for each of them in parallel. Blocks until all chunks
+    // are done. Not reentrant, i.e. `task` must not call `parallelFor()` itself.
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& task);
+    // Call `task(threadIndex)` once on each thread, e.g. to pin them or to process work owned by a thread. Blocks
+    // until all calls are done. Not reentrant either.
+    void runOnEachThread(const std::function<void(size_t)>& task);
+
+private:
+    void startWorkers(void);
+    void waitForWorkers(void);
+    void workerLoop(size_t threadIndex);
+    void runChunks(void);
+
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _workDone;
+    uint64_t _generation;
+    size_t _busyWorkers;
+    bool _exit;
+
+    // State of the current `parallelFor()` (or `runOnEachThread()`) call, only written while no worker is busy.
+    const std::function<void(size_t, size_t)>* _task;
+    const std::function<void(size_t)>* _threadTask;
+    size_t _count;
+    size_t _chunkSize;
+    std::atomic<size_t> _nextChunk;
+};
+
+} // namespace VkHourglass
+
+#endif // VULKANHOURGLASS_THREADPOOL_HPP
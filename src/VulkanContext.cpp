@@ -3,21 +3,26 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
+#include <future>
 #include <optional>
 
 #include "ApplicationDefines.hpp"
 #include "ApplicationSharedData.hpp"
+#include "CellBufferLayout.hpp"
 #include "FileReading.hpp"
 #include "GlfwContext.hpp"
+#include "Hash.hpp"
 #include "Macros.hpp"
+#include "PipelineCache.hpp"
 #include "PushConstants.hpp"
 #include "SpecializationConstants.hpp"
 
 // NOTE(MM): Allocate twice to be able to swap in/out buffers on each execution.
 static constexpr uint32_t BUFFERS_PER_COMPUTE = 2;
-static constexpr uint32_t STORAGE_BUFFER_COUNT = 2;
+static constexpr uint32_t STORAGE_BUFFER_COUNT = 3;
 static constexpr uint32_t TEXEL_BUFFER_COUNT = 1;
 
 VKAPI_ATTR VkBool32 VKAPI_CALL debugReportCallbackPrint(VkDebugReportFlagsEXT /*flags*/,
@@ -44,16 +49,21 @@ static std::vector<const char*> getRequiredInstanceLayers(void)
     };
 }
 
-static std::vector<const char*> getRequiredInstanceExtensions(const GlfwContext& glfwContext)
+static std::vector<const char*> getRequiredInstanceExtensions(const GlfwContext* glfwContext)
 {
     std::vector<const char*> requiredExtensions{
 #ifdef VALIDATION_LAYERS
-        VK_EXT_DEBUG_REPORT_EXTENSION_NAME
+        VK_EXT_DEBUG_REPORT_EXTENSION_NAME,
+        VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME,
 #endif
     };
 
-    const auto glfwExtensions = glfwContext.getRequiredExtensions();
-    requiredExtensions.insert(requiredExtensions.cend(), glfwExtensions.cbegin(), glfwExtensions.cend());
+    // NOTE(MM): Surface extensions are only needed when presenting to a window.
+    if (glfwContext)
+    {
+        const auto glfwExtensions = glfwContext->getRequiredExtensions();
+        requiredExtensions.insert(requiredExtensions.cend(), glfwExtensions.cbegin(), glfwExtensions.cend());
+    }
 
     return requiredExtensions;
 }
@@ -63,12 +73,17 @@ static std::vector<const char*> getRequiredDeviceLayers(void)
     // NOTE(MM): Device layers have been deprecated.
     return {};
 }
-static std::vector<const char*> getRequiredDeviceExtensions(void)
+static std::vector<const char*> getRequiredDeviceExtensions(bool isHeadless)
 {
+    if (isHeadless)
+    {
+        return {};
+    }
+
     return {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 }
 
-static std::optional<VkInstance> createInstance(const GlfwContext& glfwContext)
+static std::optional<VkInstance> createInstance(const GlfwContext* glfwContext)
 {
     VkApplicationInfo applicationInfo{};
     applicationInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -76,7 +91,9 @@ static std::optional<VkInstance> createInstance(const GlfwContext& glfwContext)
     applicationInfo.applicationVersion = VK_MAKE_VERSION(0, 0, 1);
     applicationInfo.pEngineName = "End of Time Engine";
     applicationInfo.engineVersion = VK_MAKE_VERSION(0, 0, 1);
-    applicationInfo.apiVersion = VK_API_VERSION_1_1;
+    // NOTE(MM): Vulkan 1.2 is only required for the timeline semaphores of async compute, devices without it are used
+    // without async compute.
+    applicationInfo.apiVersion = VK_API_VERSION_1_2;
 
     const std::vector<const char*> instanceLayers = getRequiredInstanceLayers();
     const std::vector<const char*> instanceExtensions = getRequiredInstanceExtensions(glfwContext);
@@ -89,6 +106,18 @@ static std::optional<VkInstance> createInstance(const GlfwContext& glfwContext)
     createInfo.enabledExtensionCount = static_cast<uint32_t>(instanceExtensions.size());
     createInfo.ppEnabledExtensionNames = instanceExtensions.data();
 
+#ifdef VALIDATION_LAYERS
+    // NOTE(MM): Synchronization validation is off by default in the layer, but it is the one reporting missing
+    // barriers and semaphore waits, e.g. between the queues and the thread of async compute.
+    const VkValidationFeatureEnableEXT enabledValidationFeature =
+        VK_VALIDATION_FEATURE_ENABLE_SYNCHRONIZATION_VALIDATION_EXT;
+    VkValidationFeaturesEXT validationFeatures{};
+    validationFeatures.sType = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT;
+    validationFeatures.enabledValidationFeatureCount = 1;
+    validationFeatures.pEnabledValidationFeatures = &enabledValidationFeature;
+    createInfo.pNext = &validationFeatures;
+#endif
+
     VkInstance instance;
     VK_RETURN_ON_ERROR_V(vkCreateInstance(&createInfo, nullptr, &instance), std::nullopt);
 
@@ -118,13 +147,15 @@ static std::optional<VkInstance> createInstance(const GlfwContext& glfwContext)
     return debugReportCallback;
 }
 
-static bool areDeviceLimitsSufficient(const VkPhysicalDeviceLimits limits)
+static bool areDeviceLimitsSufficient(const VkPhysicalDeviceLimits limits, const Configuration& configuration)
 {
-    return limits.maxComputeWorkGroupInvocations > ApplicationDefines::COMPUTE_LOCAL_GROUP_SIZE_X
-           && limits.maxComputeWorkGroupSize[0] > ApplicationDefines::COMPUTE_LOCAL_GROUP_SIZE_X
-           && limits.maxComputeWorkGroupCount[0] > ApplicationDefines::NonModifiable::X_DISPATCH_COUNT
-           && limits.maxStorageBufferRange > ApplicationDefines::NonModifiable::GRID_SIZE * sizeof(uint32_t)
-           && limits.maxTexelBufferElements > ApplicationDefines::NonModifiable::GRID_SIZE
+    const uint32_t cellBufferWordCount = configuration.getCellBufferWordCount();
+    return limits.maxComputeWorkGroupInvocations > configuration.computeLocalGroupSizeX
+           && limits.maxComputeWorkGroupSize[0] > configuration.computeLocalGroupSizeX
+           && limits.maxComputeWorkGroupCount[0] > configuration.getTileCount()
+           && limits.maxComputeSharedMemorySize >= configuration.getComputeSharedMemorySize()
+           && limits.maxStorageBufferRange > cellBufferWordCount * sizeof(uint32_t)
+           && limits.maxTexelBufferElements > cellBufferWordCount
            && limits.maxPushConstantsSize > sizeof(PushConstants);
 }
 
@@ -172,8 +203,91 @@ static std::optional<uint32_t> chooseQueue(VkPhysicalDevice physicalDevice, VkSu
     return queueFamilyToUse;
 }
 
-static std::optional<VulkanContext::DeviceWrapper> createDevice(const VkInstance instance, const VkSurfaceKHR surface)
+static std::optional<uint32_t> chooseComputeQueue(VkPhysicalDevice physicalDevice)
+{
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    // NOTE(MM): Prefer a dedicated compute family (no graphics), since it doesn't share its hardware queue with any
+    // graphics work. Software implementations (e.g. lavapipe) only expose a combined family, so fall back to that.
+    std::optional<uint32_t> queueFamilyToUse = std::nullopt;
+    for (uint32_t i = 0; i < queueFamilies.size(); ++i)
+    {
+        const VkQueueFamilyProperties& queueFamily = queueFamilies[i];
+        if (!(queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT))
+        {
+            continue;
+        }
+
+        if (!(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT))
+        {
+            return i;
+        }
+
+        if (!queueFamilyToUse.has_value())
+        {
+            queueFamilyToUse = i;
+        }
+    }
+    return queueFamilyToUse;
+}
+
+static bool isDeviceSupportingTimelineSemaphores(const VkPhysicalDevice physicalDevice)
 {
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    if (deviceProperties.apiVersion < VK_API_VERSION_1_2)
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{};
+    timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &timelineSemaphoreFeatures;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+    return timelineSemaphoreFeatures.timelineSemaphore == VK_TRUE;
+}
+
+// Chooses the queue family of the async compute queue besides the graphics/present family `graphicsQueueIndex`.
+static std::optional<uint32_t> chooseAsyncComputeQueue(VkPhysicalDevice physicalDevice, uint32_t graphicsQueueIndex)
+{
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    // NOTE(MM): Like `chooseComputeQueue()`, prefer a dedicated compute family, whose hardware queue runs concurrently
+    // to the graphics one. Otherwise, a second queue of the graphics family at least lets the driver interleave both.
+    for (uint32_t i = 0; i < queueFamilies.size(); ++i)
+    {
+        const VkQueueFlags queueFlags = queueFamilies[i].queueFlags;
+        if (queueFlags & VK_QUEUE_COMPUTE_BIT && !(queueFlags & VK_QUEUE_GRAPHICS_BIT))
+        {
+            return i;
+        }
+    }
+
+    if (queueFamilies[graphicsQueueIndex].queueCount > 1)
+    {
+        return graphicsQueueIndex;
+    }
+    return std::nullopt;
+}
+
+// NOTE(MM): Passing 'VK_NULL_HANDLE' as surface selects a device for headless usage (compute only, no presentation).
+static std::optional<VulkanContext::DeviceWrapper>
+createDevice(const VkInstance instance, const VkSurfaceKHR surface, const Configuration& configuration)
+{
+    const bool isHeadless = surface == VK_NULL_HANDLE;
+
     uint32_t physicalDeviceCount = 0;
     VK_RETURN_ON_ERROR_V(vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, nullptr), std::nullopt);
 
@@ -194,13 +308,13 @@ static std::optional<VulkanContext::DeviceWrapper> createDevice(const VkInstance
     for (const auto& physicalDevice : physicalDevices)
     {
         // NOTE(MM): We want a device with a single graphics/compute queue plus presentation and texel buffer support.
-        if (!isDeviceSupportingSurfacePresentation(physicalDevice, surface)
+        if ((!isHeadless && !isDeviceSupportingSurfacePresentation(physicalDevice, surface))
             || !isDeviceSupportingTexelBufferFormat(physicalDevice, VK_FORMAT_R32_UINT))
         {
             continue;
         }
 
-        auto queueIndexOpt = chooseQueue(physicalDevice, surface);
+        auto queueIndexOpt = isHeadless ? chooseComputeQueue(physicalDevice) : chooseQueue(physicalDevice, surface);
         if (!queueIndexOpt.has_value())
         {
             continue;
@@ -209,7 +323,7 @@ static std::optional<VulkanContext::DeviceWrapper> createDevice(const VkInstance
         VkPhysicalDeviceProperties deviceProperties;
         vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
 
-        if (!areDeviceLimitsSufficient(deviceProperties.limits))
+        if (!areDeviceLimitsSufficient(deviceProperties.limits, configuration))
         {
             fprintf(stderr,
                     "Found suitable device, but its limits are exceeded. Consider lowering grid size and compute group "
@@ -252,20 +366,51 @@ static std::optional<VulkanContext::DeviceWrapper> createDevice(const VkInstance
 
     VkPhysicalDevice physicalDevice = bestDeviceOpt.value();
 
+    // NOTE(MM): Async compute doesn't affect the choice of the device, without support for it the generations are
+    // computed on the graphics queue as usual.
+    std::optional<uint32_t> computeQueueIndexOpt = std::nullopt;
+    if (!isHeadless && configuration.useAsyncCompute)
+    {
+        if (isDeviceSupportingTimelineSemaphores(physicalDevice))
+        {
+            computeQueueIndexOpt = chooseAsyncComputeQueue(physicalDevice, queueIndex);
+        }
+        if (!computeQueueIndexOpt.has_value())
+        {
+            fprintf(stderr,
+                    "Device doesn't support async compute (timeline semaphores and a second queue), computing on the "
+                    "graphics queue!\n");
+        }
+    }
+
     std::vector<const char*> deviceLayers = getRequiredDeviceLayers();
-    std::vector<const char*> deviceExtensions = getRequiredDeviceExtensions();
-    constexpr float queuePriority = 1.0f;
+    std::vector<const char*> deviceExtensions = getRequiredDeviceExtensions(isHeadless);
+    constexpr std::array<float, 2> queuePriorities{1.0f, 1.0f};
+
+    std::vector<VkDeviceQueueCreateInfo> deviceQueueCreateInfos(1, VkDeviceQueueCreateInfo{});
+    deviceQueueCreateInfos[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    deviceQueueCreateInfos[0].queueCount = 1;
+    deviceQueueCreateInfos[0].queueFamilyIndex = queueIndex;
+    deviceQueueCreateInfos[0].pQueuePriorities = queuePriorities.data();
+    if (computeQueueIndexOpt == queueIndex)
+    {
+        deviceQueueCreateInfos[0].queueCount = 2;
+    }
+    else if (computeQueueIndexOpt.has_value())
+    {
+        deviceQueueCreateInfos.push_back(deviceQueueCreateInfos[0]);
+        deviceQueueCreateInfos[1].queueFamilyIndex = computeQueueIndexOpt.value();
+    }
 
-    VkDeviceQueueCreateInfo deviceQueueCreateInfo{};
-    deviceQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    deviceQueueCreateInfo.queueCount = 1;
-    deviceQueueCreateInfo.queueFamilyIndex = queueIndex;
-    deviceQueueCreateInfo.pQueuePriorities = &queuePriority;
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{};
+    timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
 
     VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    deviceCreateInfo.queueCreateInfoCount = 1;
-    deviceCreateInfo.pQueueCreateInfos = &deviceQueueCreateInfo;
+    deviceCreateInfo.pNext = computeQueueIndexOpt.has_value() ? &timelineSemaphoreFeatures : nullptr;
+    deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(deviceQueueCreateInfos.size());
+    deviceCreateInfo.pQueueCreateInfos = deviceQueueCreateInfos.data();
     deviceCreateInfo.enabledLayerCount = static_cast<uint32_t>(deviceLayers.size());
     deviceCreateInfo.ppEnabledLayerNames = deviceLayers.data();
     deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
@@ -277,13 +422,28 @@ static std::optional<VulkanContext::DeviceWrapper> createDevice(const VkInstance
     VkQueue deviceQueue;
     vkGetDeviceQueue(device, queueIndex, 0, &deviceQueue);
 
+    VkQueue computeQueue = VK_NULL_HANDLE;
+    const uint32_t computeQueueIndex = computeQueueIndexOpt.value_or(queueIndex);
+    if (computeQueueIndexOpt.has_value())
+    {
+        vkGetDeviceQueue(device, computeQueueIndex, computeQueueIndex == queueIndex ? 1 : 0, &computeQueue);
+    }
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
     VkDescriptorPoolSize storageBufferPoolSize;
     storageBufferPoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    storageBufferPoolSize.descriptorCount = STORAGE_BUFFER_COUNT;
+    storageBufferPoolSize.descriptorCount = STORAGE_BUFFER_COUNT * BUFFERS_PER_COMPUTE;
 
     VkDescriptorPoolSize texelBufferPoolSize;
     texelBufferPoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
-    texelBufferPoolSize.descriptorCount = TEXEL_BUFFER_COUNT;
+    texelBufferPoolSize.descriptorCount = TEXEL_BUFFER_COUNT * VulkanContext::DISPLAY_BUFFER_COUNT;
 
     std::array<VkDescriptorPoolSize, 2> poolSizes{storageBufferPoolSize, texelBufferPoolSize};
 
@@ -296,8 +456,15 @@ static std::optional<VulkanContext::DeviceWrapper> createDevice(const VkInstance
     VkDescriptorPool descriptorPool;
     VK_RETURN_ON_ERROR_V(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool), std::nullopt);
 
-    return std::make_optional<VulkanContext::DeviceWrapper>(
-        {physicalDevice, device, deviceQueue, queueIndex, descriptorPool});
+    return std::make_optional<VulkanContext::DeviceWrapper>({physicalDevice,
+                                                             device,
+                                                             deviceQueue,
+                                                             queueIndex,
+                                                             computeQueue,
+                                                             computeQueueIndex,
+                                                             descriptorPool,
+                                                             queueFamilies[queueIndex].timestampValidBits,
+                                                             deviceProperties.limits.timestampPeriod});
 }
 
 static std::optional<VulkanContext::Swapchain> createSwapchain(const VulkanContext::DeviceWrapper& deviceWrapper,
@@ -421,12 +588,8 @@ static std::optional<VulkanContext::Swapchain> createSwapchain(const VulkanConte
         {swapchain, surfaceFormat.format, imageExtent, std::move(images), std::move(imageViews)});
 }
 
-static std::optional<VkShaderModule> createShaderModule(const VkDevice device, const std::filesystem::path& shaderPath)
+static std::optional<VkShaderModule> createShaderModule(const VkDevice device, const std::vector<char>& shaderContent)
 {
-    auto shaderContentOpt = FileReading::readFile(shaderPath, std::ios::ate | std::ios::binary);
-    RETURN_ON_NULLOPT_V(shaderContentOpt, std::nullopt);
-
-    const std::vector<char>& shaderContent = shaderContentOpt.value();
     VkShaderModuleCreateInfo shaderModuleCreateInfo{};
     shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     shaderModuleCreateInfo.codeSize = shaderContent.size();
@@ -438,31 +601,96 @@ static std::optional<VkShaderModule> createShaderModule(const VkDevice device, c
     return shaderModule;
 }
 
-static std::optional<uint32_t>
-findMemoryType(const VkPhysicalDevice physicalDevice, uint32_t memoryRequirements, VkMemoryPropertyFlags properties)
+// SPIR-V of all shaders used by the context. The graphics shaders stay empty in headless mode.
+struct ShaderBinaries
 {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+    std::vector<char> compute;
+    std::vector<char> activeTiles;
+    std::vector<char> vertex;
+    std::vector<char> fragment;
+    // Hash over all shaders, so that rebuilt shaders invalidate the pipeline cache.
+    uint64_t hash;
+};
+
+static std::optional<std::vector<char>> readShaderFile(const std::filesystem::path& executableDir,
+                                                       const std::string_view shaderName)
+{
+    std::filesystem::path shaderPath(executableDir);
+    shaderPath.append(shaderName);
 
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+    return FileReading::readFile(shaderPath, std::ios::ate | std::ios::binary);
+}
+
+static std::optional<ShaderBinaries> loadShaderBinaries(const std::filesystem::path& executableDir, bool isHeadless)
+{
+    ShaderBinaries shaderBinaries{};
+
+    auto computeOpt = readShaderFile(executableDir, ApplicationDefines::NonModifiable::COMPUTE_SHADER_NAME);
+    RETURN_ON_NULLOPT_V(computeOpt, std::nullopt);
+    shaderBinaries.compute = std::move(computeOpt.value());
+
+    auto activeTilesOpt = readShaderFile(executableDir, ApplicationDefines::NonModifiable::ACTIVE_TILES_SHADER_NAME);
+    RETURN_ON_NULLOPT_V(activeTilesOpt, std::nullopt);
+    shaderBinaries.activeTiles = std::move(activeTilesOpt.value());
+
+    if (!isHeadless)
     {
-        // The i-th bit of the memory requirements is set if the i-th memory type of the device satisfies them. Hence
-        // the check of the bits before the property check.
-        if ((memoryRequirements & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-        {
-            return i;
-        }
+        auto vertexOpt = readShaderFile(executableDir, ApplicationDefines::NonModifiable::VERTEX_SHADER_NAME);
+        RETURN_ON_NULLOPT_V(vertexOpt, std::nullopt);
+        shaderBinaries.vertex = std::move(vertexOpt.value());
+
+        auto fragmentOpt = readShaderFile(executableDir, ApplicationDefines::NonModifiable::FRAGMENT_SHADER_NAME);
+        RETURN_ON_NULLOPT_V(fragmentOpt, std::nullopt);
+        shaderBinaries.fragment = std::move(fragmentOpt.value());
     }
 
-    fprintf(stderr, "Failed to find suitable memory type for physical device: %p!\n", (void*)physicalDevice);
-    return std::nullopt;
+    uint64_t hash = PipelineCache::hashData(shaderBinaries.compute);
+    hash = PipelineCache::hashData(shaderBinaries.activeTiles, hash);
+    hash = PipelineCache::hashData(shaderBinaries.vertex, hash);
+    shaderBinaries.hash = PipelineCache::hashData(shaderBinaries.fragment, hash);
+
+    return shaderBinaries;
 }
 
-static std::optional<std::tuple<VkBuffer, VkDeviceMemory>>
+// NOTE(MM): `initialData` has already been validated against the device, an empty one creates an empty cache.
+static std::optional<VkPipelineCache> createPipelineCache(const VkDevice device, const std::vector<char>& initialData)
+{
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo{};
+    pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipelineCacheCreateInfo.initialDataSize = initialData.size();
+    pipelineCacheCreateInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    VkPipelineCache pipelineCache;
+    VK_RETURN_ON_ERROR_V(vkCreatePipelineCache(device, &pipelineCacheCreateInfo, nullptr, &pipelineCache),
+                         std::nullopt);
+
+    return pipelineCache;
+}
+
+static bool storePipelineCache(const VkDevice device,
+                               const VkPipelineCache pipelineCache,
+                               const std::filesystem::path& filePath,
+                               const PipelineCache::Key& key)
+{
+    size_t dataSize = 0;
+    VK_RETURN_ON_ERROR_V(vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr), false);
+
+    std::vector<char> data(dataSize);
+    VK_RETURN_ON_ERROR_V(vkGetPipelineCacheData(device, pipelineCache, &dataSize, data.data()), false);
+    data.resize(dataSize);
+
+    return PipelineCache::storeData(filePath, key, data);
+}
+
+// NOTE(MM): The memory is sub-allocated from `memoryArena`, free it with `DeviceMemoryArena::free` and never map it
+// (use `Allocation::mappedData` instead).
+static std::optional<std::tuple<VkBuffer, DeviceMemoryArena::Allocation>>
 createBuffer(const VulkanContext::DeviceWrapper& deviceWrapper,
+             DeviceMemoryArena& memoryArena,
              VkDeviceSize size,
              VkBufferUsageFlags usage,
-             VkMemoryPropertyFlags properties)
+             VkMemoryPropertyFlags properties,
+             DeviceMemoryArena::PoolType poolType)
 {
     VkBufferCreateInfo bufferCreateInfo{};
     bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -470,6 +698,16 @@ createBuffer(const VulkanContext::DeviceWrapper& deviceWrapper,
     bufferCreateInfo.usage = usage;
     bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    // NOTE(MM): With async compute on another queue family, buffers are used by both families. Concurrent sharing
+    // saves the queue family ownership transfers.
+    const std::array<uint32_t, 2> queueFamilyIndices{deviceWrapper.queueIndex, deviceWrapper.computeQueueIndex};
+    if (deviceWrapper.computeQueue != VK_NULL_HANDLE && queueFamilyIndices[0] != queueFamilyIndices[1])
+    {
+        bufferCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilyIndices.size());
+        bufferCreateInfo.pQueueFamilyIndices = queueFamilyIndices.data();
+    }
+
     const VkDevice device = deviceWrapper.device;
     VkBuffer buffer;
     VK_RETURN_ON_ERROR_V(vkCreateBuffer(device, &bufferCreateInfo, nullptr, &buffer), std::nullopt);
@@ -477,29 +715,57 @@ createBuffer(const VulkanContext::DeviceWrapper& deviceWrapper,
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
 
-    std::optional<uint32_t> memoryTypeIndex =
-        findMemoryType(deviceWrapper.physicalDevice, memRequirements.memoryTypeBits, properties);
-
-    RETURN_ON_NULLOPT_V(memoryTypeIndex, std::nullopt);
+    auto allocationOpt = memoryArena.allocate(memRequirements, properties, poolType);
+    if (!allocationOpt.has_value())
+    {
+        vkDestroyBuffer(device, buffer, nullptr);
+        return std::nullopt;
+    }
+    const DeviceMemoryArena::Allocation& allocation = allocationOpt.value();
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = memoryTypeIndex.value();
+    if (const VkResult result = vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
+        result != VK_SUCCESS)
+    {
+        fprintf(stderr, "Failed to bind buffer memory with result: %d\n", result);
+        memoryArena.free(allocation);
+        vkDestroyBuffer(device, buffer, nullptr);
+        return std::nullopt;
+    }
 
-    VkDeviceMemory bufferMemory;
-    VK_RETURN_ON_ERROR_V(vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory), std::nullopt);
+    return std::make_tuple(buffer, allocation);
+}
 
-    VK_RETURN_ON_ERROR_V(vkBindBufferMemory(device, buffer, bufferMemory, 0), std::nullopt);
+// Host visible buffer of the size of a cell buffer, which cells are copied to by the GPU and read by the host.
+static std::optional<std::tuple<VkBuffer, DeviceMemoryArena::Allocation>>
+createReadbackBuffer(const VulkanContext::DeviceWrapper& deviceWrapper,
+                     DeviceMemoryArena& memoryArena,
+                     const Configuration& configuration)
+{
+    // NOTE(MM): The host reads the whole buffer, which is a lot slower from uncached memory, so prefer cached memory.
+    // Coherent memory saves the invalidation before reading.
+    VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    if (memoryArena.hasMemoryType(properties | VK_MEMORY_PROPERTY_HOST_CACHED_BIT))
+    {
+        properties |= VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    }
 
-    return std::make_tuple(buffer, bufferMemory);
+    const auto bufferSize = static_cast<VkDeviceSize>(configuration.getCellBufferWordCount() * sizeof(uint32_t));
+    return createBuffer(deviceWrapper,
+                        memoryArena,
+                        bufferSize,
+                        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                        properties,
+                        DeviceMemoryArena::PoolType::Linear);
 }
 
+// NOTE(MM): Copies `size` bytes of `srcBuffer` to each of `dstBuffers` with a single submission, starting at
+// `i * srcStride` for `dstBuffers[i]` (a stride of 0 copies the same data to all of them).
 static bool copyBuffer(const VulkanContext::DeviceWrapper& deviceWrapper,
                        const VkCommandPool& commandPool,
                        const VkBuffer& srcBuffer,
-                       const VkBuffer& dstBuffer,
-                       VkDeviceSize size)
+                       const std::vector<VkBuffer>& dstBuffers,
+                       VkDeviceSize size,
+                       VkDeviceSize srcStride)
 {
     VkCommandBufferAllocateInfo allocateInfo{};
     allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -522,7 +788,11 @@ static bool copyBuffer(const VulkanContext::DeviceWrapper& deviceWrapper,
     copyRegion.dstOffset = 0;
     copyRegion.size = size;
 
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+    for (const auto& dstBuffer : dstBuffers)
+    {
+        vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+        copyRegion.srcOffset += srcStride;
+    }
     VK_RETURN_ON_ERROR_V(vkEndCommandBuffer(commandBuffer), false);
 
     VkSubmitInfo submitInfo{};
@@ -540,42 +810,239 @@ static bool copyBuffer(const VulkanContext::DeviceWrapper& deviceWrapper,
     return true;
 }
 
+// NOTE(MM): Like 'copyBuffer', but makes sure previous compute shader writes to `srcBuffer` are visible to the copy and
+// the copied data is visible to the host afterwards.
+static bool copyBufferToHost(const VulkanContext::DeviceWrapper& deviceWrapper,
+                             const VkCommandPool& commandPool,
+                             const VkQueue& queue,
+                             const VkBuffer& srcBuffer,
+                             const VkBuffer& dstBuffer,
+                             VkDeviceSize size)
+{
+    VkCommandBufferAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocateInfo.commandPool = commandPool;
+    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocateInfo.commandBufferCount = 1;
+
+    const VkDevice device = deviceWrapper.device;
+    VkCommandBuffer commandBuffer;
+    VK_RETURN_ON_ERROR_V(vkAllocateCommandBuffers(device, &allocateInfo, &commandBuffer), false);
+
+    VkCommandBufferBeginInfo commandBufferBeginInfo{};
+    commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    VK_RETURN_ON_ERROR_V(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo), false);
+
+    VkBufferMemoryBarrier bufferMemoryBarrier{};
+    bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    bufferMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    bufferMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferMemoryBarrier.buffer = srcBuffer;
+    bufferMemoryBarrier.offset = 0;
+    bufferMemoryBarrier.size = size;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         1,
+                         &bufferMemoryBarrier,
+                         0,
+                         nullptr);
+
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = 0;
+    copyRegion.dstOffset = 0;
+    copyRegion.size = size;
+
+    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+
+    bufferMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    bufferMemoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    bufferMemoryBarrier.buffer = dstBuffer;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         1,
+                         &bufferMemoryBarrier,
+                         0,
+                         nullptr);
+
+    VK_RETURN_ON_ERROR_V(vkEndCommandBuffer(commandBuffer), false);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+
+    VK_RETURN_ON_ERROR_V(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE), false);
+    VK_RETURN_ON_ERROR_V(vkQueueWaitIdle(queue), false);
+
+    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+
+    return true;
+}
+
+// NOTE(MM): Memory type bits only depend on usage and flags of a buffer, not on its size. Hence, a small temporary
+// buffer is enough to check whether buffers with `usage` can be placed in memory which is both device local and host
+// visible (UMA devices, software implementations like lavapipe, resizable BAR). Without resizable BAR, discrete GPUs
+// only expose a small heap (usually 256 MiB) of such memory, so `requiredSize` must not take more than half of it.
+static bool isHostVisibleDeviceLocalMemoryAvailable(const VulkanContext::DeviceWrapper& deviceWrapper,
+                                                    VkBufferUsageFlags usage,
+                                                    VkDeviceSize requiredSize)
+{
+    VkBufferCreateInfo bufferCreateInfo{};
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.size = sizeof(uint32_t);
+    bufferCreateInfo.usage = usage;
+    bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    const VkDevice device = deviceWrapper.device;
+    VkBuffer buffer;
+    VK_RETURN_ON_ERROR_V(vkCreateBuffer(device, &bufferCreateInfo, nullptr, &buffer), false);
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+    vkDestroyBuffer(device, buffer, nullptr);
+
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(deviceWrapper.physicalDevice, &memProperties);
+
+    constexpr VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+                                                 | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                                 | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+    {
+        const VkMemoryType& memoryType = memProperties.memoryTypes[i];
+        if ((memRequirements.memoryTypeBits & (1 << i)) && (memoryType.propertyFlags & properties) == properties)
+        {
+            return requiredSize <= memProperties.memoryHeaps[memoryType.heapIndex].size / 2;
+        }
+    }
+
+    return false;
+}
+
+struct DeviceLocalBuffers
+{
+    std::vector<VkBuffer> buffers;
+    std::vector<DeviceMemoryArena::Allocation> buffersMemory;
+    // Whether the buffers were written directly by the host instead of through a staging buffer.
+    bool isHostVisible;
+};
+
+// Create a device local buffer per element of `bufferData`, initialized with the `bufferDataCount` elements it points
+// to. Elements may point to the same data.
+//
+// NOTE(MM): If the device has host visible device local memory, the buffers are allocated there and written through a
+// mapping, so neither a staging buffer nor a submission is needed. Otherwise, all buffers are filled from a single
+// staging buffer with a single submission, which holds the data only once if all buffers share it. The buffers are
+// allocated from the linear pool of `memoryArena`, the staging buffer from the free list pool.
 template <typename T>
-static std::optional<std::tuple<VkBuffer, VkDeviceMemory>>
-createDeviceLocalBuffer(const VulkanContext::DeviceWrapper& deviceWrapper,
-                        const VkCommandPool commandPool,
-                        const std::vector<T>& bufferData,
-                        VkBufferUsageFlags usage)
+static std::optional<DeviceLocalBuffers> createDeviceLocalBuffers(const VulkanContext::DeviceWrapper& deviceWrapper,
+                                                                  DeviceMemoryArena& memoryArena,
+                                                                  const VkCommandPool commandPool,
+                                                                  const std::vector<const T*>& bufferData,
+                                                                  size_t bufferDataCount,
+                                                                  VkBufferUsageFlags usage)
 {
-    assert(!bufferData.empty() && "createDeviceLocalBuffer: Passed 'bufferData' vector is empty!");
+    assert(!bufferData.empty() && bufferDataCount > 0 && "createDeviceLocalBuffers: Passed 'bufferData' is empty!");
+
+    const VkDevice device = deviceWrapper.device;
+    const size_t bufferCount = bufferData.size();
+    const auto bufferSize = static_cast<VkDeviceSize>(sizeof(T) * bufferDataCount);
+    const VkBufferUsageFlags bufferUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage;
+
+    DeviceLocalBuffers result{{}, {}, false};
+    result.isHostVisible =
+        isHostVisibleDeviceLocalMemoryAvailable(deviceWrapper, bufferUsage, bufferSize * bufferCount);
+
+    // NOTE(MM): Destroy the buffers created so far on failure, the caller only takes ownership on success.
+    const auto destroyBuffers = [&device, &memoryArena, &result]() {
+        for (size_t i = 0; i < result.buffers.size(); ++i)
+        {
+            memoryArena.free(result.buffersMemory[i]);
+            vkDestroyBuffer(device, result.buffers[i], nullptr);
+        }
+    };
+
+    const VkMemoryPropertyFlags properties =
+        result.isHostVisible ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                   | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+                             : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    for (size_t i = 0; i < bufferCount; ++i)
+    {
+        auto bufferAndMemoryOpt = createBuffer(
+            deviceWrapper, memoryArena, bufferSize, bufferUsage, properties, DeviceMemoryArena::PoolType::Linear);
+        if (!bufferAndMemoryOpt.has_value())
+        {
+            destroyBuffers();
+            return std::nullopt;
+        }
+
+        auto [buffer, bufferMemory] = bufferAndMemoryOpt.value();
+        result.buffers.push_back(buffer);
+        result.buffersMemory.push_back(bufferMemory);
+    }
+
+    if (result.isHostVisible)
+    {
+        // NOTE(MM): Host writes to coherent memory are visible to the device once the commands using the buffers are
+        // submitted, no flush or barrier needed. The arena keeps host visible memory mapped.
+        for (size_t i = 0; i < bufferCount; ++i)
+        {
+            memcpy(result.buffersMemory[i].mappedData, bufferData[i], (size_t)bufferSize);
+        }
+
+        return result;
+    }
+
+    const bool isDataShared = std::all_of(
+        bufferData.begin(), bufferData.end(), [&bufferData](const T* data) { return data == bufferData[0]; });
+    const size_t stagedBufferCount = isDataShared ? 1 : bufferCount;
 
-    const auto bufferSize = static_cast<VkDeviceSize>(sizeof(bufferData[0]) * bufferData.size());
     auto stagingBufferAndMemoryOpt =
         createBuffer(deviceWrapper,
-                     bufferSize,
+                     memoryArena,
+                     bufferSize * stagedBufferCount,
                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-    RETURN_ON_NULLOPT_V(stagingBufferAndMemoryOpt, std::nullopt);
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     DeviceMemoryArena::PoolType::FreeList);
+    if (!stagingBufferAndMemoryOpt.has_value())
+    {
+        destroyBuffers();
+        return std::nullopt;
+    }
     auto [stagingBuffer, stagingBufferMemory] = stagingBufferAndMemoryOpt.value();
 
-    const VkDevice device = deviceWrapper.device;
-    void* data;
-    vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, bufferData.data(), (size_t)bufferSize);
-    vkUnmapMemory(device, stagingBufferMemory);
-
-    auto localBufferAndMemoryOpt = createBuffer(
-        deviceWrapper, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    RETURN_ON_NULLOPT_V(localBufferAndMemoryOpt, std::nullopt);
-
-    std::tuple<VkBuffer, VkDeviceMemory> localBufferAndMemory = localBufferAndMemoryOpt.value();
-    copyBuffer(deviceWrapper, commandPool, stagingBuffer, std::get<VkBuffer>(localBufferAndMemory), bufferSize);
+    for (size_t i = 0; i < stagedBufferCount; ++i)
+    {
+        memcpy(static_cast<char*>(stagingBufferMemory.mappedData) + i * bufferSize, bufferData[i], (size_t)bufferSize);
+    }
+    const bool isUploaded = copyBuffer(
+        deviceWrapper, commandPool, stagingBuffer, result.buffers, bufferSize, isDataShared ? 0 : bufferSize);
 
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
+    memoryArena.free(stagingBufferMemory);
     vkDestroyBuffer(device, stagingBuffer, nullptr);
 
-    return localBufferAndMemory;
+    if (!isUploaded)
+    {
+        fprintf(stderr, "Failed to upload device local buffers!\n");
+        destroyBuffers();
+        return std::nullopt;
+    }
+
+    return result;
 }
 
 static std::optional<std::vector<VkBufferView>> createBufferViews(const VulkanContext::DeviceWrapper& deviceWrapper,
@@ -604,23 +1071,45 @@ static std::optional<std::vector<VkBufferView>> createBufferViews(const VulkanCo
     return bufferViews;
 }
 
-static std::optional<VulkanContext::ComputePipeline>
-createComputePipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
-                      const std::vector<VkBuffer>& cellBuffers,
-                      const std::vector<VkBufferView>& cellBufferViews,
-                      const std::filesystem::path& executableDir,
-                      size_t buffersize)
+static std::optional<VkPipeline> createComputeShaderPipeline(const VkDevice device,
+                                                             const VkPipelineCache pipelineCache,
+                                                             const VkShaderModule shaderModule,
+                                                             const VkPipelineLayout pipelineLayout,
+                                                             const VkSpecializationInfo& specializationInfo)
 {
-    assert(cellBuffers.size() == cellBufferViews.size() && "Amount of buffers needs to match buffer views!");
+    VkPipelineShaderStageCreateInfo shaderStageCreateInfo{};
+    shaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStageCreateInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    shaderStageCreateInfo.module = shaderModule;
+    shaderStageCreateInfo.pName = "main";
+    shaderStageCreateInfo.pSpecializationInfo = &specializationInfo;
 
-    std::filesystem::path shaderPath(executableDir);
-    shaderPath.append(ApplicationDefines::NonModifiable::COMPUTE_SHADER_NAME);
+    VkComputePipelineCreateInfo pipelineCreateInfo{};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stage = shaderStageCreateInfo;
+    pipelineCreateInfo.layout = pipelineLayout;
 
-    const VkDevice device = deviceWrapper.device;
-    auto shaderModuleOpt = createShaderModule(device, shaderPath);
+    VkPipeline pipeline;
+    VK_RETURN_ON_ERROR_V(vkCreateComputePipelines(device, pipelineCache, 1, &pipelineCreateInfo, nullptr, &pipeline),
+                         std::nullopt);
+
+    return pipeline;
+}
+
+static std::optional<VulkanContext::ComputePipeline>
+createComputePipeline(const VkDevice device,
+                      const VkPipelineCache pipelineCache,
+                      const ShaderBinaries& shaderBinaries,
+                      const Configuration& configuration)
+{
+    auto shaderModuleOpt = createShaderModule(device, shaderBinaries.compute);
     RETURN_ON_NULLOPT_V(shaderModuleOpt, std::nullopt);
     VkShaderModule shaderModule = shaderModuleOpt.value();
 
+    auto activeTilesShaderModuleOpt = createShaderModule(device, shaderBinaries.activeTiles);
+    RETURN_ON_NULLOPT_V(activeTilesShaderModuleOpt, std::nullopt);
+    VkShaderModule activeTilesShaderModule = activeTilesShaderModuleOpt.value();
+
     VkDescriptorSetLayoutBinding inBufferBinding{};
     inBufferBinding.binding = 0;
     inBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -633,8 +1122,14 @@ createComputePipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
     outBufferBinding.descriptorCount = 1;
     outBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
-    const std::array<VkDescriptorSetLayoutBinding, STORAGE_BUFFER_COUNT> descriptorLayoutBindings{inBufferBinding,
-                                                                                                  outBufferBinding};
+    VkDescriptorSetLayoutBinding activeTilesBufferBinding{};
+    activeTilesBufferBinding.binding = 2;
+    activeTilesBufferBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    activeTilesBufferBinding.descriptorCount = 1;
+    activeTilesBufferBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    const std::array<VkDescriptorSetLayoutBinding, STORAGE_BUFFER_COUNT> descriptorLayoutBindings{
+        inBufferBinding, outBufferBinding, activeTilesBufferBinding};
 
     VkDescriptorSetLayoutCreateInfo descriptorLayoutCreateInfo{};
     descriptorLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -662,11 +1157,16 @@ createComputePipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
                          std::nullopt);
 
     const auto specializationMapEntries = ComputeSpecializationConstants::getSpecializationMapEntries();
-    ComputeSpecializationConstants specializationData{ApplicationDefines::COMPUTE_LOCAL_GROUP_SIZE_X,
-                                                      ApplicationDefines::GRID_WIDTH,
-                                                      ApplicationDefines::GRID_HEIGHT,
-                                                      ApplicationDefines::ENABLE_HORIZONTAL_WRAPPING,
-                                                      ApplicationDefines::STUCK_PROBABILITY};
+    ComputeSpecializationConstants specializationData{configuration.computeLocalGroupSizeX,
+                                                      configuration.gridWidth,
+                                                      configuration.gridHeight,
+                                                      configuration.enableHorizontalWrapping,
+                                                      getStuckThreshold(configuration.stuckProbability),
+                                                      configuration.tileWidthWords,
+                                                      configuration.useSharedMemoryTiles,
+                                                      configuration.interleaveRowPairs,
+                                                      configuration.stepInPlace,
+                                                      configuration.temporalSteps};
 
     VkSpecializationInfo specializationInfo = {};
     specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationMapEntries.size());
@@ -674,21 +1174,33 @@ createComputePipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
     specializationInfo.dataSize = sizeof(ComputeSpecializationConstants);
     specializationInfo.pData = &specializationData;
 
-    VkPipelineShaderStageCreateInfo shaderStageCreateInfo{};
-    shaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    shaderStageCreateInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-    shaderStageCreateInfo.module = shaderModule;
-    shaderStageCreateInfo.pName = "main";
-    shaderStageCreateInfo.pSpecializationInfo = &specializationInfo;
+    auto pipelineOpt =
+        createComputeShaderPipeline(device, pipelineCache, shaderModule, pipelineLayout, specializationInfo);
+    RETURN_ON_NULLOPT_V(pipelineOpt, std::nullopt);
 
-    VkComputePipelineCreateInfo pipelineCreateInfo{};
-    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-    pipelineCreateInfo.stage = shaderStageCreateInfo;
-    pipelineCreateInfo.layout = pipelineLayout;
+    auto activeTilesPipelineOpt =
+        createComputeShaderPipeline(device, pipelineCache, activeTilesShaderModule, pipelineLayout, specializationInfo);
+    RETURN_ON_NULLOPT_V(activeTilesPipelineOpt, std::nullopt);
 
-    VkPipeline pipeline;
-    VK_RETURN_ON_ERROR_V(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipeline),
-                         std::nullopt);
+    return std::make_optional<VulkanContext::ComputePipeline>({
+        pipelineOpt.value(),
+        activeTilesPipelineOpt.value(),
+        pipelineLayout,
+        descriptorSetLayout,
+        shaderModule,
+        activeTilesShaderModule,
+        {},
+    });
+}
+
+static std::optional<std::vector<VkDescriptorSet>>
+createComputeDescriptorSets(const VulkanContext::DeviceWrapper& deviceWrapper,
+                            const VkDescriptorSetLayout descriptorSetLayout,
+                            const std::vector<VkBuffer>& cellBuffers,
+                            const VkBuffer activeTilesBuffer,
+                            size_t buffersize)
+{
+    assert(!cellBuffers.empty() && cellBuffers.size() <= BUFFERS_PER_COMPUTE && "Unexpected amount of cell buffers!");
 
     std::array<VkDescriptorSetLayout, BUFFERS_PER_COMPUTE> descriptorSetLayouts{descriptorSetLayout,
                                                                                 descriptorSetLayout};
@@ -698,22 +1210,30 @@ createComputePipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
     allocateInfo.descriptorSetCount = static_cast<uint32_t>(descriptorSetLayouts.size());
     allocateInfo.pSetLayouts = descriptorSetLayouts.data();
 
-    std::vector<VkDescriptorSet> descriptorSets(STORAGE_BUFFER_COUNT);
+    const VkDevice device = deviceWrapper.device;
+    std::vector<VkDescriptorSet> descriptorSets(BUFFERS_PER_COMPUTE);
     VK_RETURN_ON_ERROR_V(vkAllocateDescriptorSets(device, &allocateInfo, descriptorSets.data()), std::nullopt);
 
     for (size_t i = 0; i < BUFFERS_PER_COMPUTE; i++)
     {
         VkDescriptorBufferInfo inBufferInfo{};
-        inBufferInfo.buffer = cellBuffers[i];
+        // NOTE(MM): When stepping in place, both sets bind the single cell buffer as input and output. The sets still
+        // differ by the partition offset they are used with.
+        inBufferInfo.buffer = cellBuffers[i % cellBuffers.size()];
         inBufferInfo.offset = 0;
         inBufferInfo.range = static_cast<uint32_t>(buffersize);
 
         VkDescriptorBufferInfo outBufferInfo{};
         const size_t outBufferIdx = (i + 1) % BUFFERS_PER_COMPUTE;
-        outBufferInfo.buffer = cellBuffers[outBufferIdx];
+        outBufferInfo.buffer = cellBuffers[outBufferIdx % cellBuffers.size()];
         outBufferInfo.offset = 0;
         outBufferInfo.range = static_cast<uint32_t>(buffersize);
 
+        VkDescriptorBufferInfo activeTilesBufferInfo{};
+        activeTilesBufferInfo.buffer = activeTilesBuffer;
+        activeTilesBufferInfo.offset = 0;
+        activeTilesBufferInfo.range = VK_WHOLE_SIZE;
+
         std::array<VkWriteDescriptorSet, STORAGE_BUFFER_COUNT> writeDescriptorSets{};
         writeDescriptorSets[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         writeDescriptorSets[0].dstSet = descriptorSets[i];
@@ -731,17 +1251,19 @@ createComputePipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
         writeDescriptorSets[1].descriptorCount = 1;
         writeDescriptorSets[1].pBufferInfo = &outBufferInfo;
 
+        writeDescriptorSets[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSets[2].dstSet = descriptorSets[i];
+        writeDescriptorSets[2].dstBinding = 2;
+        writeDescriptorSets[2].dstArrayElement = 0;
+        writeDescriptorSets[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptorSets[2].descriptorCount = 1;
+        writeDescriptorSets[2].pBufferInfo = &activeTilesBufferInfo;
+
         vkUpdateDescriptorSets(
             device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
     }
 
-    return std::make_optional<VulkanContext::ComputePipeline>({
-        pipeline,
-        pipelineLayout,
-        descriptorSetLayout,
-        shaderModule,
-        std::move(descriptorSets),
-    });
+    return descriptorSets;
 }
 
 static std::optional<VkRenderPass> createRenderPass(const VkDevice& device, const VkFormat& swapchainFormat)
@@ -800,6 +1322,15 @@ static std::optional<VkPipelineLayout> createPipelineLayout(const VkDevice& devi
     pipelineLayoutCreateInfo.setLayoutCount = 1;
     pipelineLayoutCreateInfo.pSetLayouts = &descriptorSetLayout;
 
+    // NOTE(MM): The fragment shader needs to know which cell buffer it reads, see CellBufferLayout.hpp.
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(FragmentPushConstants);
+
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+    pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
     VkPipelineLayout pipelineLayout;
     VK_RETURN_ON_ERROR_V(vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout),
                          std::nullopt);
@@ -827,14 +1358,15 @@ static std::optional<VkDescriptorSetLayout> createDescriptorSetLayout(const VkDe
     return descriptorSetLayout;
 }
 
+// NOTE(MM): Creates `descriptorSetCount` sets, set `i` refers to `cellBufferViews[i % cellBufferViews.size()]`.
 static std::optional<std::vector<VkDescriptorSet>>
 createDescriptorSets(const VulkanContext::DeviceWrapper& deviceWrapper,
                      const VkDescriptorSetLayout& descriptorSetLayout,
-                     const std::vector<VkBufferView>& cellBufferViews)
+                     const std::vector<VkBufferView>& cellBufferViews,
+                     size_t descriptorSetCount)
 
 {
-    std::array<VkDescriptorSetLayout, BUFFERS_PER_COMPUTE> descriptorSetLayouts{descriptorSetLayout,
-                                                                                descriptorSetLayout};
+    const std::vector<VkDescriptorSetLayout> descriptorSetLayouts(descriptorSetCount, descriptorSetLayout);
     VkDescriptorSetAllocateInfo allocateInfo{};
     allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocateInfo.descriptorPool = deviceWrapper.descriptorPool;
@@ -842,10 +1374,10 @@ createDescriptorSets(const VulkanContext::DeviceWrapper& deviceWrapper,
     allocateInfo.pSetLayouts = descriptorSetLayouts.data();
 
     const VkDevice device = deviceWrapper.device;
-    std::vector<VkDescriptorSet> descriptorSets(STORAGE_BUFFER_COUNT);
+    std::vector<VkDescriptorSet> descriptorSets(descriptorSetCount);
     VK_RETURN_ON_ERROR_V(vkAllocateDescriptorSets(device, &allocateInfo, descriptorSets.data()), std::nullopt);
 
-    for (size_t i = 0; i < BUFFERS_PER_COMPUTE; i++)
+    for (size_t i = 0; i < descriptorSetCount; i++)
     {
         VkWriteDescriptorSet writeDescriptorSet{};
         writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -854,7 +1386,7 @@ createDescriptorSets(const VulkanContext::DeviceWrapper& deviceWrapper,
         writeDescriptorSet.dstArrayElement = 0;
         writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
         writeDescriptorSet.descriptorCount = 1;
-        writeDescriptorSet.pTexelBufferView = &cellBufferViews[i];
+        writeDescriptorSet.pTexelBufferView = &cellBufferViews[i % cellBufferViews.size()];
 
         vkUpdateDescriptorSets(device, 1, &writeDescriptorSet, 0, nullptr);
     }
@@ -894,16 +1426,13 @@ createFramebuffers(const VkDevice& device, const VkRenderPass& renderPass, const
 }
 
 static std::optional<VulkanContext::GraphicsPipeline>
-createGraphicsPipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
-                       const VulkanContext::Swapchain& swapchain,
-                       const std::vector<VkBufferView>& cellBufferViews,
-                       const std::filesystem::path& executableDir)
+createGraphicsPipeline(const VkDevice device,
+                       const VkPipelineCache pipelineCache,
+                       const VkFormat swapchainImageFormat,
+                       const ShaderBinaries& shaderBinaries,
+                       const Configuration& configuration)
 {
-    std::filesystem::path vertexShaderPath(executableDir);
-    vertexShaderPath.append(ApplicationDefines::NonModifiable::VERTEX_SHADER_NAME);
-
-    const VkDevice device = deviceWrapper.device;
-    auto vertexShaderModuleOpt = createShaderModule(device, vertexShaderPath);
+    auto vertexShaderModuleOpt = createShaderModule(device, shaderBinaries.vertex);
     RETURN_ON_NULLOPT_V(vertexShaderModuleOpt, std::nullopt);
     VkShaderModule vertexShaderModule = vertexShaderModuleOpt.value();
 
@@ -913,16 +1442,13 @@ createGraphicsPipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
     vertexShaderStageInfo.module = vertexShaderModule;
     vertexShaderStageInfo.pName = "main";
 
-    std::filesystem::path fragmentShaderPath(executableDir);
-    fragmentShaderPath.append(ApplicationDefines::NonModifiable::FRAGMENT_SHADER_NAME);
-
-    auto fragmentShaderModuleOpt = createShaderModule(device, fragmentShaderPath);
+    auto fragmentShaderModuleOpt = createShaderModule(device, shaderBinaries.fragment);
     RETURN_ON_NULLOPT_V(fragmentShaderModuleOpt, std::nullopt);
     VkShaderModule fragmentShaderModule = fragmentShaderModuleOpt.value();
 
     const auto fragmentSpecializationMapEntries = FragmentSpecializationConstants::getSpecializationMapEntries();
-    FragmentSpecializationConstants fragmentSpecializationData{ApplicationDefines::GRID_WIDTH,
-                                                               ApplicationDefines::GRID_HEIGHT};
+    FragmentSpecializationConstants fragmentSpecializationData{
+        configuration.gridWidth, configuration.gridHeight, configuration.interleaveRowPairs};
 
     VkSpecializationInfo fragmentSpecializationInfo = {};
     fragmentSpecializationInfo.mapEntryCount = static_cast<uint32_t>(fragmentSpecializationMapEntries.size());
@@ -947,7 +1473,7 @@ createGraphicsPipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
     RETURN_ON_NULLOPT_V(pipelineLayoutOpt, std::nullopt);
     VkPipelineLayout pipelineLayout = pipelineLayoutOpt.value();
 
-    auto renderPassOpt = createRenderPass(device, swapchain.imageFormat);
+    auto renderPassOpt = createRenderPass(device, swapchainImageFormat);
     RETURN_ON_NULLOPT_V(renderPassOpt, std::nullopt);
     VkRenderPass renderPass = renderPassOpt.value();
 
@@ -1031,33 +1557,26 @@ createGraphicsPipeline(const VulkanContext::DeviceWrapper& deviceWrapper,
 
     VkPipeline pipeline;
     VK_RETURN_ON_ERROR_V(
-        vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphicsPipelineCreateInfo, nullptr, &pipeline),
+        vkCreateGraphicsPipelines(device, pipelineCache, 1, &graphicsPipelineCreateInfo, nullptr, &pipeline),
         std::nullopt);
 
-    auto descriptorSetsOpt = createDescriptorSets(deviceWrapper, descriptorSetLayout, cellBufferViews);
-    RETURN_ON_NULLOPT_V(descriptorSetsOpt, std::nullopt);
-    std::vector<VkDescriptorSet> descriptorSets = descriptorSetsOpt.value();
-
-    auto framebuffersOpt = createFramebuffers(device, renderPass, swapchain);
-    RETURN_ON_NULLOPT_V(framebuffersOpt, std::nullopt);
-    std::vector<VkFramebuffer> framebuffers = framebuffersOpt.value();
-
     return std::make_optional<VulkanContext::GraphicsPipeline>({pipeline,
                                                                 pipelineLayout,
                                                                 descriptorSetLayout,
                                                                 renderPass,
                                                                 vertexShaderModule,
                                                                 fragmentShaderModule,
-                                                                std::move(descriptorSets),
-                                                                std::move(framebuffers)});
+                                                                {},
+                                                                {}});
 }
 
-static std::optional<VkCommandPool> createCommandPool(const VulkanContext::DeviceWrapper& deviceWrapper)
+static std::optional<VkCommandPool> createCommandPool(const VulkanContext::DeviceWrapper& deviceWrapper,
+                                                      uint32_t queueFamilyIndex)
 {
     VkCommandPoolCreateInfo commandPoolCreateInfo{};
     commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    commandPoolCreateInfo.queueFamilyIndex = deviceWrapper.queueIndex;
+    commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
 
     VkCommandPool commandPool;
     VK_RETURN_ON_ERROR_V(vkCreateCommandPool(deviceWrapper.device, &commandPoolCreateInfo, nullptr, &commandPool),
@@ -1083,25 +1602,56 @@ static std::optional<VkCommandBuffer> createCommandBuffer(const VulkanContext::D
 }
 
 VulkanContext::VulkanContext(ApplicationSharedData& applicationSharedData,
-                             GlfwContext& glfwContext,
-                             const std::vector<uint32_t>& cellGrid)
-    : instance(VK_NULL_HANDLE)
+                             GlfwContext* glfwContext,
+                             const Configuration& configuration,
+                             const std::shared_future<PackedGrid>& cellGrid,
+                             const std::optional<RestoredState>& restoredState)
+    : configuration(configuration)
+    , instance(VK_NULL_HANDLE)
     , surface(VK_NULL_HANDLE)
-    , deviceWrapper({VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, 0, VK_NULL_HANDLE})
+    , deviceWrapper({VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 0, 0.0f})
     , swapchain({VK_NULL_HANDLE, VK_FORMAT_UNDEFINED, {0, 0}, {}, {}})
-    , computePipeline({VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, {}})
+    , computePipeline(
+          {VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, {}})
     , graphicsPipeline(
           {VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, VK_NULL_HANDLE, {}, {}})
+    , pipelineCache(VK_NULL_HANDLE)
+    , memoryArena(nullptr)
     , commandPool(VK_NULL_HANDLE)
-    , imageAvailableSemaphore(VK_NULL_HANDLE)
-    , renderingFinishedSemaphore(VK_NULL_HANDLE)
-    , inFlightFence(VK_NULL_HANDLE)
+    , asyncCompute({VK_NULL_HANDLE, {}, VK_NULL_HANDLE, VK_NULL_HANDLE, {}, {}, {}})
+    , activeTilesBuffer(VK_NULL_HANDLE)
+    , activeTilesBufferMemory({VK_NULL_HANDLE, 0, 0, nullptr, 0, DeviceMemoryArena::PoolType::Linear})
+    , checkpointBuffer(VK_NULL_HANDLE)
+    , checkpointBufferMemory({VK_NULL_HANDLE, 0, 0, nullptr, 0, DeviceMemoryArena::PoolType::Linear})
+    , startupTimings({{}, {}, {}, {}, {}, {}, {}, {}, {}, 0, false})
 #ifdef VALIDATION_LAYERS
     , _debugReportCallback(VK_NULL_HANDLE)
 #endif
+    , _pipelineCachePath()
+    , _pipelineCacheKey({0, 0, 0, {}, 0})
     , _glfwContext(glfwContext)
     , _isInitialized(false)
 {
+    // NOTE(MM): Startup runs as a small task graph to shorten the time to the first frame. The SPIR-V is read on a
+    // worker thread while instance and device are created. Afterwards, compute and graphics pipelines are compiled on
+    // worker threads while this thread creates the swapchain, frame resources and cell buffers. The cell buffers wait
+    // for the grid, which is generated by the caller (usually on another worker thread). Descriptor sets and
+    // framebuffers are created last on this thread, since the descriptor pool must not be used by several threads at
+    // once.
+    //
+    // Worker tasks only write their timing and the member they create. Early returns wait for running tasks in the
+    // destructors of the futures.
+    const auto startTime = std::chrono::steady_clock::now();
+    auto phaseStartTime = startTime;
+
+    const std::filesystem::path& executableDirectory = applicationSharedData.executableDirectory;
+    auto shaderBinariesFuture = std::async(std::launch::async, [this, &executableDirectory]() {
+        const auto taskStartTime = std::chrono::steady_clock::now();
+        auto shaderBinariesOpt = loadShaderBinaries(executableDirectory, isHeadless());
+        startupTimings.shaderLoading = std::chrono::steady_clock::now() - taskStartTime;
+        return shaderBinariesOpt;
+    });
+
     auto instanceOpt = createInstance(_glfwContext);
     RETURN_ON_NULLOPT(instanceOpt);
     instance = instanceOpt.value();
@@ -1112,70 +1662,277 @@ VulkanContext::VulkanContext(ApplicationSharedData& applicationSharedData,
     _debugReportCallback = debugReportCallbackOpt.value();
 #endif
 
-    // NOTE(MM): Use glfw functionality instead of directly calling 'vkCreateXcbSurfaceKHR' manually.
-    VK_RETURN_ON_ERROR(glfwContext.createWindowSurface(instance, nullptr, &surface));
+    if (!isHeadless())
+    {
+        // NOTE(MM): Use glfw functionality instead of directly calling 'vkCreateXcbSurfaceKHR' manually.
+        VK_RETURN_ON_ERROR(_glfwContext->createWindowSurface(instance, nullptr, &surface));
+    }
+
+    startupTimings.instance = std::chrono::steady_clock::now() - phaseStartTime;
+    phaseStartTime = std::chrono::steady_clock::now();
 
-    auto vulkanDeviceOpt = createDevice(instance, surface);
+    auto vulkanDeviceOpt = createDevice(instance, surface, configuration);
     RETURN_ON_NULLOPT(vulkanDeviceOpt);
     deviceWrapper = std::move(vulkanDeviceOpt.value());
 
-    auto swapchainOpt = createSwapchain(deviceWrapper, surface, _glfwContext);
-    RETURN_ON_NULLOPT(swapchainOpt);
-    swapchain = std::move(swapchainOpt.value());
+    memoryArena = std::make_unique<DeviceMemoryArena>(deviceWrapper.physicalDevice,
+                                                      deviceWrapper.device,
+                                                      ApplicationDefines::NonModifiable::DEVICE_MEMORY_BLOCK_SIZE);
+
+    startupTimings.device = std::chrono::steady_clock::now() - phaseStartTime;
+
+    auto shaderBinariesOpt = shaderBinariesFuture.get();
+    RETURN_ON_NULLOPT(shaderBinariesOpt);
+    const ShaderBinaries shaderBinaries = std::move(shaderBinariesOpt.value());
+
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(deviceWrapper.physicalDevice, &deviceProperties);
+    _pipelineCacheKey = PipelineCache::createKey(deviceProperties, shaderBinaries.hash);
+    _pipelineCachePath = executableDirectory;
+    _pipelineCachePath.append(ApplicationDefines::NonModifiable::PIPELINE_CACHE_FILE_NAME);
+
+    const std::vector<char> pipelineCacheData =
+        PipelineCache::loadData(_pipelineCachePath, _pipelineCacheKey).value_or(std::vector<char>{});
+    startupTimings.loadedPipelineCacheSize = pipelineCacheData.size();
+
+    const VkDevice device = deviceWrapper.device;
+    auto pipelineCacheOpt = createPipelineCache(device, pipelineCacheData);
+    RETURN_ON_NULLOPT(pipelineCacheOpt);
+    pipelineCache = pipelineCacheOpt.value();
+
+    auto computePipelineFuture = std::async(std::launch::async, [this, &shaderBinaries]() {
+        const auto taskStartTime = std::chrono::steady_clock::now();
+        auto computePipelineOpt =
+            createComputePipeline(deviceWrapper.device, pipelineCache, shaderBinaries, this->configuration);
+        startupTimings.computePipelines = std::chrono::steady_clock::now() - taskStartTime;
+        RETURN_ON_NULLOPT_V(computePipelineOpt, false);
+        computePipeline = std::move(computePipelineOpt.value());
+        return true;
+    });
+
+    std::future<bool> graphicsPipelineFuture;
+    if (!isHeadless())
+    {
+        auto swapchainOpt = createSwapchain(deviceWrapper, surface, *_glfwContext);
+        RETURN_ON_NULLOPT(swapchainOpt);
+        swapchain = std::move(swapchainOpt.value());
+
+        graphicsPipelineFuture = std::async(std::launch::async, [this, &shaderBinaries]() {
+            const auto taskStartTime = std::chrono::steady_clock::now();
+            auto graphicsPipelineOpt = createGraphicsPipeline(
+                deviceWrapper.device, pipelineCache, swapchain.imageFormat, shaderBinaries, this->configuration);
+            startupTimings.graphicsPipeline = std::chrono::steady_clock::now() - taskStartTime;
+            RETURN_ON_NULLOPT_V(graphicsPipelineOpt, false);
+            graphicsPipeline = std::move(graphicsPipelineOpt.value());
+            return true;
+        });
+    }
 
-    auto commandPoolOpt = createCommandPool(deviceWrapper);
+    phaseStartTime = std::chrono::steady_clock::now();
+
+    auto commandPoolOpt = createCommandPool(deviceWrapper, deviceWrapper.queueIndex);
     RETURN_ON_NULLOPT(commandPoolOpt);
     commandPool = commandPoolOpt.value();
 
-    auto commandBufferOpt = createCommandBuffer(deviceWrapper, commandPool);
-    RETURN_ON_NULLOPT(commandBufferOpt);
-    commandBuffer = std::move(commandBufferOpt.value());
+    // NOTE(MM): Allocate frame resources first (with null handles), so that the destructor cleans up properly in case
+    // creation fails halfway through.
+    frames.resize(ApplicationDefines::MAX_FRAMES_IN_FLIGHT, Frame{});
+    for (auto& frame : frames)
+    {
+        auto commandBufferOpt = createCommandBuffer(deviceWrapper, commandPool);
+        RETURN_ON_NULLOPT(commandBufferOpt);
+        frame.commandBuffer = commandBufferOpt.value();
+    }
 
-    // NOTE(MM): Creating and uploading buffers individually isn't the fastest approach. However, since
-    // we only do it twice for the whole application the overhead is negligible.
-    for (uint32_t i = 0; i < BUFFERS_PER_COMPUTE; ++i)
+    if (!isHeadless())
     {
-        auto localBufferAndMemoryOpt =
-            createDeviceLocalBuffer(deviceWrapper,
-                                    commandPool,
-                                    cellGrid,
-                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT);
+        VkSemaphoreCreateInfo semaphoreCreateInfo;
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreCreateInfo.pNext = nullptr;
+        semaphoreCreateInfo.flags = 0;
+        for (auto& frame : frames)
+        {
+            VK_RETURN_ON_ERROR(
+                vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &frame.imageAvailableSemaphore));
+            VK_RETURN_ON_ERROR(
+                vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &frame.renderingFinishedSemaphore));
+        }
+    }
 
-        RETURN_ON_NULLOPT(localBufferAndMemoryOpt);
-        auto [buffer, deviceMemory] = localBufferAndMemoryOpt.value();
+    VkFenceCreateInfo fenceCreateInfo{};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // otherwise we would wait for the fence on first draw
+    for (auto& frame : frames)
+    {
+        VK_RETURN_ON_ERROR(vkCreateFence(device, &fenceCreateInfo, nullptr, &frame.inFlightFence));
+    }
+
+    if (deviceWrapper.timestampValidBits > 0)
+    {
+        VkQueryPoolCreateInfo queryPoolCreateInfo{};
+        queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolCreateInfo.queryCount = TIMESTAMP_QUERY_COUNT;
+        for (auto& frame : frames)
+        {
+            VK_RETURN_ON_ERROR(vkCreateQueryPool(device, &queryPoolCreateInfo, nullptr, &frame.timestampQueryPool));
+        }
+    }
 
-        cellBuffers.push_back(buffer);
-        cellBuffersMemory.push_back(deviceMemory);
+    if (isUsingAsyncCompute())
+    {
+        auto computeCommandPoolOpt = createCommandPool(deviceWrapper, deviceWrapper.computeQueueIndex);
+        RETURN_ON_NULLOPT(computeCommandPoolOpt);
+        asyncCompute.commandPool = computeCommandPoolOpt.value();
+
+        asyncCompute.commandBuffers.resize(ApplicationDefines::MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+        for (auto& commandBuffer : asyncCompute.commandBuffers)
+        {
+            auto commandBufferOpt = createCommandBuffer(deviceWrapper, asyncCompute.commandPool);
+            RETURN_ON_NULLOPT(commandBufferOpt);
+            commandBuffer = commandBufferOpt.value();
+        }
+
+        VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo{};
+        semaphoreTypeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphoreTypeCreateInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo timelineSemaphoreCreateInfo{};
+        timelineSemaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        timelineSemaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+        VK_RETURN_ON_ERROR(
+            vkCreateSemaphore(device, &timelineSemaphoreCreateInfo, nullptr, &asyncCompute.generationSemaphore));
+        VK_RETURN_ON_ERROR(
+            vkCreateSemaphore(device, &timelineSemaphoreCreateInfo, nullptr, &asyncCompute.frameSemaphore));
     }
 
-    const size_t bufferSize = cellGrid.size() * sizeof(cellGrid[0]);
+    const CellBufferLayout cellBufferLayout(configuration);
+    const size_t cellWordCount = cellBufferLayout.getWordCount();
+    const uint32_t* cells = nullptr;
+    if (restoredState.has_value())
+    {
+        cells = restoredState.value().cells;
+    }
+    else
+    {
+        const auto gridWaitStartTime = std::chrono::steady_clock::now();
+        const PackedGrid& grid = cellGrid.get();
+        startupTimings.gridWait = std::chrono::steady_clock::now() - gridWaitStartTime;
+        assert(grid.getData().size() == cellBufferLayout.getGridWordCount()
+               && "VulkanContext: Grid doesn't match the configuration!");
+        cells = grid.getData().data();
+    }
+
+    // NOTE(MM): Without interleaving, the grid is uploaded as is to both buffers. Otherwise, each buffer has its own
+    // layout.
+    std::vector<std::vector<uint32_t>> layoutCells;
+    std::vector<const uint32_t*> cellBufferData(configuration.getCellBufferCount(), cells);
+    if (cellBufferLayout.isInterleaved())
+    {
+        layoutCells.resize(cellBufferData.size(), std::vector<uint32_t>(cellWordCount));
+        for (size_t i = 0; i < cellBufferData.size(); ++i)
+        {
+            cellBufferLayout.pack(i, cells, layoutCells[i].data());
+            cellBufferData[i] = layoutCells[i].data();
+        }
+    }
+
+    auto cellBuffersOpt =
+        createDeviceLocalBuffers(deviceWrapper,
+                                 *memoryArena,
+                                 commandPool,
+                                 cellBufferData,
+                                 cellWordCount,
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT
+                                     | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    RETURN_ON_NULLOPT(cellBuffersOpt);
+    cellBuffers = std::move(cellBuffersOpt.value().buffers);
+    cellBuffersMemory = std::move(cellBuffersOpt.value().buffersMemory);
+    startupTimings.isZeroCopyUpload = cellBuffersOpt.value().isHostVisible;
+
+    const size_t bufferSize = cellWordCount * sizeof(uint32_t);
     auto buffersViewOpt = createBufferViews(deviceWrapper, cellBuffers, bufferSize);
     RETURN_ON_NULLOPT(buffersViewOpt);
     cellBuffersView = std::move(buffersViewOpt.value());
 
-    const std::filesystem::path& executableDirectory = applicationSharedData.executableDirectory;
-    auto computePipelineOpt =
-        createComputePipeline(deviceWrapper, cellBuffers, cellBuffersView, executableDirectory, bufferSize);
-    RETURN_ON_NULLOPT(computePipelineOpt);
-    computePipeline = std::move(computePipelineOpt.value());
+    // NOTE(MM): Initially, all tiles are active and "changed" in the initial generation, so that the first two
+    // generations are computed completely.
+    const uint32_t initialGeneration = restoredState.has_value() ? restoredState.value().generation : 0;
+    const uint32_t tileCount = configuration.getTileCount();
+    std::vector<uint32_t> activeTilesData(configuration.getActiveTilesBufferWordCount(), initialGeneration);
+    activeTilesData[0] = tileCount;
+    activeTilesData[1] = 1;
+    activeTilesData[2] = 1;
+    for (uint32_t tile = 0; tile < tileCount; ++tile)
+    {
+        activeTilesData[ApplicationDefines::NonModifiable::ACTIVE_TILES_HEADER_WORD_COUNT + tile] = tile;
+    }
 
-    auto graphicsPipelineOpt = createGraphicsPipeline(deviceWrapper, swapchain, cellBuffersView, executableDirectory);
-    RETURN_ON_NULLOPT(graphicsPipelineOpt);
-    graphicsPipeline = std::move(graphicsPipelineOpt.value());
+    auto activeTilesBufferOpt =
+        createDeviceLocalBuffers(deviceWrapper,
+                                 *memoryArena,
+                                 commandPool,
+                                 std::vector<const uint32_t*>{activeTilesData.data()},
+                                 activeTilesData.size(),
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    RETURN_ON_NULLOPT(activeTilesBufferOpt);
+    activeTilesBuffer = activeTilesBufferOpt.value().buffers[0];
+    activeTilesBufferMemory = activeTilesBufferOpt.value().buffersMemory[0];
+
+    if (isUsingAsyncCompute())
+    {
+        auto displayBuffersOpt =
+            createDeviceLocalBuffers(deviceWrapper,
+                                     *memoryArena,
+                                     commandPool,
+                                     std::vector<const uint32_t*>(DISPLAY_BUFFER_COUNT, cellBufferData[0]),
+                                     cellWordCount,
+                                     VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT);
+        RETURN_ON_NULLOPT(displayBuffersOpt);
+        asyncCompute.displayBuffers = std::move(displayBuffersOpt.value().buffers);
+        asyncCompute.displayBuffersMemory = std::move(displayBuffersOpt.value().buffersMemory);
+
+        auto displayBuffersViewOpt = createBufferViews(deviceWrapper, asyncCompute.displayBuffers, bufferSize);
+        RETURN_ON_NULLOPT(displayBuffersViewOpt);
+        asyncCompute.displayBuffersView = std::move(displayBuffersViewOpt.value());
+    }
 
-    const VkDevice device = deviceWrapper.device;
-    VkSemaphoreCreateInfo semaphoreCreateInfo;
-    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    semaphoreCreateInfo.pNext = nullptr;
-    semaphoreCreateInfo.flags = 0;
-    VK_RETURN_ON_ERROR(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &imageAvailableSemaphore));
-    VK_RETURN_ON_ERROR(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &renderingFinishedSemaphore));
+    startupTimings.buffers = std::chrono::steady_clock::now() - phaseStartTime - startupTimings.gridWait;
 
-    VkFenceCreateInfo fenceCreateInfo{};
-    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // otherwise we would wait for the fence on first draw
-    VK_RETURN_ON_ERROR(vkCreateFence(device, &fenceCreateInfo, nullptr, &inFlightFence));
+    const auto pipelineWaitStartTime = std::chrono::steady_clock::now();
+    const bool isComputePipelineCreated = computePipelineFuture.get();
+    const bool isGraphicsPipelineCreated = !graphicsPipelineFuture.valid() || graphicsPipelineFuture.get();
+    startupTimings.pipelineWait = std::chrono::steady_clock::now() - pipelineWaitStartTime;
+    if (!isComputePipelineCreated || !isGraphicsPipelineCreated)
+    {
+        return;
+    }
+
+    auto computeDescriptorSetsOpt = createComputeDescriptorSets(
+        deviceWrapper, computePipeline.descriptorSetLayout, cellBuffers, activeTilesBuffer, bufferSize);
+    RETURN_ON_NULLOPT(computeDescriptorSetsOpt);
+    computePipeline.descriptorSets = std::move(computeDescriptorSetsOpt.value());
+
+    if (!isHeadless())
+    {
+        auto descriptorSetsOpt = isUsingAsyncCompute() ? createDescriptorSets(deviceWrapper,
+                                                                              graphicsPipeline.descriptorSetLayout,
+                                                                              asyncCompute.displayBuffersView,
+                                                                              DISPLAY_BUFFER_COUNT)
+                                                       : createDescriptorSets(deviceWrapper,
+                                                                              graphicsPipeline.descriptorSetLayout,
+                                                                              cellBuffersView,
+                                                                              BUFFERS_PER_COMPUTE);
+        RETURN_ON_NULLOPT(descriptorSetsOpt);
+        graphicsPipeline.descriptorSets = std::move(descriptorSetsOpt.value());
+
+        auto framebuffersOpt = createFramebuffers(device, graphicsPipeline.renderPass, swapchain);
+        RETURN_ON_NULLOPT(framebuffersOpt);
+        graphicsPipeline.framebuffers = std::move(framebuffersOpt.value());
+    }
 
+    startupTimings.total = std::chrono::steady_clock::now() - startTime;
     _isInitialized = true;
 }
 
@@ -1184,9 +1941,32 @@ VulkanContext::~VulkanContext()
     const VkDevice device = deviceWrapper.device;
     if (device != VK_NULL_HANDLE)
     {
-        vkDestroyFence(device, inFlightFence, nullptr);
-        vkDestroySemaphore(device, renderingFinishedSemaphore, nullptr);
-        vkDestroySemaphore(device, imageAvailableSemaphore, nullptr);
+        // NOTE(MM): Only store caches of fully initialized contexts, a failed startup may have left out pipelines.
+        // Failing to store the cache isn't fatal, the next start just takes longer.
+        if (_isInitialized)
+        {
+            storePipelineCache(device, pipelineCache, _pipelineCachePath, _pipelineCacheKey);
+        }
+        vkDestroyPipelineCache(device, pipelineCache, nullptr);
+
+        for (auto& frame : frames)
+        {
+            vkDestroyQueryPool(device, frame.timestampQueryPool, nullptr);
+            vkDestroyFence(device, frame.inFlightFence, nullptr);
+            vkDestroySemaphore(device, frame.renderingFinishedSemaphore, nullptr);
+            vkDestroySemaphore(device, frame.imageAvailableSemaphore, nullptr);
+        }
+
+        vkDestroySemaphore(device, asyncCompute.frameSemaphore, nullptr);
+        vkDestroySemaphore(device, asyncCompute.generationSemaphore, nullptr);
+        for (auto& displayBufferView : asyncCompute.displayBuffersView)
+        {
+            vkDestroyBufferView(device, displayBufferView, nullptr);
+        }
+        for (auto& displayBuffer : asyncCompute.displayBuffers)
+        {
+            vkDestroyBuffer(device, displayBuffer, nullptr);
+        }
 
         for (auto& framebuffer : graphicsPipeline.framebuffers)
         {
@@ -1200,19 +1980,23 @@ VulkanContext::~VulkanContext()
         vkDestroyShaderModule(device, graphicsPipeline.fragmentShader, nullptr);
         vkDestroyShaderModule(device, graphicsPipeline.vertexShader, nullptr);
 
+        vkDestroyPipeline(device, computePipeline.activeTilesPipeline, nullptr);
         vkDestroyPipeline(device, computePipeline.pipeline, nullptr);
         vkDestroyPipelineLayout(device, computePipeline.pipelineLayout, nullptr);
         vkDestroyDescriptorSetLayout(device, computePipeline.descriptorSetLayout, nullptr);
+        vkDestroyShaderModule(device, computePipeline.activeTilesShader, nullptr);
         vkDestroyShaderModule(device, computePipeline.shader, nullptr);
 
-        for (auto& cellBufferView : cellBuffersView)
+        vkDestroyBuffer(device, activeTilesBuffer, nullptr);
+        vkDestroyBuffer(device, checkpointBuffer, nullptr);
+        for (auto& recordingBuffer : recordingBuffers)
         {
-            vkDestroyBufferView(device, cellBufferView, nullptr);
+            vkDestroyBuffer(device, recordingBuffer, nullptr);
         }
 
-        for (auto& cellBufferMemory : cellBuffersMemory)
+        for (auto& cellBufferView : cellBuffersView)
         {
-            vkFreeMemory(device, cellBufferMemory, nullptr);
+            vkDestroyBufferView(device, cellBufferView, nullptr);
         }
 
         for (auto& cellBuffer : cellBuffers)
@@ -1220,6 +2004,10 @@ VulkanContext::~VulkanContext()
             vkDestroyBuffer(device, cellBuffer, nullptr);
         }
 
+        // NOTE(MM): Destroying the arena frees all its blocks, so single allocations don't have to be freed here.
+        memoryArena.reset();
+
+        vkDestroyCommandPool(device, asyncCompute.commandPool, nullptr);
         vkDestroyCommandPool(device, commandPool, nullptr);
 
         for (auto& imageView : swapchain.imageViews)
@@ -1227,14 +2015,21 @@ VulkanContext::~VulkanContext()
             vkDestroyImageView(device, imageView, nullptr);
         }
 
-        vkDestroySwapchainKHR(device, swapchain.swapchain, nullptr);
+        // NOTE(MM): The swapchain extension isn't enabled in headless mode.
+        if (swapchain.swapchain != VK_NULL_HANDLE)
+        {
+            vkDestroySwapchainKHR(device, swapchain.swapchain, nullptr);
+        }
         vkDestroyDescriptorPool(device, deviceWrapper.descriptorPool, nullptr);
         vkDestroyDevice(device, nullptr);
     }
 
     if (instance != VK_NULL_HANDLE)
     {
-        vkDestroySurfaceKHR(instance, surface, nullptr);
+        if (surface != VK_NULL_HANDLE)
+        {
+            vkDestroySurfaceKHR(instance, surface, nullptr);
+        }
 
 #ifdef VALIDATION_LAYERS
         auto destroyDebugReportCallbackFP = reinterpret_cast<PFN_vkDestroyDebugReportCallbackEXT>(
@@ -1250,16 +2045,34 @@ VulkanContext::operator bool() const
     return _isInitialized;
 }
 
+bool VulkanContext::isHeadless(void) const
+{
+    return _glfwContext == nullptr;
+}
+
+bool VulkanContext::isUsingAsyncCompute(void) const
+{
+    return deviceWrapper.computeQueue != VK_NULL_HANDLE;
+}
+
 bool VulkanContext::recreateSwapchain(void)
 {
+    assert(!isHeadless() && "recreateSwapchain: No swapchain in headless mode!");
+
     const VkDevice device = deviceWrapper.device;
 
-    vkDeviceWaitIdle(device);
+    // NOTE(MM): Only the graphics queue uses the swapchain. Waiting for the whole device would also need to synchronize
+    // with the async compute thread submitting to its queue meanwhile.
+    vkQueueWaitIdle(deviceWrapper.queue);
 
     // NOTE(MM): Recreating of swapchain possibly happens after the call to 'vkAcquireNextImageKHR'. In this case the
-    // 'imageAvailableSemaphore' ends up in a signaled state, which is probably not wanted. Hence, recreate this
-    // semaphore here.
-    vkDestroySemaphore(device, imageAvailableSemaphore, nullptr);
+    // 'imageAvailableSemaphore' ends up in a signaled state, which is probably not wanted. Hence, recreate these
+    // semaphores here.
+    for (auto& frame : frames)
+    {
+        vkDestroySemaphore(device, frame.imageAvailableSemaphore, nullptr);
+        frame.imageAvailableSemaphore = VK_NULL_HANDLE;
+    }
 
     for (auto& framebuffer : graphicsPipeline.framebuffers)
     {
@@ -1271,7 +2084,7 @@ bool VulkanContext::recreateSwapchain(void)
     }
     vkDestroySwapchainKHR(device, swapchain.swapchain, nullptr);
 
-    auto swapchainOpt = createSwapchain(deviceWrapper, surface, _glfwContext);
+    auto swapchainOpt = createSwapchain(deviceWrapper, surface, *_glfwContext);
     RETURN_ON_NULLOPT_V(swapchainOpt, false);
     swapchain = std::move(swapchainOpt.value());
 
@@ -1283,9 +2096,85 @@ bool VulkanContext::recreateSwapchain(void)
     semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
     semaphoreCreateInfo.pNext = nullptr;
     semaphoreCreateInfo.flags = 0;
-    VK_RETURN_ON_ERROR_V(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &imageAvailableSemaphore), false);
+    for (auto& frame : frames)
+    {
+        VK_RETURN_ON_ERROR_V(vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &frame.imageAvailableSemaphore),
+                             false);
+    }
 
     return true;
 }
 
+bool VulkanContext::createCheckpointBuffer(void)
+{
+    if (checkpointBuffer != VK_NULL_HANDLE)
+    {
+        return true;
+    }
+
+    auto bufferAndMemoryOpt = createReadbackBuffer(deviceWrapper, *memoryArena, configuration);
+    RETURN_ON_NULLOPT_V(bufferAndMemoryOpt, false);
+
+    std::tie(checkpointBuffer, checkpointBufferMemory) = bufferAndMemoryOpt.value();
+    return true;
+}
+
+bool VulkanContext::createRecordingBuffers(size_t count)
+{
+    assert(recordingBuffers.empty() && "createRecordingBuffers: Recording buffers already exist!");
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto bufferAndMemoryOpt = createReadbackBuffer(deviceWrapper, *memoryArena, configuration);
+        RETURN_ON_NULLOPT_V(bufferAndMemoryOpt, false);
+
+        const auto& [buffer, memory] = bufferAndMemoryOpt.value();
+        recordingBuffers.push_back(buffer);
+        recordingBuffersMemory.push_back(memory);
+    }
+
+    return true;
+}
+
+VkBuffer VulkanContext::getCellBuffer(size_t bufferIndex) const
+{
+    assert(bufferIndex < BUFFERS_PER_COMPUTE && "getCellBuffer: Buffer index out of range!");
+    return cellBuffers[bufferIndex % cellBuffers.size()];
+}
+
+std::optional<PackedGrid> VulkanContext::readCellBuffer(size_t bufferIndex) const
+{
+    const auto bufferSize = static_cast<VkDeviceSize>(configuration.getCellBufferWordCount() * sizeof(uint32_t));
+    auto stagingBufferAndMemoryOpt =
+        createBuffer(deviceWrapper,
+                     *memoryArena,
+                     bufferSize,
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     DeviceMemoryArena::PoolType::FreeList);
+    RETURN_ON_NULLOPT_V(stagingBufferAndMemoryOpt, std::nullopt);
+    auto [stagingBuffer, stagingBufferMemory] = stagingBufferAndMemoryOpt.value();
+
+    const VkDevice device = deviceWrapper.device;
+    std::optional<PackedGrid> result = std::nullopt;
+
+    // NOTE(MM): With async compute, the cell buffers are written on the compute queue, whose command pool belongs to
+    // the compute thread.
+    const bool useComputeQueue = isUsingAsyncCompute();
+    const VkCommandPool pool = useComputeQueue ? asyncCompute.commandPool : commandPool;
+    const VkQueue queue = useComputeQueue ? deviceWrapper.computeQueue : deviceWrapper.queue;
+    if (copyBufferToHost(deviceWrapper, pool, queue, getCellBuffer(bufferIndex), stagingBuffer, bufferSize))
+    {
+        PackedGrid cells(configuration.gridWidth, configuration.gridHeight);
+        CellBufferLayout(configuration)
+            .unpack(bufferIndex, static_cast<const uint32_t*>(stagingBufferMemory.mappedData), cells.getData().data());
+        result = std::move(cells);
+    }
+
+    memoryArena->free(stagingBufferMemory);
+    vkDestroyBuffer(device, stagingBuffer, nullptr);
+
+    return result;
+}
+
 } // namespace VkHourglass
@@ -1,10 +1,21 @@
 #ifndef VULKANHOURGLASS_VULKANCONTEXT_HPP
 #define VULKANHOURGLASS_VULKANCONTEXT_HPP
 
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
 #include <vector>
 
 #include <vulkan/vulkan_core.h>
 
+#include "ApplicationDefines.hpp"
+#include "Configuration.hpp"
+#include "DeviceMemoryArena.hpp"
+#include "PackedGrid.hpp"
+#include "PipelineCache.hpp"
+
 namespace VkHourglass
 {
 
@@ -15,11 +26,34 @@ class GlfwContext;
 class VulkanContext
 {
 public:
+    // Cells (in the layout of `PackedGrid::getData()`) and generation counter to continue from, e.g. of a checkpoint.
+    struct RestoredState
+    {
+        const uint32_t* cells;
+        uint32_t generation;
+    };
+
     // Initialize Vulkan and create all needed resources.
     // Check with `operator bool()` if initialization succeeded.
+    //
+    // Passing no `glfwContext` creates a headless context: No surface, swapchain, graphics pipeline or presentation
+    // semaphores are created and a compute queue is chosen instead of a graphics/present one.
+    //
+    // In window mode with `Configuration::useAsyncCompute`, a second queue and the resources of `asyncCompute` are
+    // created if the device supports it, see `isUsingAsyncCompute()`.
+    //
+    // `cellGrid` has to match the grid size of `configuration`. It is only waited for right before the cell buffers are
+    // created, so it can be generated concurrently to instance/device creation and pipeline compilation. If
+    // `restoredState` is passed, its cells are uploaded instead (directly from the passed memory, which has to stay
+    // valid during construction) and `cellGrid` isn't used.
+    //
+    // Pipelines are created with a pipeline cache which is loaded from and, on destruction, written back to
+    // `ApplicationDefines::NonModifiable::PIPELINE_CACHE_FILE_NAME` in the executable directory.
     explicit VulkanContext(ApplicationSharedData& applicationSharedData,
-                           GlfwContext& glfwContext,
-                           const std::vector<uint32_t>& cellGrid);
+                           GlfwContext* glfwContext,
+                           const Configuration& configuration,
+                           const std::shared_future<PackedGrid>& cellGrid,
+                           const std::optional<RestoredState>& restoredState);
     ~VulkanContext();
 
     // NOTE(MM): We don't need copies/moves in our application. Therefore, delete copy/moves operations to avoid
@@ -31,9 +65,28 @@ public:
 
     explicit operator bool() const;
 
+    bool isHeadless(void) const;
+    // Whether the generations are computed on `deviceWrapper.computeQueue`, see `AsyncCompute`.
+    bool isUsingAsyncCompute(void) const;
     bool recreateSwapchain(void);
 
+    // Cell buffer holding the generations with partition offset `bufferIndex` (0 or 1), i.e. the only one when stepping
+    // in place.
+    VkBuffer getCellBuffer(size_t bufferIndex) const;
+    // Copy the content of `getCellBuffer(bufferIndex)` to host memory. Waits for the queue to be idle, so don't use it
+    // in performance critical paths. With async compute, this uses the compute queue, i.e. only call it from the
+    // compute thread or after it has been joined.
+    std::optional<PackedGrid> readCellBuffer(size_t bufferIndex) const;
+
+    // Create `checkpointBuffer` if it doesn't exist yet.
+    bool createCheckpointBuffer(void);
+    // Create `count` recording buffers, see `recordingBuffers`.
+    bool createRecordingBuffers(size_t count);
+
 public:
+    // Settings used for specialization constants, buffer sizes and dispatch counts.
+    const Configuration configuration;
+
     VkInstance instance;
     VkSurfaceKHR surface;
 
@@ -43,7 +96,14 @@ public:
         VkDevice device;
         VkQueue queue;
         uint32_t queueIndex;
+        // Second queue for async compute, either of a compute family (`computeQueueIndex`) or of `queueIndex`.
+        // `VK_NULL_HANDLE` if async compute isn't used.
+        VkQueue computeQueue;
+        uint32_t computeQueueIndex;
         VkDescriptorPool descriptorPool;
+        // Valid bits of timestamps written on `queue` (0 if timestamps aren't supported) and nanoseconds per tick.
+        uint32_t timestampValidBits;
+        float timestampPeriod;
     };
     DeviceWrapper deviceWrapper;
 
@@ -57,12 +117,16 @@ public:
     };
     Swapchain swapchain;
 
+    // NOTE(MM): The pipeline building the list of active tiles ('activeTiles.comp') shares layout and descriptor sets
+    // with the cell update pipeline.
     struct ComputePipeline
     {
         VkPipeline pipeline;
+        VkPipeline activeTilesPipeline;
         VkPipelineLayout pipelineLayout;
         VkDescriptorSetLayout descriptorSetLayout;
         VkShaderModule shader;
+        VkShaderModule activeTilesShader;
         std::vector<VkDescriptorSet> descriptorSets;
     };
     ComputePipeline computePipeline;
@@ -80,23 +144,109 @@ public:
     };
     GraphicsPipeline graphicsPipeline;
 
+    VkPipelineCache pipelineCache;
+
+    // All buffer memory is sub-allocated from the arena. Created right after the device, destroyed right before it.
+    std::unique_ptr<DeviceMemoryArena> memoryArena;
+
     VkCommandPool commandPool;
-    VkCommandBuffer commandBuffer;
 
-    VkSemaphore imageAvailableSemaphore;
-    VkSemaphore renderingFinishedSemaphore;
-    VkFence inFlightFence;
+    // GPU timestamps written per frame, see `Frame::timestampQueryPool`.
+    enum TimestampQuery : uint32_t
+    {
+        TIMESTAMP_FRAME_BEGIN,
+        TIMESTAMP_COMPUTE_END,
+        TIMESTAMP_DRAW_END,
+        TIMESTAMP_QUERY_COUNT,
+    };
+
+    // Per frame resources, `ApplicationDefines::MAX_FRAMES_IN_FLIGHT` of them are used round robin. The presentation
+    // semaphores are only created in window mode. The timestamp query pool (`TIMESTAMP_QUERY_COUNT` queries) is
+    // `VK_NULL_HANDLE` if the queue doesn't support timestamps.
+    struct Frame
+    {
+        VkCommandBuffer commandBuffer;
+        VkSemaphore imageAvailableSemaphore;
+        VkSemaphore renderingFinishedSemaphore;
+        VkFence inFlightFence;
+        VkQueryPool timestampQueryPool;
+    };
+    std::vector<Frame> frames;
+
+    // Display buffers of async compute, the last one is only overwritten once all frames drawing it are done.
+    static constexpr size_t DISPLAY_BUFFER_COUNT = ApplicationDefines::MAX_FRAMES_IN_FLIGHT + 1;
+
+    // Resources of async compute (see `ApplicationDefines::USE_ASYNC_COMPUTE`), only created if
+    // `isUsingAsyncCompute()`. The compute submissions use `commandBuffers` round robin and copy their last generation
+    // to a display buffer, which frames draw from instead of the cell buffers (`GraphicsPipeline::descriptorSets` refer
+    // to the display buffers then).
+    //
+    // Both semaphores are timeline semaphores: Compute submissions signal `generationSemaphore` with their submission
+    // number (counting from 1), frames signal `frameSemaphore` with their frame number (counting from 1). The display
+    // buffers are written with the last generation of submission `i` at `i % DISPLAY_BUFFER_COUNT` and initially hold
+    // the initial grid (in the layout of cell buffer 0). Buffers are shared by both queue families if they differ.
+    struct AsyncCompute
+    {
+        VkCommandPool commandPool;
+        std::vector<VkCommandBuffer> commandBuffers;
+        VkSemaphore generationSemaphore;
+        VkSemaphore frameSemaphore;
+        std::vector<VkBuffer> displayBuffers;
+        std::vector<DeviceMemoryArena::Allocation> displayBuffersMemory;
+        std::vector<VkBufferView> displayBuffersView;
+    };
+    AsyncCompute asyncCompute;
 
     std::vector<VkBuffer> cellBuffers;
-    std::vector<VkDeviceMemory> cellBuffersMemory;
+    std::vector<DeviceMemoryArena::Allocation> cellBuffersMemory;
     std::vector<VkBufferView> cellBuffersView;
 
+    // Indirect dispatch arguments and tile lists of the active region tracking, see 'shaders/tiles.comp'.
+    VkBuffer activeTilesBuffer;
+    DeviceMemoryArena::Allocation activeTilesBufferMemory;
+
+    // Host visible buffer of the size of a cell buffer, which the cells are copied to as part of a regular submission
+    // to checkpoint them without waiting for the queue. `VK_NULL_HANDLE` until `createCheckpointBuffer()` is called.
+    VkBuffer checkpointBuffer;
+    DeviceMemoryArena::Allocation checkpointBufferMemory;
+
+    // Ring of host visible buffers like `checkpointBuffer`, which generations are copied to for `FrameRecorder`. Empty
+    // until `createRecordingBuffers()` is called.
+    std::vector<VkBuffer> recordingBuffers;
+    std::vector<DeviceMemoryArena::Allocation> recordingBuffersMemory;
+
+    // Wall clock time spent in the constructor, split by its slowest parts. `instance` includes the surface and
+    // `buffers` the frame resources and the upload of the initial grid. Shader loading and pipeline compilation run
+    // on worker threads concurrently to the other parts, the time the constructor had to wait for them (and the grid)
+    // is listed separately.
+    struct StartupTimings
+    {
+        std::chrono::nanoseconds instance;
+        std::chrono::nanoseconds device;
+        std::chrono::nanoseconds buffers;
+        std::chrono::nanoseconds shaderLoading;
+        std::chrono::nanoseconds computePipelines;
+        std::chrono::nanoseconds graphicsPipeline;
+        std::chrono::nanoseconds gridWait;
+        std::chrono::nanoseconds pipelineWait;
+        std::chrono::nanoseconds total;
+        // Size of the pipeline cache data loaded from disk, 0 if there was no (valid) cache.
+        size_t loadedPipelineCacheSize;
+        // Whether the initial grid was written directly to host visible device local memory instead of being copied
+        // through a staging buffer.
+        bool isZeroCopyUpload;
+    };
+    StartupTimings startupTimings;
+
 private:
 #ifdef VALIDATION_LAYERS
     VkDebugReportCallbackEXT _debugReportCallback;
 #endif
 
-    GlfwContext& _glfwContext;
+    std::filesystem::path _pipelineCachePath;
+    PipelineCache::Key _pipelineCacheKey;
+
+    GlfwContext* _glfwContext;
     bool _isInitialized;
 };
 
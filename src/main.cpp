@@ -1,37 +1,172 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <optional>
 #include <random>
+#include <string>
+#include <string_view>
 
 #include "ApplicationDefines.hpp"
 #include "ApplicationSharedData.hpp"
+#include "AsyncComputeThread.hpp"
+#include "BenchmarkReport.hpp"
+#include "CellBufferLayout.hpp"
+#include "Checkpoint.hpp"
+#include "CheckpointWriter.hpp"
 #include "ComputeUpdateTimer.hpp"
+#include "Configuration.hpp"
+#include "CrossCheck.hpp"
+#include "FrameRecorder.hpp"
+#include "FrameRecording.hpp"
 #include "GlfwContext.hpp"
+#include "GpuCommands.hpp"
 #include "Grid.hpp"
 #include "Macros.hpp"
+#include "MargolusEngine.hpp"
 #include "PushConstants.hpp"
 #include "RuntimeStatistics.hpp"
+#include "SimdMargolusEngine.hpp"
 #include "VulkanContext.hpp"
 
-static bool beginCommandBuffer(const VkCommandBuffer commandBuffer);
+// NOTE(MM): Exit code of settings violating `validateConfiguration()`, distinct from other failures so that sweeps
+// (see 'tools/runBenchmarks.sh') can skip combinations which don't apply instead of repeating the rules.
+static constexpr int EXIT_INVALID_CONFIGURATION = 2;
 
-static void recordComputeCommands(const VkHourglass::VulkanContext::ComputePipeline& computePipeline,
-                                  const VkCommandBuffer commandBuffer,
-                                  size_t currentBuffer,
-                                  std::mt19937& mtRand);
+struct GridGenerator
+{
+    const char* name;
+    VkHourglass::PackedGrid (*generate)(const VkHourglass::Configuration& configuration);
+};
+
+static const std::array<GridGenerator, 4> GRID_GENERATORS = {{
+    {"hourglass", VkHourglass::generateHourglass},
+    {"noise", VkHourglass::generateRandomNoise},
+    {"circles", VkHourglass::generateRandomCircles},
+    {"center", VkHourglass::generateCenterCircle},
+}};
+
+struct CpuKernel
+{
+    const char* name;
+    VkHourglass::SimdMargolusEngine::Kernel kernel;
+};
+
+static const std::array<CpuKernel, 3> CPU_KERNELS = {{
+    {"bit-sliced", VkHourglass::SimdMargolusEngine::Kernel::BitSliced},
+    {"avx2", VkHourglass::SimdMargolusEngine::Kernel::Avx2},
+    {"scalar", VkHourglass::SimdMargolusEngine::Kernel::Scalar},
+}};
 
-static void addMemoryBarrier(const VkCommandBuffer commandBuffer,
-                             uint32_t queueIndex,
-                             size_t currentBuffer,
-                             const std::vector<VkBuffer>& cellBuffers);
+struct RecordingFormat
+{
+    const char* name;
+    VkHourglass::FrameRecorder::Format format;
+};
+
+static const std::array<RecordingFormat, 3> RECORDING_FORMATS = {{
+    {"delta", VkHourglass::FrameRecorder::Format::Delta},
+    {"y4m", VkHourglass::FrameRecorder::Format::Y4m},
+    {"pgm", VkHourglass::FrameRecorder::Format::Pgm},
+}};
+
+// Which timestamps of a frame's query pool were written, see `readFrameTimestamps()`.
+struct FrameTimestamps
+{
+    bool isPending;
+    bool hasCompute;
+};
+
+struct CommandLineArguments
+{
+    // Number of generations to compute without window, swapchain and presentation. Window mode if not set.
+    std::optional<uint64_t> headlessStepCount;
+    // Compute the headless generations on the CPU (see SimdMargolusEngine.hpp) instead of the GPU.
+    bool useCpu;
+    const CpuKernel* cpuKernel;
+    const GridGenerator* generator;
+    // Output format of the headless timings, see BenchmarkReport.hpp.
+    VkHourglass::BenchmarkReport::Format reportFormat;
+    // Defaults, overridden by '--config <file>' and '--set <key>=<value>' in the given order.
+    VkHourglass::Configuration configuration;
+    // Checkpoint to continue from ('--restore <file>').
+    std::optional<std::filesystem::path> restorePath;
+    // Checkpoint written at exit and every `checkpointInterval` generations if not 0 ('--checkpoint <file>
+    // [--checkpoint-interval <generation count>]').
+    std::optional<std::filesystem::path> checkpointPath;
+    uint32_t checkpointInterval;
+    // Recording of every `recordInterval`th generation ('--record <file> [--record-interval <generation count>]
+    // [--record-format <delta|y4m|pgm>]').
+    std::optional<std::filesystem::path> recordPath;
+    uint32_t recordInterval;
+    const RecordingFormat* recordFormat;
+    // Delta recording to convert to `recordFormat` instead of running the simulation ('--convert-recording <delta file>
+    // <output file>').
+    std::optional<std::pair<std::filesystem::path, std::filesystem::path>> convertRecordingPaths;
+    // Key of the random numbers of the stuck rule ('--seed <n>', see Hash.hpp). Random if not set, restored runs use
+    // the one of the checkpoint.
+    std::optional<uint32_t> seed;
+    // Compare the generations to the CPU reference implementation ('--cross-check', see
+    // `ApplicationDefines::ENABLE_CPU_CROSS_CHECK`, which is the default).
+    bool crossCheck;
+};
+
+static std::optional<CommandLineArguments> parseCommandLineArguments(int argc, char* argv[]);
+
+static bool runHeadless(VkHourglass::VulkanContext& context,
+                        std::optional<VkHourglass::MargolusEngine>& margolusEngine,
+                        uint32_t seed,
+                        const CommandLineArguments& arguments,
+                        size_t& currentGridBuffer,
+                        uint32_t& generation,
+                        VkHourglass::CheckpointWriter& checkpointWriter,
+                        VkHourglass::FrameRecording& recording);
+
+static bool runHeadlessCpu(const VkHourglass::PackedGrid& grid,
+                           std::optional<VkHourglass::MargolusEngine>& margolusEngine,
+                           uint32_t seed,
+                           const CommandLineArguments& arguments);
+
+static void printReport(const VkHourglass::BenchmarkReport& report, VkHourglass::BenchmarkReport::Format format);
+
+static void addPreviousFrameBarrier(const VkCommandBuffer commandBuffer);
 
 static bool recordDrawCommands(VkCommandBuffer commandBuffer,
                                const VkHourglass::VulkanContext::GraphicsPipeline& graphicsPipeline,
                                const VkExtent2D& swapchainExtent,
-                               size_t currentFrame,
-                               uint32_t swapchainImageIndex);
+                               size_t descriptorSetIndex,
+                               size_t cellBufferIndex,
+                               uint32_t swapchainImageIndex,
+                               VkQueryPool timestampQueryPool);
+
+static void writeTimestamp(VkCommandBuffer commandBuffer,
+                           VkQueryPool timestampQueryPool,
+                           VkPipelineStageFlagBits stage,
+                           VkHourglass::VulkanContext::TimestampQuery query);
 
-static void submitCommands(const VkHourglass::VulkanContext& context);
-static VkResult presentFramebuffer(VkHourglass::VulkanContext& context, uint32_t swapchainImageIndex);
+static void readFrameTimestamps(const VkHourglass::VulkanContext& context,
+                                const VkHourglass::VulkanContext::Frame& frame,
+                                FrameTimestamps& frameTimestamps,
+                                VkHourglass::RuntimeStatistics& runtimeStatistics);
+
+static void submitCommands(const VkHourglass::VulkanContext& context, const VkHourglass::VulkanContext::Frame& frame);
+static void submitComputeCommands(const VkHourglass::VulkanContext& context,
+                                  const VkHourglass::VulkanContext::Frame& frame);
+static VkResult presentFramebuffer(VkHourglass::VulkanContext& context,
+                                   const VkHourglass::VulkanContext::Frame& frame,
+                                   uint32_t swapchainImageIndex);
+static std::optional<VkHourglass::MargolusEngine>
+createCrossCheckEngine(const CommandLineArguments& arguments,
+                       const std::shared_future<VkHourglass::PackedGrid>& gridFuture,
+                       const VkHourglass::Checkpoint::MappedFile* checkpoint,
+                       uint32_t seed);
+static void printStartupTimings(std::chrono::nanoseconds startupTime,
+                                std::chrono::nanoseconds gridGenerationTime,
+                                const VkHourglass::VulkanContext::StartupTimings& vulkanStartupTimings);
 
 int main(int argc, char* argv[])
 {
@@ -41,47 +176,253 @@ int main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
+    const auto argumentsOpt = parseCommandLineArguments(argc, argv);
+    if (!argumentsOpt.has_value())
+    {
+        fprintf(stderr,
+                "Usage: %s [--config <file>] [--set <key>=<value>]... [--generator <hourglass|noise|circles|center>] "
+                "[--seed <n>] [--restore <file>] [--checkpoint <file> [--checkpoint-interval <generation count>]] "
+                "[--record <file> [--record-interval <generation count>] [--record-format <delta|y4m|pgm>]] "
+                "[--headless <step count> [--cpu [--kernel <bit-sliced|avx2|scalar>]] [--report <text|json|csv>]] "
+                "[--cross-check]\n",
+                argv[0]);
+        fprintf(
+            stderr, "       %s --convert-recording <delta file> <output file> [--record-format <y4m|pgm>]\n", argv[0]);
+        VkHourglass::printConfigurationKeys();
+        return EXIT_FAILURE;
+    }
+    const CommandLineArguments& arguments = argumentsOpt.value();
+
+    if (arguments.convertRecordingPaths.has_value())
+    {
+        const auto& [inputPath, outputPath] = arguments.convertRecordingPaths.value();
+        const bool success = VkHourglass::FrameRecorder::convertDeltaStream(
+            inputPath, outputPath, arguments.recordFormat->format);
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    const VkHourglass::Configuration& configuration = arguments.configuration;
+    const bool isHeadless = arguments.headlessStepCount.has_value();
+
+    if (!VkHourglass::validateConfiguration(configuration))
+    {
+        return EXIT_INVALID_CONFIGURATION;
+    }
+
+    const auto startupStartTime = std::chrono::steady_clock::now();
+
+    // NOTE(MM): The checkpoint stays mapped until the cell buffers are uploaded, which read the cells straight from
+    // the mapping. MappedFile can't be moved, hence construct it in place.
+    std::optional<VkHourglass::Checkpoint::MappedFile> checkpointOpt = std::nullopt;
+    std::optional<VkHourglass::VulkanContext::RestoredState> restoredState = std::nullopt;
+    if (arguments.restorePath.has_value())
+    {
+        checkpointOpt.emplace(arguments.restorePath.value());
+        if (!checkpointOpt.value())
+        {
+            return EXIT_FAILURE;
+        }
+
+        const VkHourglass::Checkpoint::State& state = checkpointOpt->getState();
+        if (state.gridWidth != configuration.gridWidth || state.gridHeight != configuration.gridHeight)
+        {
+            fprintf(stderr,
+                    "Checkpoint grid size %ux%u doesn't match the configured grid size %ux%u!\n",
+                    state.gridWidth,
+                    state.gridHeight,
+                    configuration.gridWidth,
+                    configuration.gridHeight);
+            return EXIT_FAILURE;
+        }
+        restoredState = VkHourglass::VulkanContext::RestoredState{checkpointOpt->getCells(), state.generation};
+    }
+    const VkHourglass::Checkpoint::MappedFile* checkpoint =
+        checkpointOpt.has_value() ? &checkpointOpt.value() : nullptr;
+
+    // NOTE(MM): Generate the grid on a worker thread, so that it overlaps with GLFW initialization and most of the
+    // Vulkan startup. `VulkanContext` only waits for it right before uploading the cell buffers.
+    std::chrono::nanoseconds gridGenerationTime(0);
+    std::shared_future<VkHourglass::PackedGrid> gridFuture;
+    if (!checkpoint)
+    {
+        gridFuture = std::async(std::launch::async, [&arguments, &configuration, &gridGenerationTime]() {
+            const auto generationStartTime = std::chrono::steady_clock::now();
+            VkHourglass::PackedGrid grid = arguments.generator->generate(configuration);
+            gridGenerationTime = std::chrono::steady_clock::now() - generationStartTime;
+            return grid;
+        });
+    }
+
+    // NOTE(MM): The random numbers only depend on the seed, the generation and the block, so continuing with the seed
+    // of the checkpoint reproduces the original run.
+    std::random_device randomDevice;
+    const uint32_t seed = checkpoint ? checkpoint->getState().seed : arguments.seed.value_or(randomDevice());
+
+    if (arguments.useCpu)
+    {
+        const VkHourglass::PackedGrid& grid = gridFuture.get();
+        std::optional<VkHourglass::MargolusEngine> margolusEngine =
+            createCrossCheckEngine(arguments, gridFuture, nullptr, seed);
+        const bool success = runHeadlessCpu(grid, margolusEngine, seed, arguments);
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     const std::filesystem::path executableDirectory = std::filesystem::absolute(argv[0]).parent_path();
     VkHourglass::ApplicationSharedData applicationSharedData{executableDirectory, false, false};
 
-    VkHourglass::GlfwContext glfwContext(applicationSharedData,
-                                         VkHourglass::ApplicationDefines::WINDOW_WIDTH,
-                                         VkHourglass::ApplicationDefines::WINDOW_HEIGHT);
-    if (!glfwContext)
+    // NOTE(MM): GlfwContext can't be moved, hence construct it in place.
+    std::optional<VkHourglass::GlfwContext> glfwContextOpt = std::nullopt;
+    if (!isHeadless)
     {
-        fprintf(stderr, "Failed to initialize GLFW!\n");
-        return EXIT_FAILURE;
+        glfwContextOpt.emplace(applicationSharedData,
+                               VkHourglass::ApplicationDefines::WINDOW_WIDTH,
+                               VkHourglass::ApplicationDefines::WINDOW_HEIGHT);
+        if (!glfwContextOpt.value())
+        {
+            fprintf(stderr, "Failed to initialize GLFW!\n");
+            return EXIT_FAILURE;
+        }
     }
+    VkHourglass::GlfwContext* glfwContext = glfwContextOpt.has_value() ? &glfwContextOpt.value() : nullptr;
 
-    const std::vector<uint32_t> grid = VkHourglass::generateHourglass();
-    VkHourglass::VulkanContext vulkanContext(applicationSharedData, glfwContext, grid);
+    VkHourglass::VulkanContext vulkanContext(
+        applicationSharedData, glfwContext, configuration, gridFuture, restoredState);
     if (!vulkanContext)
     {
         fprintf(stderr, "Failed to initialize Vulkan!\n");
         return EXIT_FAILURE;
     }
 
-    std::random_device randomDevice;
-    std::mt19937 mtRand(randomDevice());
-    size_t currentGridBuffer = 0;
+    if (arguments.checkpointPath.has_value() && !vulkanContext.createCheckpointBuffer())
+    {
+        fprintf(stderr, "Failed to create checkpoint buffer!\n");
+        return EXIT_FAILURE;
+    }
+
+    // NOTE(MM): Declared after `vulkanContext`, so that the writer thread is finished before the recording buffers it
+    // reads are destroyed. FrameRecorder can't be moved, hence construct it in place.
+    std::optional<VkHourglass::FrameRecorder> recorderOpt = std::nullopt;
+    if (arguments.recordPath.has_value())
+    {
+        if (!vulkanContext.createRecordingBuffers(VkHourglass::ApplicationDefines::RECORDING_BUFFER_COUNT))
+        {
+            fprintf(stderr, "Failed to create recording buffers!\n");
+            return EXIT_FAILURE;
+        }
+
+        std::vector<const uint32_t*> slots;
+        for (const auto& memory : vulkanContext.recordingBuffersMemory)
+        {
+            slots.push_back(static_cast<const uint32_t*>(memory.mappedData));
+        }
+        recorderOpt.emplace(arguments.recordPath.value(),
+                            arguments.recordFormat->format,
+                            VkHourglass::CellBufferLayout(configuration),
+                            slots);
+        if (!recorderOpt.value())
+        {
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::optional<VkHourglass::MargolusEngine> margolusEngine =
+        createCrossCheckEngine(arguments, gridFuture, checkpoint, seed);
+
+    if (arguments.reportFormat == VkHourglass::BenchmarkReport::Format::Text)
+    {
+        printStartupTimings(
+            std::chrono::steady_clock::now() - startupStartTime, gridGenerationTime, vulkanContext.startupTimings);
+        vulkanContext.memoryArena->printStatistics();
+        if (checkpoint)
+        {
+            printf("Restored generation %u from '%s'\n",
+                   checkpoint->getState().generation,
+                   arguments.restorePath.value().c_str());
+        }
+    }
+
+    size_t currentGridBuffer = checkpoint ? checkpoint->getState().currentGridBuffer : 0;
+    uint32_t generation = checkpoint ? checkpoint->getState().generation : 0;
+    size_t computeStepCount = 0;
+
+    // NOTE(MM): The cells have been uploaded, the mapping isn't needed anymore.
+    checkpoint = nullptr;
+    checkpointOpt.reset();
+
+    VkHourglass::CheckpointWriter checkpointWriter(arguments.checkpointPath, arguments.checkpointInterval, generation);
+    VkHourglass::FrameRecording recording(recorderOpt.has_value() ? &recorderOpt.value() : nullptr,
+                                          arguments.recordInterval,
+                                          generation,
+                                          vulkanContext.frames.size());
+
+    if (isHeadless)
+    {
+        bool success = runHeadless(vulkanContext,
+                                   margolusEngine,
+                                   seed,
+                                   arguments,
+                                   currentGridBuffer,
+                                   generation,
+                                   checkpointWriter,
+                                   recording);
+        vkDeviceWaitIdle(vulkanContext.deviceWrapper.device);
+        recording.finish(arguments.reportFormat == VkHourglass::BenchmarkReport::Format::Text);
+
+        success = success && checkpointWriter.writeFinal(vulkanContext, currentGridBuffer, generation, seed);
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // NOTE(MM): With async compute, `currentGridBuffer`, `generation`, the checkpoints, the recording and the cross
+    // check belong to the compute thread until it is joined after the loop.
+    const uint32_t startGeneration = generation;
+    const auto asyncComputeStart = std::chrono::steady_clock::now();
+    std::optional<VkHourglass::AsyncComputeThread> asyncComputeThread = std::nullopt;
+    if (vulkanContext.isUsingAsyncCompute())
+    {
+        asyncComputeThread.emplace(vulkanContext,
+                                   seed,
+                                   currentGridBuffer,
+                                   generation,
+                                   checkpointWriter,
+                                   recording,
+                                   margolusEngine.has_value() ? &margolusEngine.value() : nullptr,
+                                   applicationSharedData.exitApplication);
+    }
+    const bool useAsyncCompute = asyncComputeThread.has_value();
 
     VkHourglass::RuntimeStatistics runtimeStatistics;
     VkHourglass::ComputeUpdateTimer computeUpdateTimer(VkHourglass::ApplicationDefines::CELL_UPDATE_INTERVAL_MS);
+    size_t currentFrame = 0;
+    std::vector<FrameTimestamps> frameTimestamps(vulkanContext.frames.size(), FrameTimestamps{false, false});
 
     while (!applicationSharedData.exitApplication.load())
     {
         runtimeStatistics.notifyFrameBegin();
-        glfwContext.update();
+        glfwContext->update();
+
+        // NOTE(MM): Only wait for the frame which used these resources the last time, i.e. up to
+        // 'MAX_FRAMES_IN_FLIGHT - 1' other frames may still be processed by the GPU while recording.
+        const VkHourglass::VulkanContext::Frame& frame = vulkanContext.frames[currentFrame];
+        const auto fenceWaitStart = std::chrono::steady_clock::now();
+        vkWaitForFences(vulkanContext.deviceWrapper.device, 1, &frame.inFlightFence, VK_TRUE, UINT64_MAX);
+        const auto acquireStart = std::chrono::steady_clock::now();
+        runtimeStatistics.addStageTime(VkHourglass::RuntimeStatistics::Stage::FenceWait, acquireStart - fenceWaitStart);
 
-        vkWaitForFences(vulkanContext.deviceWrapper.device, 1, &vulkanContext.inFlightFence, VK_TRUE, UINT64_MAX);
+        readFrameTimestamps(vulkanContext, frame, frameTimestamps[currentFrame], runtimeStatistics);
+        if (!useAsyncCompute)
+        {
+            checkpointWriter.writePending(vulkanContext, currentFrame);
+            recording.submitPending(currentFrame);
+        }
 
         uint32_t imageIndex = 0;
         VkResult result = vkAcquireNextImageKHR(vulkanContext.deviceWrapper.device,
                                                 vulkanContext.swapchain.swapchain,
                                                 UINT64_MAX,
-                                                vulkanContext.imageAvailableSemaphore,
+                                                frame.imageAvailableSemaphore,
                                                 VK_NULL_HANDLE,
                                                 &imageIndex);
+        runtimeStatistics.addStageTime(VkHourglass::RuntimeStatistics::Stage::Acquire,
+                                       std::chrono::steady_clock::now() - acquireStart);
 
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR
             || applicationSharedData.framebufferResized)
@@ -91,104 +432,587 @@ int main(int argc, char* argv[])
             continue;
         }
 
-        vkResetFences(vulkanContext.deviceWrapper.device, 1, &vulkanContext.inFlightFence);
+        // NOTE(MM): Once a publication is acquired, the frame has to be submitted, since the compute thread may wait
+        // for its frame number.
+        std::optional<VkHourglass::AsyncComputeThread::Publication> publication = std::nullopt;
+        if (useAsyncCompute)
+        {
+            publication = asyncComputeThread->acquirePublication();
+            if (!publication.has_value())
+            {
+                applicationSharedData.exitApplication.store(true);
+                continue;
+            }
+        }
 
-        const VkCommandBuffer commandBuffer = vulkanContext.commandBuffer;
+        vkResetFences(vulkanContext.deviceWrapper.device, 1, &frame.inFlightFence);
+
+        const VkCommandBuffer commandBuffer = frame.commandBuffer;
         vkResetCommandBuffer(commandBuffer, 0);
-        beginCommandBuffer(commandBuffer);
+        VkHourglass::GpuCommands::beginCommandBuffer(commandBuffer);
+
+        if (frame.timestampQueryPool != VK_NULL_HANDLE)
+        {
+            vkCmdResetQueryPool(
+                commandBuffer, frame.timestampQueryPool, 0, VkHourglass::VulkanContext::TIMESTAMP_QUERY_COUNT);
+        }
+        writeTimestamp(commandBuffer,
+                       frame.timestampQueryPool,
+                       VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VkHourglass::VulkanContext::TIMESTAMP_FRAME_BEGIN);
 
-        if (computeUpdateTimer.isUpdateNeeded())
+        computeStepCount = 0;
+        if (!useAsyncCompute && computeUpdateTimer.isUpdateNeeded())
         {
-            recordComputeCommands(vulkanContext.computePipeline, commandBuffer, currentGridBuffer, mtRand);
-            addMemoryBarrier(
-                commandBuffer, vulkanContext.deviceWrapper.queueIndex, currentGridBuffer, vulkanContext.cellBuffers);
+            addPreviousFrameBarrier(commandBuffer);
+            computeStepCount = VkHourglass::ApplicationDefines::COMPUTE_STEPS_PER_FRAME * configuration.temporalSteps;
+            currentGridBuffer = VkHourglass::GpuCommands::recordComputeCommands(vulkanContext,
+                                                                                commandBuffer,
+                                                                                currentGridBuffer,
+                                                                                generation,
+                                                                                seed,
+                                                                                computeStepCount,
+                                                                                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+            checkpointWriter.recordCopy(
+                vulkanContext, commandBuffer, currentFrame, currentGridBuffer, generation, seed);
+            recording.recordCopy(vulkanContext, commandBuffer, currentFrame, currentGridBuffer, generation);
 
-            currentGridBuffer = !currentGridBuffer;
             computeUpdateTimer.notifyUpdateScheduled();
         }
+        writeTimestamp(commandBuffer,
+                       frame.timestampQueryPool,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                       VkHourglass::VulkanContext::TIMESTAMP_COMPUTE_END);
 
-        recordDrawCommands(commandBuffer,
-                           vulkanContext.graphicsPipeline,
-                           vulkanContext.swapchain.imageExtent,
-                           currentGridBuffer,
-                           imageIndex);
+        // NOTE(MM): Without async compute, the descriptor sets refer to the cell buffers.
+        if (publication.has_value())
+        {
+            recordDrawCommands(commandBuffer,
+                               vulkanContext.graphicsPipeline,
+                               vulkanContext.swapchain.imageExtent,
+                               publication->displayBuffer,
+                               publication->cellBufferIndex,
+                               imageIndex,
+                               frame.timestampQueryPool);
+            asyncComputeThread->submitDrawCommands(frame, publication.value());
+        }
+        else
+        {
+            recordDrawCommands(commandBuffer,
+                               vulkanContext.graphicsPipeline,
+                               vulkanContext.swapchain.imageExtent,
+                               currentGridBuffer,
+                               currentGridBuffer,
+                               imageIndex,
+                               frame.timestampQueryPool);
+            submitCommands(vulkanContext, frame);
+        }
+        frameTimestamps[currentFrame] = {frame.timestampQueryPool != VK_NULL_HANDLE, computeStepCount > 0};
 
-        submitCommands(vulkanContext);
+        if (margolusEngine.has_value() && computeStepCount > 0
+            && !VkHourglass::CrossCheck::compareWithCpu(
+                vulkanContext, margolusEngine.value(), currentGridBuffer, computeStepCount))
+        {
+            applicationSharedData.exitApplication.store(true);
+        }
 
-        result = presentFramebuffer(vulkanContext, imageIndex);
+        const auto presentStart = std::chrono::steady_clock::now();
+        result = presentFramebuffer(vulkanContext, frame, imageIndex);
+        runtimeStatistics.addStageTime(VkHourglass::RuntimeStatistics::Stage::Present,
+                                       std::chrono::steady_clock::now() - presentStart);
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
         {
             vulkanContext.recreateSwapchain();
         }
+
+        currentFrame = (currentFrame + 1) % vulkanContext.frames.size();
     }
     runtimeStatistics.printResults();
 
+    bool success = true;
+    if (useAsyncCompute)
+    {
+        success = asyncComputeThread->join();
+
+        const std::chrono::duration<double> asyncComputeTime = std::chrono::steady_clock::now() - asyncComputeStart;
+        const uint32_t computedGenerations = generation - startGeneration;
+        printf("Async compute: %u generations / %.1f per second\n",
+               computedGenerations,
+               computedGenerations / asyncComputeTime.count());
+    }
+
     vkDeviceWaitIdle(vulkanContext.deviceWrapper.device);
+    recording.finish(true);
 
-    return EXIT_SUCCESS;
+    success = success && checkpointWriter.writeFinal(vulkanContext, currentGridBuffer, generation, seed);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
-static bool beginCommandBuffer(const VkCommandBuffer commandBuffer)
+static std::optional<CommandLineArguments> parseCommandLineArguments(int argc, char* argv[])
 {
-    VkCommandBufferBeginInfo commandBufferBeginInfo;
-    commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    VK_RETURN_ON_ERROR_V(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo), false);
+    CommandLineArguments arguments{};
+    arguments.cpuKernel = &CPU_KERNELS[0];
+    arguments.generator = &GRID_GENERATORS[0];
+    arguments.reportFormat = VkHourglass::BenchmarkReport::Format::Text;
+    arguments.configuration = VkHourglass::getDefaultConfiguration();
+    bool hasKernel = false;
+    bool hasReportFormat = false;
+    arguments.recordInterval = 1;
+    arguments.recordFormat = &RECORDING_FORMATS[0];
+    bool hasRecordInterval = false;
+    bool hasRecordFormat = false;
+    arguments.crossCheck = VkHourglass::ApplicationDefines::ENABLE_CPU_CROSS_CHECK;
 
-    return true;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--headless") == 0 && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const unsigned long long stepCount = strtoull(argv[++i], &end, 10);
+            if (*end != '\0' || stepCount == 0)
+            {
+                fprintf(stderr, "Invalid step count '%s'!\n", argv[i]);
+                return std::nullopt;
+            }
+            arguments.headlessStepCount = static_cast<uint64_t>(stepCount);
+        }
+        else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc)
+        {
+            if (!VkHourglass::loadConfigurationFile(arguments.configuration, argv[++i]))
+            {
+                return std::nullopt;
+            }
+        }
+        else if (strcmp(argv[i], "--set") == 0 && i + 1 < argc)
+        {
+            const std::string_view setting = argv[++i];
+            const size_t separator = setting.find('=');
+            if (separator == std::string_view::npos
+                || !VkHourglass::setConfigurationValue(
+                    arguments.configuration, setting.substr(0, separator), setting.substr(separator + 1)))
+            {
+                fprintf(stderr, "Invalid setting '%s', expected '<key>=<value>'!\n", argv[i]);
+                return std::nullopt;
+            }
+        }
+        else if (strcmp(argv[i], "--restore") == 0 && i + 1 < argc)
+        {
+            arguments.restorePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc)
+        {
+            arguments.checkpointPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--checkpoint-interval") == 0 && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const unsigned long interval = strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || interval == 0 || interval > UINT32_MAX)
+            {
+                fprintf(stderr, "Invalid checkpoint interval '%s'!\n", argv[i]);
+                return std::nullopt;
+            }
+            arguments.checkpointInterval = static_cast<uint32_t>(interval);
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            arguments.recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--record-interval") == 0 && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const unsigned long interval = strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || interval == 0 || interval > UINT32_MAX)
+            {
+                fprintf(stderr, "Invalid record interval '%s'!\n", argv[i]);
+                return std::nullopt;
+            }
+            arguments.recordInterval = static_cast<uint32_t>(interval);
+            hasRecordInterval = true;
+        }
+        else if (strcmp(argv[i], "--record-format") == 0 && i + 1 < argc)
+        {
+            const char* name = argv[++i];
+            const auto format =
+                std::find_if(RECORDING_FORMATS.begin(), RECORDING_FORMATS.end(), [name](const RecordingFormat& f) {
+                    return strcmp(f.name, name) == 0;
+                });
+            if (format == RECORDING_FORMATS.end())
+            {
+                fprintf(stderr, "Unknown recording format '%s'!\n", name);
+                return std::nullopt;
+            }
+            arguments.recordFormat = &*format;
+            hasRecordFormat = true;
+        }
+        else if (strcmp(argv[i], "--convert-recording") == 0 && i + 2 < argc)
+        {
+            arguments.convertRecordingPaths = std::make_pair(argv[i + 1], argv[i + 2]);
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const unsigned long seed = strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || seed > UINT32_MAX)
+            {
+                fprintf(stderr, "Invalid seed '%s'!\n", argv[i]);
+                return std::nullopt;
+            }
+            arguments.seed = static_cast<uint32_t>(seed);
+        }
+        else if (strcmp(argv[i], "--cpu") == 0)
+        {
+            arguments.useCpu = true;
+        }
+        else if (strcmp(argv[i], "--cross-check") == 0)
+        {
+            arguments.crossCheck = true;
+        }
+        else if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc)
+        {
+            const char* name = argv[++i];
+            const auto kernel = std::find_if(CPU_KERNELS.begin(), CPU_KERNELS.end(), [name](const CpuKernel& k) {
+                return strcmp(k.name, name) == 0;
+            });
+            if (kernel == CPU_KERNELS.end())
+            {
+                fprintf(stderr, "Unknown CPU kernel '%s'!\n", name);
+                return std::nullopt;
+            }
+            arguments.cpuKernel = &*kernel;
+            hasKernel = true;
+        }
+        else if (strcmp(argv[i], "--generator") == 0 && i + 1 < argc)
+        {
+            const char* name = argv[++i];
+            const auto generator =
+                std::find_if(GRID_GENERATORS.begin(), GRID_GENERATORS.end(), [name](const GridGenerator& g) {
+                    return strcmp(g.name, name) == 0;
+                });
+            if (generator == GRID_GENERATORS.end())
+            {
+                fprintf(stderr, "Unknown generator '%s'!\n", name);
+                return std::nullopt;
+            }
+            arguments.generator = &*generator;
+        }
+        else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc)
+        {
+            const char* format = argv[++i];
+            if (strcmp(format, "text") == 0)
+            {
+                arguments.reportFormat = VkHourglass::BenchmarkReport::Format::Text;
+            }
+            else if (strcmp(format, "json") == 0)
+            {
+                arguments.reportFormat = VkHourglass::BenchmarkReport::Format::Json;
+            }
+            else if (strcmp(format, "csv") == 0)
+            {
+                arguments.reportFormat = VkHourglass::BenchmarkReport::Format::Csv;
+            }
+            else
+            {
+                fprintf(stderr, "Unknown report format '%s'!\n", format);
+                return std::nullopt;
+            }
+            hasReportFormat = true;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown argument '%s'!\n", argv[i]);
+            return std::nullopt;
+        }
+    }
+
+    if (arguments.useCpu && !arguments.headlessStepCount.has_value())
+    {
+        fprintf(stderr, "'--cpu' is only supported in headless mode!\n");
+        return std::nullopt;
+    }
+
+    if (arguments.checkpointInterval != 0 && !arguments.checkpointPath.has_value())
+    {
+        fprintf(stderr, "'--checkpoint-interval' is only supported with '--checkpoint'!\n");
+        return std::nullopt;
+    }
+
+    // NOTE(MM): Checkpoints hold the GPU cell buffers, the CPU engines don't support them (yet).
+    if (arguments.useCpu && (arguments.restorePath.has_value() || arguments.checkpointPath.has_value()))
+    {
+        fprintf(stderr, "'--restore' and '--checkpoint' aren't supported with '--cpu'!\n");
+        return std::nullopt;
+    }
+
+    if ((hasRecordInterval || hasRecordFormat) && !arguments.recordPath.has_value()
+        && !arguments.convertRecordingPaths.has_value())
+    {
+        fprintf(stderr, "'--record-interval' and '--record-format' are only supported with '--record'!\n");
+        return std::nullopt;
+    }
+
+    // NOTE(MM): Recording reads back the GPU cell buffers, the CPU engines don't support it (yet).
+    if (arguments.useCpu && arguments.recordPath.has_value())
+    {
+        fprintf(stderr, "'--record' isn't supported with '--cpu'!\n");
+        return std::nullopt;
+    }
+
+    // NOTE(MM): Delta recordings are converted to Y4M unless another format is given.
+    if (arguments.convertRecordingPaths.has_value())
+    {
+        if (!hasRecordFormat)
+        {
+            arguments.recordFormat = &RECORDING_FORMATS[1];
+        }
+        if (hasRecordInterval || arguments.recordFormat->format == VkHourglass::FrameRecorder::Format::Delta)
+        {
+            fprintf(stderr, "'--convert-recording' expects '--record-format <y4m|pgm>' only!\n");
+            return std::nullopt;
+        }
+    }
+
+    // NOTE(MM): Restored runs have to continue with the random numbers of the original run.
+    if (arguments.seed.has_value() && arguments.restorePath.has_value())
+    {
+        fprintf(stderr, "'--seed' isn't supported with '--restore', the seed of the checkpoint is used!\n");
+        return std::nullopt;
+    }
+
+    if (hasKernel && !arguments.useCpu)
+    {
+        fprintf(stderr, "'--kernel' is only supported with '--cpu'!\n");
+        return std::nullopt;
+    }
+
+    if (hasReportFormat && !arguments.headlessStepCount.has_value())
+    {
+        fprintf(stderr, "'--report' is only supported in headless mode!\n");
+        return std::nullopt;
+    }
+
+    return arguments;
 }
 
-static void recordComputeCommands(const VkHourglass::VulkanContext::ComputePipeline& computePipeline,
-                                  const VkCommandBuffer commandBuffer,
-                                  size_t currentBuffer,
-                                  std::mt19937& mtRand)
+static bool runHeadless(VkHourglass::VulkanContext& context,
+                        std::optional<VkHourglass::MargolusEngine>& margolusEngine,
+                        uint32_t seed,
+                        const CommandLineArguments& arguments,
+                        size_t& currentGridBuffer,
+                        uint32_t& generation,
+                        VkHourglass::CheckpointWriter& checkpointWriter,
+                        VkHourglass::FrameRecording& recording)
 {
-    const VkPipelineLayout pipelineLayout = computePipeline.pipelineLayout;
+    const VkDevice device = context.deviceWrapper.device;
+    const VkHourglass::Configuration& configuration = context.configuration;
+    const uint64_t stepCount = arguments.headlessStepCount.value();
+    const uint32_t temporalSteps = configuration.temporalSteps;
+    if (stepCount % temporalSteps != 0)
+    {
+        fprintf(stderr, "Headless step count has to be a multiple of the temporal steps (%u)!\n", temporalSteps);
+        return false;
+    }
+    size_t currentFrame = 0;
+    size_t batchSize = 0;
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline.pipeline);
-    vkCmdBindDescriptorSets(commandBuffer,
-                            VK_PIPELINE_BIND_POINT_COMPUTE,
-                            pipelineLayout,
-                            0,
-                            1,
-                            &computePipeline.descriptorSets[currentBuffer],
-                            0,
-                            0);
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(context.deviceWrapper.physicalDevice, &deviceProperties);
+    const char* engine = temporalSteps > 1 ? "gpu-temporal"
+                         : configuration.useSharedMemoryTiles ? "gpu-shared"
+                                                              : "gpu";
+    VkHourglass::BenchmarkReport report({engine,
+                                         deviceProperties.deviceName,
+                                         arguments.generator->name,
+                                         configuration.gridWidth,
+                                         configuration.gridHeight,
+                                         configuration.computeLocalGroupSizeX,
+                                         configuration.tileWidthWords,
+                                         1,
+                                         temporalSteps});
+
+    const auto start = std::chrono::steady_clock::now();
+    auto sampleStart = start;
+
+    for (uint64_t step = 0; step < stepCount; step += batchSize)
+    {
+        const VkHourglass::VulkanContext::Frame& frame = context.frames[currentFrame];
+        vkWaitForFences(device, 1, &frame.inFlightFence, VK_TRUE, UINT64_MAX);
+        vkResetFences(device, 1, &frame.inFlightFence);
+        checkpointWriter.writePending(context, currentFrame);
+        recording.submitPending(currentFrame);
+
+        // NOTE(MM): Once the frames in flight are filled, recording waits for the GPU, so the time between two
+        // submissions is the GPU time of a submission.
+        const auto now = std::chrono::steady_clock::now();
+        if (step > 0)
+        {
+            report.addSample(batchSize, now - sampleStart);
+        }
+        sampleStart = now;
+
+        const VkCommandBuffer commandBuffer = frame.commandBuffer;
+        vkResetCommandBuffer(commandBuffer, 0);
+        VkHourglass::GpuCommands::beginCommandBuffer(commandBuffer);
+
+        const uint64_t remainingSteps = stepCount - step;
+        batchSize = static_cast<size_t>(
+            std::min<uint64_t>(remainingSteps, VkHourglass::ApplicationDefines::HEADLESS_STEPS_PER_SUBMIT));
+        // NOTE(MM): Only the last generation of a submission can be recorded, hence end it at the next recorded one.
+        if (recording.isRecording())
+        {
+            batchSize = std::min<size_t>(batchSize, recording.getGenerationsUntilNext(generation));
+        }
+        // NOTE(MM): Whole dispatches only, intervals which aren't a multiple of the temporal steps end at the next one.
+        batchSize = std::max<size_t>(batchSize / temporalSteps * temporalSteps, temporalSteps);
+
+        // NOTE(MM): The last written buffer is read by the compute shader of the next submission.
+        currentGridBuffer = VkHourglass::GpuCommands::recordComputeCommands(context,
+                                                                            commandBuffer,
+                                                                            currentGridBuffer,
+                                                                            generation,
+                                                                            seed,
+                                                                            batchSize,
+                                                                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        checkpointWriter.recordCopy(context, commandBuffer, currentFrame, currentGridBuffer, generation, seed);
+        recording.recordCopy(context, commandBuffer, currentFrame, currentGridBuffer, generation);
+        VK_RETURN_ON_ERROR_V(vkEndCommandBuffer(commandBuffer), false);
 
-    const VkHourglass::PushConstants pushConstants{static_cast<uint32_t>(currentBuffer),
-                                                   static_cast<int32_t>(mtRand())};
-    vkCmdPushConstants(
-        commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+        submitComputeCommands(context, frame);
 
-    vkCmdDispatch(commandBuffer, VkHourglass::ApplicationDefines::NonModifiable::X_DISPATCH_COUNT, 1, 1);
+        if (margolusEngine.has_value()
+            && !VkHourglass::CrossCheck::compareWithCpu(context, margolusEngine.value(), currentGridBuffer, batchSize))
+        {
+            return false;
+        }
+
+        currentFrame = (currentFrame + 1) % context.frames.size();
+    }
+
+    VK_RETURN_ON_ERROR_V(vkQueueWaitIdle(context.deviceWrapper.queue), false);
+
+    const auto end = std::chrono::steady_clock::now();
+    report.addSample(batchSize, end - sampleStart);
+    report.setTotal(stepCount, end - start);
+    printReport(report, arguments.reportFormat);
+
+    return true;
 }
 
-static void addMemoryBarrier(const VkCommandBuffer commandBuffer,
-                             uint32_t queueIndex,
-                             size_t currentBuffer,
-                             const std::vector<VkBuffer>& cellBuffers)
+static bool runHeadlessCpu(const VkHourglass::PackedGrid& grid,
+                           std::optional<VkHourglass::MargolusEngine>& margolusEngine,
+                           uint32_t seed,
+                           const CommandLineArguments& arguments)
 {
-    VkBufferMemoryBarrier bufferMemoryBarrier{};
-    bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-    bufferMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
-    bufferMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-    bufferMemoryBarrier.srcQueueFamilyIndex = queueIndex;
-    bufferMemoryBarrier.dstQueueFamilyIndex = queueIndex;
+    const uint64_t stepCount = arguments.headlessStepCount.value();
+    const bool isTextReport = arguments.reportFormat == VkHourglass::BenchmarkReport::Format::Text;
+
+    VkHourglass::SimdMargolusEngine engine(arguments.configuration.enableHorizontalWrapping,
+                                           arguments.configuration.stuckProbability,
+                                           grid,
+                                           seed,
+                                           VkHourglass::ApplicationDefines::CPU_THREAD_COUNT,
+                                           arguments.cpuKernel->kernel,
+                                           arguments.configuration.cpuTemporalSteps,
+                                           arguments.configuration.cpuNumaBands);
+    const uint32_t temporalSteps = engine.getTemporalSteps();
+    if (isTextReport)
+    {
+        printf("CPU stepping with %zu threads (%s kernel, %u generations per pass)\n",
+               engine.getThreadCount(),
+               engine.getKernelName(),
+               temporalSteps);
+        if (engine.isUsingNumaBands())
+        {
+            printf("Threads pinned to %zu NUMA nodes, each owning a band of the grid\n", engine.getNumaNodeCount());
+        }
+    }
+
+    // NOTE(MM): The local group size and tile width don't apply to the CPU, hence they are reported as 0.
+    std::string engineName = temporalSteps > 1 ? "cpu-temporal" : "cpu";
+    if (engine.isUsingNumaBands())
+    {
+        engineName += "-numa";
+    }
+    VkHourglass::BenchmarkReport report({engineName,
+                                         engine.getKernelName(),
+                                         arguments.generator->name,
+                                         grid.getWidth(),
+                                         grid.getHeight(),
+                                         0,
+                                         0,
+                                         engine.getThreadCount(),
+                                         temporalSteps});
 
-    const size_t writtenBuffer = !currentBuffer;
-    bufferMemoryBarrier.buffer = cellBuffers[writtenBuffer];
-    bufferMemoryBarrier.offset = 0;
+    const auto start = std::chrono::steady_clock::now();
+    size_t batchSize = 0;
 
-    static constexpr uint32_t bufferSize = VkHourglass::ApplicationDefines::NonModifiable::GRID_SIZE * sizeof(uint32_t);
-    bufferMemoryBarrier.size = bufferSize;
+    // NOTE(MM): With temporal blocking, only every `temporalSteps`th generation can be cross checked.
+    for (uint64_t step = 0; step < stepCount; step += batchSize)
+    {
+        batchSize = static_cast<size_t>(std::min<uint64_t>(stepCount - step, temporalSteps));
+        const auto stepStart = std::chrono::steady_clock::now();
+        engine.step(batchSize);
+        report.addSample(batchSize, std::chrono::steady_clock::now() - stepStart);
+
+        if (margolusEngine.has_value())
+        {
+            for (size_t i = 0; i < batchSize; ++i)
+            {
+                margolusEngine->step();
+            }
+            if (margolusEngine->getCells() != engine.getCells())
+            {
+                fprintf(stderr,
+                        "CPU cross check failed at generation %llu!\n",
+                        static_cast<unsigned long long>(step + batchSize - 1));
+                return false;
+            }
+        }
+    }
+
+    report.setTotal(stepCount, std::chrono::steady_clock::now() - start);
+    report.setGridMemoryTraffic(engine.getGridMemoryTraffic());
+    printReport(report, arguments.reportFormat);
+    if (isTextReport)
+    {
+        printf("Active tiles: %zu / %zu\n", engine.getActiveTileCount(), engine.getTileCount());
+    }
+
+    return true;
+}
+
+static void printReport(const VkHourglass::BenchmarkReport& report, VkHourglass::BenchmarkReport::Format format)
+{
+    // NOTE(MM): The CSV header is printed with every row, callers merging several runs have to strip it.
+    if (format == VkHourglass::BenchmarkReport::Format::Csv)
+    {
+        VkHourglass::BenchmarkReport::printCsvHeader();
+    }
+    report.print(format);
+}
+
+// NOTE(MM): With multiple frames in flight, the previous frame may still draw from the buffer the first dispatch of
+// this frame overwrites (or compute into the one it reads), or copy it to a checkpoint or recording buffer. When
+// stepping in place, that is always the buffer the first dispatch writes. Since all frames are submitted to the same
+// queue, a barrier at the beginning of the compute commands is sufficient to order them after all previously submitted
+// work.
+static void addPreviousFrameBarrier(const VkCommandBuffer commandBuffer)
+{
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
 
     vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                             | VK_PIPELINE_STAGE_TRANSFER_BIT,
                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                         VK_DEPENDENCY_DEVICE_GROUP_BIT,
                          0,
-                         nullptr,
                          1,
-                         &bufferMemoryBarrier,
+                         &memoryBarrier,
+                         0,
+                         nullptr,
                          0,
                          nullptr);
 }
@@ -196,8 +1020,10 @@ static void addMemoryBarrier(const VkCommandBuffer commandBuffer,
 static bool recordDrawCommands(VkCommandBuffer commandBuffer,
                                const VkHourglass::VulkanContext::GraphicsPipeline& graphicsPipeline,
                                const VkExtent2D& swapchainExtent,
-                               size_t currentFrame,
-                               uint32_t swapchainImageIndex)
+                               size_t descriptorSetIndex,
+                               size_t cellBufferIndex,
+                               uint32_t swapchainImageIndex,
+                               VkQueryPool timestampQueryPool)
 {
 
     VkRenderPassBeginInfo renderPassBeginInfo;
@@ -220,10 +1046,18 @@ static bool recordDrawCommands(VkCommandBuffer commandBuffer,
                             graphicsPipeline.pipelineLayout,
                             0,
                             1,
-                            &graphicsPipeline.descriptorSets[currentFrame],
+                            &graphicsPipeline.descriptorSets[descriptorSetIndex],
                             0,
                             0);
 
+    const VkHourglass::FragmentPushConstants pushConstants{static_cast<uint32_t>(cellBufferIndex)};
+    vkCmdPushConstants(commandBuffer,
+                       graphicsPipeline.pipelineLayout,
+                       VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0,
+                       sizeof(pushConstants),
+                       &pushConstants);
+
     VkViewport viewport{};
     viewport.x = 0.0f;
     viewport.y = 0.0f;
@@ -241,38 +1075,117 @@ static bool recordDrawCommands(VkCommandBuffer commandBuffer,
     vkCmdDraw(commandBuffer, 3, 1, 0, 0);
     vkCmdEndRenderPass(commandBuffer);
 
+    writeTimestamp(commandBuffer,
+                   timestampQueryPool,
+                   VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                   VkHourglass::VulkanContext::TIMESTAMP_DRAW_END);
+
     VK_RETURN_ON_ERROR_V(vkEndCommandBuffer(commandBuffer), false);
 
     return true;
 }
 
-static void submitCommands(const VkHourglass::VulkanContext& context)
+static void writeTimestamp(VkCommandBuffer commandBuffer,
+                           VkQueryPool timestampQueryPool,
+                           VkPipelineStageFlagBits stage,
+                           VkHourglass::VulkanContext::TimestampQuery query)
+{
+    if (timestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdWriteTimestamp(commandBuffer, stage, timestampQueryPool, query);
+    }
+}
+
+// NOTE(MM): Called after waiting for the fence of `frame`, i.e. 'MAX_FRAMES_IN_FLIGHT' frames after the timestamps
+// were written. Hence, the results are available and reading them doesn't stall (no 'VK_QUERY_RESULT_WAIT_BIT').
+static void readFrameTimestamps(const VkHourglass::VulkanContext& context,
+                                const VkHourglass::VulkanContext::Frame& frame,
+                                FrameTimestamps& frameTimestamps,
+                                VkHourglass::RuntimeStatistics& runtimeStatistics)
+{
+    if (!frameTimestamps.isPending)
+    {
+        return;
+    }
+    frameTimestamps.isPending = false;
+
+    std::array<uint64_t, VkHourglass::VulkanContext::TIMESTAMP_QUERY_COUNT> timestamps{};
+    const VkResult result = vkGetQueryPoolResults(context.deviceWrapper.device,
+                                                  frame.timestampQueryPool,
+                                                  0,
+                                                  VkHourglass::VulkanContext::TIMESTAMP_QUERY_COUNT,
+                                                  sizeof(timestamps),
+                                                  timestamps.data(),
+                                                  sizeof(uint64_t),
+                                                  VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+    {
+        return;
+    }
+
+    const uint32_t validBits = context.deviceWrapper.timestampValidBits;
+    const uint64_t validMask = validBits >= 64 ? ~uint64_t(0) : (uint64_t(1) << validBits) - 1;
+    const auto toNanoseconds = [&](VkHourglass::VulkanContext::TimestampQuery begin,
+                                   VkHourglass::VulkanContext::TimestampQuery end) {
+        const uint64_t ticks = (timestamps[end] - timestamps[begin]) & validMask;
+        return std::chrono::nanoseconds(
+            static_cast<int64_t>(static_cast<double>(ticks) * context.deviceWrapper.timestampPeriod));
+    };
+
+    if (frameTimestamps.hasCompute)
+    {
+        runtimeStatistics.addStageTime(VkHourglass::RuntimeStatistics::Stage::GpuCompute,
+                                       toNanoseconds(VkHourglass::VulkanContext::TIMESTAMP_FRAME_BEGIN,
+                                                     VkHourglass::VulkanContext::TIMESTAMP_COMPUTE_END));
+    }
+    runtimeStatistics.addStageTime(VkHourglass::RuntimeStatistics::Stage::GpuDraw,
+                                   toNanoseconds(VkHourglass::VulkanContext::TIMESTAMP_COMPUTE_END,
+                                                 VkHourglass::VulkanContext::TIMESTAMP_DRAW_END));
+}
+
+static void submitCommands(const VkHourglass::VulkanContext& context, const VkHourglass::VulkanContext::Frame& frame)
 {
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &context.imageAvailableSemaphore;
+    submitInfo.pWaitSemaphores = &frame.imageAvailableSemaphore;
 
     const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     submitInfo.pWaitDstStageMask = &waitStage;
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &context.commandBuffer;
+    submitInfo.pCommandBuffers = &frame.commandBuffer;
     submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &context.renderingFinishedSemaphore;
+    submitInfo.pSignalSemaphores = &frame.renderingFinishedSemaphore;
 
-    if (vkQueueSubmit(context.deviceWrapper.queue, 1, &submitInfo, context.inFlightFence) != VK_SUCCESS)
+    if (vkQueueSubmit(context.deviceWrapper.queue, 1, &submitInfo, frame.inFlightFence) != VK_SUCCESS)
     {
         fprintf(stderr, "Failed to submit draw command!\n");
     }
 }
 
-VkResult presentFramebuffer(VkHourglass::VulkanContext& context, uint32_t swapchainImageIndex)
+static void submitComputeCommands(const VkHourglass::VulkanContext& context,
+                                  const VkHourglass::VulkanContext::Frame& frame)
+{
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &frame.commandBuffer;
+
+    if (vkQueueSubmit(context.deviceWrapper.queue, 1, &submitInfo, frame.inFlightFence) != VK_SUCCESS)
+    {
+        fprintf(stderr, "Failed to submit compute command!\n");
+    }
+}
+
+VkResult presentFramebuffer(VkHourglass::VulkanContext& context,
+                            const VkHourglass::VulkanContext::Frame& frame,
+                            uint32_t swapchainImageIndex)
 {
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.pNext = nullptr;
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = &context.renderingFinishedSemaphore;
+    presentInfo.pWaitSemaphores = &frame.renderingFinishedSemaphore;
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = &context.swapchain.swapchain;
     presentInfo.pImageIndices = &swapchainImageIndex;
@@ -280,3 +1193,67 @@ VkResult presentFramebuffer(VkHourglass::VulkanContext& context, uint32_t swapch
 
     return vkQueuePresentKHR(context.deviceWrapper.queue, &presentInfo);
 }
+
+static std::optional<VkHourglass::MargolusEngine>
+createCrossCheckEngine(const CommandLineArguments& arguments,
+                       const std::shared_future<VkHourglass::PackedGrid>& gridFuture,
+                       const VkHourglass::Checkpoint::MappedFile* checkpoint,
+                       uint32_t seed)
+{
+    if (!arguments.crossCheck)
+    {
+        return std::nullopt;
+    }
+
+    const VkHourglass::Configuration& configuration = arguments.configuration;
+    if (checkpoint)
+    {
+        VkHourglass::PackedGrid grid(configuration.gridWidth, configuration.gridHeight);
+        std::copy_n(checkpoint->getCells(), checkpoint->getCellWordCount(), grid.getData().begin());
+        return std::make_optional<VkHourglass::MargolusEngine>(configuration.enableHorizontalWrapping,
+                                                               configuration.stuckProbability,
+                                                               grid,
+                                                               checkpoint->getState().currentGridBuffer,
+                                                               seed,
+                                                               checkpoint->getState().generation);
+    }
+
+    return std::make_optional<VkHourglass::MargolusEngine>(
+        configuration.enableHorizontalWrapping, configuration.stuckProbability, gridFuture.get(), 0, seed, 0);
+}
+
+static void printStartupTimings(std::chrono::nanoseconds startupTime,
+                                std::chrono::nanoseconds gridGenerationTime,
+                                const VkHourglass::VulkanContext::StartupTimings& vulkanStartupTimings)
+{
+    const auto toMilliseconds = [](std::chrono::nanoseconds duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+
+    printf("Startup: %.2f ms (grid generation on worker thread %.2f ms)\n",
+           toMilliseconds(startupTime),
+           toMilliseconds(gridGenerationTime));
+    printf("Vulkan startup: %.2f ms (instance %.2f ms, device %.2f ms, buffers %.2f ms with %s upload, "
+           "waiting for grid %.2f ms, waiting for pipelines %.2f ms)\n",
+           toMilliseconds(vulkanStartupTimings.total),
+           toMilliseconds(vulkanStartupTimings.instance),
+           toMilliseconds(vulkanStartupTimings.device),
+           toMilliseconds(vulkanStartupTimings.buffers),
+           vulkanStartupTimings.isZeroCopyUpload ? "zero-copy" : "staging",
+           toMilliseconds(vulkanStartupTimings.gridWait),
+           toMilliseconds(vulkanStartupTimings.pipelineWait));
+    printf("Vulkan startup on worker threads: shader loading %.2f ms, compute pipelines %.2f ms, graphics pipeline "
+           "%.2f ms\n",
+           toMilliseconds(vulkanStartupTimings.shaderLoading),
+           toMilliseconds(vulkanStartupTimings.computePipelines),
+           toMilliseconds(vulkanStartupTimings.graphicsPipeline));
+
+    if (vulkanStartupTimings.loadedPipelineCacheSize > 0)
+    {
+        printf("Pipeline cache: loaded %zu bytes\n", vulkanStartupTimings.loadedPipelineCacheSize);
+    }
+    else
+    {
+        printf("Pipeline cache: none found, pipelines compiled from scratch\n");
+    }
+}
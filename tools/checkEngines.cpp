@@ -0,0 +1,190 @@
+// Compares `SimdMargolusEngine` to the reference implementation `MargolusEngine` on small random grids, for every
+// kernel, several temporal step and thread counts, with and without NUMA bands and horizontal wrapping. Both use the
+// same seed and have to be bit identical after each pass of the optimized engine (see
+// `SimdMargolusEngine::step(size_t)`). Only needs the CPU, see 'make check'.
+//
+// Usage: checkEngines [<generation count>]
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "MargolusEngine.hpp"
+#include "PackedGrid.hpp"
+#include "SimdMargolusEngine.hpp"
+
+// NOTE(MM): Grids are a few words wide and high, so that the word borders and the grid borders are crossed within a
+// few generations. Sand only fills the rows above `sandRowFraction`, so it keeps falling for a while.
+struct GridCase
+{
+    const char* name;
+    uint32_t width;
+    uint32_t height;
+    float sandProbability;
+    float wallProbability;
+    float sandRowFraction;
+};
+
+static constexpr std::array<GridCase, 3> GRID_CASES = {{
+    {"falling", 128, 192, 0.6f, 0.05f, 0.5f},
+    {"dense", 96, 64, 0.5f, 0.1f, 1.0f},
+    {"sparse", 160, 128, 0.2f, 0.02f, 1.0f},
+}};
+
+static constexpr std::array<VkHourglass::SimdMargolusEngine::Kernel, 3> KERNELS = {
+    VkHourglass::SimdMargolusEngine::Kernel::BitSliced,
+    VkHourglass::SimdMargolusEngine::Kernel::Avx2,
+    VkHourglass::SimdMargolusEngine::Kernel::Scalar,
+};
+static constexpr std::array<uint32_t, 4> TEMPORAL_STEPS = {1, 3, 7, 31};
+static constexpr std::array<size_t, 3> THREAD_COUNTS = {1, 3, 8};
+
+static constexpr uint32_t SEED = 0x5eed1234;
+static constexpr float STUCK_PROBABILITY = 0.25f;
+// NOTE(MM): Not a multiple of any temporal step count, so that the remaining single generations are checked as well.
+static constexpr uint64_t DEFAULT_GENERATION_COUNT = 200;
+
+static VkHourglass::PackedGrid generateGrid(const GridCase& gridCase)
+{
+    std::mt19937 generator(SEED);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+    const uint32_t sandRows = static_cast<uint32_t>(gridCase.sandRowFraction * static_cast<float>(gridCase.height));
+    VkHourglass::PackedGrid grid(gridCase.width, gridCase.height);
+    for (uint32_t y = 0; y < gridCase.height; ++y)
+    {
+        for (uint32_t x = 0; x < gridCase.width; ++x)
+        {
+            const float value = distribution(generator);
+            if (value < gridCase.wallProbability)
+            {
+                grid.setCell(x, y, VkHourglass::WALL_VALUE);
+            }
+            else if (y < sandRows && value < gridCase.wallProbability + gridCase.sandProbability)
+            {
+                grid.setCell(x, y, VkHourglass::SAND_VALUE);
+            }
+        }
+    }
+
+    return grid;
+}
+
+static void printGrid(const VkHourglass::PackedGrid& grid)
+{
+    for (uint32_t y = 0; y < grid.getHeight(); ++y)
+    {
+        std::string row(grid.getWidth(), ' ');
+        for (uint32_t x = 0; x < grid.getWidth(); ++x)
+        {
+            const uint32_t cell = grid.getCell(x, y);
+            row[x] = cell == VkHourglass::WALL_VALUE ? '#' : (cell == VkHourglass::SAND_VALUE ? 's' : '.');
+        }
+        fprintf(stderr, "%s\n", row.c_str());
+    }
+}
+
+// Returns the generation the engines first differ in (after a pass of `engine`), or `generationCount` if they don't.
+static uint64_t findMismatch(const VkHourglass::PackedGrid& grid,
+                             bool enableHorizontalWrapping,
+                             VkHourglass::SimdMargolusEngine& engine,
+                             uint64_t generationCount)
+{
+    VkHourglass::MargolusEngine reference(enableHorizontalWrapping, STUCK_PROBABILITY, grid, 0, SEED, 0);
+
+    uint64_t batchSize = 0;
+    for (uint64_t generation = 0; generation < generationCount; generation += batchSize)
+    {
+        batchSize = std::min<uint64_t>(generationCount - generation, engine.getTemporalSteps());
+        engine.step(static_cast<size_t>(batchSize));
+        for (uint64_t i = 0; i < batchSize; ++i)
+        {
+            reference.step();
+        }
+
+        if (reference.getCells() != engine.getCells() || reference.getCurrentBuffer() != engine.getCurrentBuffer())
+        {
+            return generation + batchSize - 1;
+        }
+    }
+
+    return generationCount;
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t generationCount = DEFAULT_GENERATION_COUNT;
+    if (argc > 2 || (argc == 2 && (generationCount = std::strtoull(argv[1], nullptr, 10)) == 0))
+    {
+        fprintf(stderr, "Usage: %s [<generation count>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t runCount = 0;
+    size_t failureCount = 0;
+    for (const GridCase& gridCase : GRID_CASES)
+    {
+        const VkHourglass::PackedGrid grid = generateGrid(gridCase);
+        bool isGridPrinted = false;
+
+        for (const bool enableHorizontalWrapping : {false, true})
+        {
+            for (const VkHourglass::SimdMargolusEngine::Kernel kernel : KERNELS)
+            {
+                for (const uint32_t temporalSteps : TEMPORAL_STEPS)
+                {
+                    for (const size_t threadCount : THREAD_COUNTS)
+                    {
+                        for (const bool numaBands : {false, true})
+                        {
+                            VkHourglass::SimdMargolusEngine engine(enableHorizontalWrapping,
+                                                                   STUCK_PROBABILITY,
+                                                                   grid,
+                                                                   SEED,
+                                                                   threadCount,
+                                                                   kernel,
+                                                                   temporalSteps,
+                                                                   numaBands);
+                            const uint64_t mismatch =
+                                findMismatch(grid, enableHorizontalWrapping, engine, generationCount);
+                            ++runCount;
+                            if (mismatch == generationCount)
+                            {
+                                continue;
+                            }
+
+                            ++failureCount;
+                            fprintf(stderr,
+                                    "Mismatch at generation %llu: %s %ux%u, wrapping %s, %s kernel, %u temporal steps, "
+                                    "%zu threads, NUMA bands %s\n",
+                                    static_cast<unsigned long long>(mismatch),
+                                    gridCase.name,
+                                    gridCase.width,
+                                    gridCase.height,
+                                    enableHorizontalWrapping ? "on" : "off",
+                                    engine.getKernelName(),
+                                    temporalSteps,
+                                    threadCount,
+                                    numaBands ? "on" : "off");
+                            if (!isGridPrinted)
+                            {
+                                printGrid(grid);
+                                isGridPrinted = true;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%zu / %zu engine configurations match the reference over %llu generations\n",
+           runCount - failureCount,
+           runCount,
+           static_cast<unsigned long long>(generationCount));
+    return failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
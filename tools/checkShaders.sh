@@ -0,0 +1,51 @@
+#!/bin/sh
+# Cross check behind 'make check-gpu': runs each variant of the compute shader (set via '--set', see Configuration.hpp)
+# headless on a small grid with '--cross-check', which compares the cell buffers to the CPU reference implementation
+# (see MargolusEngine.hpp) after every submission. Each variant runs with and without horizontal wrapping, on every
+# generator of CHECK_GENERATORS. Fails on the first mismatch.
+#
+# Configured via environment variables, see the check-gpu target of the Makefile.
+
+set -eu
+
+CHECK_EXECUTABLE="${CHECK_EXECUTABLE:-./bin/release/vulkan_hourglass}"
+CHECK_GRID_SIZE="${CHECK_GRID_SIZE:-256}"
+CHECK_GENERATORS="${CHECK_GENERATORS:-hourglass noise}"
+CHECK_STEPS="${CHECK_STEPS:-1155}"
+# Additional arguments for every run, e.g. "--seed 1" to reproduce a failure.
+CHECK_ARGUMENTS="${CHECK_ARGUMENTS:-}"
+
+# NOTE(MM): Tiles two words wide, so that a temporal tile has neighbouring words within it, not only in its halo.
+temporal7Arguments="--set compute_temporal_steps=7 --set compute_local_group_size_x=64 --set compute_tile_width_words=2"
+
+# One variant per line: '<name>|<arguments>'. The step count has to be a multiple of the temporal steps.
+variants="default|
+step-in-place|--set step_in_place=true
+interleave-row-pairs|--set interleave_row_pairs=true
+interleave-row-pairs-shared|--set interleave_row_pairs=true --set compute_shared_memory_tiles=true
+shared-memory-tiles|--set compute_shared_memory_tiles=true --set compute_tile_width_words=4
+shared-memory-tiles-narrow|--set compute_shared_memory_tiles=true --set compute_tile_width_words=1
+temporal-3|--set compute_temporal_steps=3
+temporal-5|--set compute_temporal_steps=5
+temporal-7|$temporal7Arguments
+temporal-3-interleaved|--set compute_temporal_steps=3 --set interleave_row_pairs=true
+temporal-5-interleaved|--set compute_temporal_steps=5 --set interleave_row_pairs=true
+temporal-7-interleaved|$temporal7Arguments --set interleave_row_pairs=true"
+
+echo "$variants" | while IFS='|' read -r name variantArguments; do
+    for wrapping in false true; do
+        for generator in $CHECK_GENERATORS; do
+            echo "Cross checking $name / wrapping $wrapping / $generator" >&2
+            # shellcheck disable=SC2086
+            "$CHECK_EXECUTABLE" $CHECK_ARGUMENTS \
+                --set "grid_width=$CHECK_GRID_SIZE" --set "grid_height=$CHECK_GRID_SIZE" \
+                --set "hourglass.width=$((CHECK_GRID_SIZE * 3 / 4))" \
+                --set "hourglass.height=$((CHECK_GRID_SIZE - 16))" \
+                --set "random_noise.particle_count=$((CHECK_GRID_SIZE * CHECK_GRID_SIZE / 4))" \
+                --set "enable_horizontal_wrapping=$wrapping" $variantArguments \
+                --generator "$generator" --headless "$CHECK_STEPS" --cross-check --report csv >/dev/null
+        done
+    done
+done
+
+echo "All shader variants match the CPU reference implementation" >&2
@@ -0,0 +1,375 @@
+// Build time generator: Turns the transition table of 'shaders/stateTransitions.comp' into minimized boolean
+// expressions (sum of products) for each of the four resulting sand bits, so that many blocks can be updated at once
+// with bitwise operations on bit-sliced planes (one block per bit).
+//
+// Usage: generateStateTransitionLogic <path to stateTransitions.comp> <output header>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static constexpr uint32_t INPUT_BIT_COUNT = 8;
+static constexpr uint32_t STATE_COUNT = 1 << INPUT_BIT_COUNT;
+static constexpr uint32_t OUTPUT_BIT_COUNT = 4;
+
+// NOTE(MM): Same order as the bits in 'stateTransitions.comp'.
+static constexpr std::array<const char*, INPUT_BIT_COUNT> INPUT_NAMES{
+    "sandTL", "sandTR", "sandBL", "sandBR", "wallTL", "wallTR", "wallBL", "wallBR"};
+static constexpr std::array<const char*, OUTPUT_BIT_COUNT> OUTPUT_NAMES{
+    "newSandTL", "newSandTR", "newSandBL", "newSandBR"};
+
+// Product term: Bits set in `careMask` have to match the corresponding bits of `value`, all others are ignored.
+struct Implicant
+{
+    uint32_t value;
+    uint32_t careMask;
+
+    bool covers(uint32_t state) const { return (state & careMask) == value; }
+    bool operator==(const Implicant& other) const { return value == other.value && careMask == other.careMask; }
+};
+
+static std::optional<std::array<uint32_t, STATE_COUNT>> parseTransitionTable(const std::string& source)
+{
+    const std::string tableStart = "stateTransition[256] = uint[](";
+    const size_t start = source.find(tableStart);
+    if (start == std::string::npos)
+    {
+        fprintf(stderr, "Failed to find '%s'!\n", tableStart.c_str());
+        return std::nullopt;
+    }
+
+    const size_t end = source.find(");", start);
+    if (end == std::string::npos)
+    {
+        fprintf(stderr, "Failed to find end of transition table!\n");
+        return std::nullopt;
+    }
+
+    // NOTE(MM): Strip comments (they contain digits, e.g. "NOTE(MM)"), then every remaining number is an entry.
+    std::istringstream body(source.substr(start + tableStart.size(), end - start - tableStart.size()));
+    std::array<uint32_t, STATE_COUNT> table{};
+    size_t entryCount = 0;
+
+    std::string line;
+    while (std::getline(body, line))
+    {
+        line = line.substr(0, line.find("//"));
+        std::replace(line.begin(), line.end(), ',', ' ');
+
+        std::istringstream entries(line);
+        uint32_t entry = 0;
+        while (entries >> entry)
+        {
+            if (entryCount >= STATE_COUNT || entry >= (1 << OUTPUT_BIT_COUNT))
+            {
+                fprintf(stderr, "Invalid transition table entry %zu!\n", entryCount);
+                return std::nullopt;
+            }
+            table[entryCount++] = entry;
+        }
+    }
+
+    if (entryCount != STATE_COUNT)
+    {
+        fprintf(stderr, "Expected %u transition table entries, found %zu!\n", STATE_COUNT, entryCount);
+        return std::nullopt;
+    }
+
+    return table;
+}
+
+// States in which a cell is sand and wall at the same time never occur (see 'stateTransitions.comp'), hence their
+// result doesn't matter and they can be used for minimization.
+static bool isDontCare(uint32_t state)
+{
+    return ((state & 0xf) & (state >> 4)) != 0;
+}
+
+// Quine-McCluskey: Repeatedly merge implicants differing in a single cared-for bit until no more merges are possible.
+static std::vector<Implicant> findPrimeImplicants(const std::vector<uint32_t>& onOrDontCareStates)
+{
+    std::vector<Implicant> current;
+    for (const uint32_t state : onOrDontCareStates)
+    {
+        current.push_back({state, STATE_COUNT - 1});
+    }
+
+    std::vector<Implicant> primes;
+    while (!current.empty())
+    {
+        std::vector<Implicant> merged;
+        std::vector<bool> wasMerged(current.size(), false);
+
+        for (size_t i = 0; i < current.size(); ++i)
+        {
+            for (size_t j = i + 1; j < current.size(); ++j)
+            {
+                if (current[i].careMask != current[j].careMask)
+                {
+                    continue;
+                }
+
+                const uint32_t difference = current[i].value ^ current[j].value;
+                if (difference == 0 || (difference & (difference - 1)) != 0)
+                {
+                    continue;
+                }
+
+                const Implicant combined{current[i].value & ~difference, current[i].careMask & ~difference};
+                if (std::find(merged.cbegin(), merged.cend(), combined) == merged.cend())
+                {
+                    merged.push_back(combined);
+                }
+                wasMerged[i] = true;
+                wasMerged[j] = true;
+            }
+        }
+
+        for (size_t i = 0; i < current.size(); ++i)
+        {
+            if (!wasMerged[i] && std::find(primes.cbegin(), primes.cend(), current[i]) == primes.cend())
+            {
+                primes.push_back(current[i]);
+            }
+        }
+
+        current = std::move(merged);
+    }
+
+    return primes;
+}
+
+static uint32_t countCared(const Implicant& implicant)
+{
+    return static_cast<uint32_t>(__builtin_popcount(implicant.careMask));
+}
+
+// Cover all on-states with prime implicants: Essential ones first, then greedily the one covering most remaining
+// states (fewest literals on ties). Not guaranteed to be minimal, but close enough for a table of this size.
+static std::vector<Implicant> selectCover(const std::vector<Implicant>& primes, const std::vector<uint32_t>& onStates)
+{
+    std::vector<uint32_t> remaining = onStates;
+    std::vector<Implicant> cover;
+
+    const auto take = [&](const Implicant& implicant) {
+        cover.push_back(implicant);
+        const auto isCovered = [&](uint32_t state) {
+            return implicant.covers(state);
+        };
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), isCovered), remaining.end());
+    };
+
+    for (const uint32_t state : onStates)
+    {
+        std::optional<Implicant> onlyCover = std::nullopt;
+        size_t coverCount = 0;
+        for (const auto& prime : primes)
+        {
+            if (prime.covers(state))
+            {
+                onlyCover = prime;
+                ++coverCount;
+            }
+        }
+
+        const bool isStillUncovered = std::find(remaining.cbegin(), remaining.cend(), state) != remaining.cend();
+        if (coverCount == 1 && isStillUncovered)
+        {
+            take(onlyCover.value());
+        }
+    }
+
+    while (!remaining.empty())
+    {
+        const Implicant* best = nullptr;
+        size_t bestCount = 0;
+        for (const auto& prime : primes)
+        {
+            const auto isCovered = [&](uint32_t state) {
+                return prime.covers(state);
+            };
+            const auto count = static_cast<size_t>(std::count_if(remaining.cbegin(), remaining.cend(), isCovered));
+            if (count > bestCount || (count == bestCount && best && countCared(prime) < countCared(*best)))
+            {
+                best = &prime;
+                bestCount = count;
+            }
+        }
+        take(*best);
+    }
+
+    std::sort(cover.begin(), cover.end(), [](const Implicant& a, const Implicant& b) {
+        return countCared(a) != countCared(b) ? countCared(a) < countCared(b) : a.value < b.value;
+    });
+    return cover;
+}
+
+static std::string toExpression(const std::vector<Implicant>& cover)
+{
+    if (cover.empty())
+    {
+        return "T(0)";
+    }
+
+    std::string expression;
+    for (const auto& implicant : cover)
+    {
+        if (!expression.empty())
+        {
+            expression += "\n        | ";
+        }
+
+        std::string term;
+        for (uint32_t bit = 0; bit < INPUT_BIT_COUNT; ++bit)
+        {
+            if (!(implicant.careMask & (1 << bit)))
+            {
+                continue;
+            }
+            term += term.empty() ? "" : " & ";
+            term += (implicant.value & (1 << bit)) ? "" : "~";
+            term += INPUT_NAMES[bit];
+        }
+        expression += term.empty() ? "~T(0)" : "(" + term + ")";
+    }
+
+    return expression;
+}
+
+static bool verifyCover(const std::vector<Implicant>& cover,
+                        const std::array<uint32_t, STATE_COUNT>& table,
+                        uint32_t bit)
+{
+    for (uint32_t state = 0; state < STATE_COUNT; ++state)
+    {
+        if (isDontCare(state))
+        {
+            continue;
+        }
+
+        const bool expected = (table[state] >> bit) & 1;
+        const bool actual = std::any_of(cover.cbegin(), cover.cend(), [&](const Implicant& implicant) {
+            return implicant.covers(state);
+        });
+        if (expected != actual)
+        {
+            fprintf(stderr, "Generated logic for bit %u is wrong for state %u!\n", bit, state);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <path to stateTransitions.comp> <output header>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream input(argv[1]);
+    if (!input)
+    {
+        fprintf(stderr, "Failed to open '%s'!\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    std::stringstream source;
+    source << input.rdbuf();
+
+    const auto tableOpt = parseTransitionTable(source.str());
+    if (!tableOpt.has_value())
+    {
+        return EXIT_FAILURE;
+    }
+    const auto& table = tableOpt.value();
+
+    std::ostringstream header;
+    header << "// Generated by 'tools/generateStateTransitionLogic.cpp' from 'shaders/stateTransitions.comp'.\n"
+              "// Do not edit.\n"
+              "\n"
+              "#ifndef VULKANHOURGLASS_STATETRANSITIONLOGIC_HPP\n"
+              "#define VULKANHOURGLASS_STATETRANSITIONLOGIC_HPP\n"
+              "\n"
+              "#include <array>\n"
+              "#include <cstdint>\n"
+              "\n"
+              "namespace VkHourglass::StateTransitionLogic\n"
+              "{\n"
+              "\n"
+              "// Transition table the logic below was generated from.\n"
+              "constexpr std::array<uint32_t, 256> STATE_TRANSITION{\n";
+    for (uint32_t i = 0; i < STATE_COUNT; i += 16)
+    {
+        header << "    ";
+        for (uint32_t j = i; j < i + 16; ++j)
+        {
+            header << table[j] << (j + 1 < STATE_COUNT ? (j + 1 < i + 16 ? ", " : ",") : "");
+        }
+        header << "\n";
+    }
+    header << "};\n"
+              "\n"
+              "// Evaluates the transition table for all bit positions at once, i.e. bit n of each argument belongs\n"
+              "// to block n. Results for blocks with a cell being sand and wall at the same time are undefined.\n"
+              "template <typename T>\n"
+              "constexpr void transition(";
+    for (const char* name : INPUT_NAMES)
+    {
+        header << "T " << name << ",\n                          ";
+    }
+    for (uint32_t i = 0; i < OUTPUT_BIT_COUNT; ++i)
+    {
+        header << "T& " << OUTPUT_NAMES[i] << (i + 1 < OUTPUT_BIT_COUNT ? ",\n                          " : ")\n{\n");
+    }
+
+    for (uint32_t bit = 0; bit < OUTPUT_BIT_COUNT; ++bit)
+    {
+        std::vector<uint32_t> onStates;
+        std::vector<uint32_t> onOrDontCareStates;
+        for (uint32_t state = 0; state < STATE_COUNT; ++state)
+        {
+            const bool isOn = !isDontCare(state) && ((table[state] >> bit) & 1);
+            if (isOn)
+            {
+                onStates.push_back(state);
+            }
+            if (isOn || isDontCare(state))
+            {
+                onOrDontCareStates.push_back(state);
+            }
+        }
+
+        const auto cover = selectCover(findPrimeImplicants(onOrDontCareStates), onStates);
+        if (!verifyCover(cover, table, bit))
+        {
+            return EXIT_FAILURE;
+        }
+
+        header << "    " << OUTPUT_NAMES[bit] << " = " << toExpression(cover) << ";\n";
+    }
+
+    header << "}\n"
+              "\n"
+              "} // namespace VkHourglass::StateTransitionLogic\n"
+              "\n"
+              "#endif // VULKANHOURGLASS_STATETRANSITIONLOGIC_HPP\n";
+
+    std::ofstream output(argv[2]);
+    output << header.str();
+    if (!output)
+    {
+        fprintf(stderr, "Failed to write '%s'!\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+#!/bin/sh
+# Benchmark sweep behind 'make bench': runs every generator on every engine headless for each grid size, compute
+# local group size and tile width (set via '--set', see Configuration.hpp). The 'gpu-shared' engine is the compute
+# shader with shared memory tiles, 'gpu-temporal' the one computing BENCH_TEMPORAL_STEPS generations per dispatch
+# (temporal blocking, its step count is rounded down to a multiple of them). Other engines are CPU kernels, with the
+# suffix '-temporal' computing BENCH_TEMPORAL_STEPS generations per pass over the grid and '-numa' (after '-temporal',
+# if both) using pinned threads with a band of the grid each. The results of all runs are merged into a single CSV
+# file or JSON Lines file (one object per run).
+#
+# Configured via environment variables, see the bench target of the Makefile.
+
+set -eu
+
+BENCH_EXECUTABLE="${BENCH_EXECUTABLE:-./bin/release/vulkan_hourglass}"
+BENCH_GRID_SIZES="${BENCH_GRID_SIZES:-1024 2048 4096}"
+BENCH_LOCAL_GROUP_SIZES="${BENCH_LOCAL_GROUP_SIZES:-32 64 128 256}"
+BENCH_GENERATORS="${BENCH_GENERATORS:-hourglass noise circles center}"
+BENCH_TILE_WIDTHS="${BENCH_TILE_WIDTHS:-1 16}"
+BENCH_ENGINES="${BENCH_ENGINES:-gpu gpu-shared gpu-temporal bit-sliced bit-sliced-temporal bit-sliced-numa avx2 scalar}"
+BENCH_TEMPORAL_STEPS="${BENCH_TEMPORAL_STEPS:-3}"
+BENCH_STEPS="${BENCH_STEPS:-4096}"
+BENCH_FORMAT="${BENCH_FORMAT:-csv}"
+BENCH_DIR="${BENCH_DIR:-./bin/bench}"
+# Additional arguments for every run, e.g. "--config bench.conf".
+BENCH_ARGUMENTS="${BENCH_ARGUMENTS:-}"
+
+# Exit code of the executable for settings it rejects, see main.cpp.
+EXIT_INVALID_CONFIGURATION=2
+
+case "$BENCH_FORMAT" in
+csv) output="$BENCH_DIR/results.csv" ;;
+json) output="$BENCH_DIR/results.json" ;;
+*)
+    echo "Unknown BENCH_FORMAT '$BENCH_FORMAT', expected 'csv' or 'json'!" >&2
+    exit 1
+    ;;
+esac
+
+mkdir -p "$BENCH_DIR"
+: >"$output"
+hasCsvHeader=false
+
+for gridSize in $BENCH_GRID_SIZES; do
+    isFirstGroupSize=true
+    for localGroupSize in $BENCH_LOCAL_GROUP_SIZES; do
+        for engine in $BENCH_ENGINES; do
+            steps="$BENCH_STEPS"
+            case "$engine" in
+            gpu)
+                engineArguments="--set compute_shared_memory_tiles=false"
+                tileWidths="$BENCH_TILE_WIDTHS"
+                ;;
+            gpu-shared)
+                engineArguments="--set compute_shared_memory_tiles=true"
+                tileWidths="$BENCH_TILE_WIDTHS"
+                ;;
+            gpu-temporal)
+                engineArguments="--set compute_shared_memory_tiles=false"
+                engineArguments="$engineArguments --set compute_temporal_steps=$BENCH_TEMPORAL_STEPS"
+                tileWidths="$BENCH_TILE_WIDTHS"
+                steps=$((BENCH_STEPS / BENCH_TEMPORAL_STEPS * BENCH_TEMPORAL_STEPS))
+                ;;
+            *)
+                # The local group size and tile width don't affect the CPU engines, run them once per grid size.
+                if [ "$isFirstGroupSize" = false ]; then
+                    continue
+                fi
+                kernel="${engine%-numa}"
+                engineArguments="--cpu --kernel ${kernel%-temporal}"
+                if [ "$kernel" != "${kernel%-temporal}" ]; then
+                    engineArguments="$engineArguments --set cpu_temporal_steps=$BENCH_TEMPORAL_STEPS"
+                fi
+                if [ "$engine" != "$kernel" ]; then
+                    engineArguments="$engineArguments --set cpu_numa_bands=true"
+                fi
+                tileWidths=1
+                ;;
+            esac
+
+            for tileWidth in $tileWidths; do
+                for generator in $BENCH_GENERATORS; do
+                    echo "Benchmarking ${gridSize}x${gridSize} / group size $localGroupSize / tile width $tileWidth:" \
+                        "$engine / $generator" >&2
+                    # Combinations violating the configuration rules (e.g. temporal tiles exceeding shared memory, see
+                    # 'validateConfiguration()') exit with EXIT_INVALID_CONFIGURATION and are skipped.
+                    status=0
+                    # shellcheck disable=SC2086
+                    result=$("$BENCH_EXECUTABLE" $BENCH_ARGUMENTS \
+                        --set "grid_width=$gridSize" --set "grid_height=$gridSize" \
+                        --set "compute_local_group_size_x=$localGroupSize" --set "compute_tile_width_words=$tileWidth" \
+                        --generator "$generator" --headless "$steps" $engineArguments --report "$BENCH_FORMAT") \
+                        || status=$?
+                    if [ "$status" -eq "$EXIT_INVALID_CONFIGURATION" ]; then
+                        echo "Skipped, not a valid configuration" >&2
+                        # The configuration doesn't depend on the generator.
+                        break
+                    elif [ "$status" -ne 0 ]; then
+                        exit "$status"
+                    fi
+
+                    if [ "$BENCH_FORMAT" = csv ] && [ "$hasCsvHeader" = true ]; then
+                        result=$(echo "$result" | tail -n +2)
+                    fi
+                    hasCsvHeader=true
+                    echo "$result" | tee -a "$output"
+                done
+            done
+        done
+        isFirstGroupSize=false
+    done
+done
+
+echo "Results written to $output" >&2